@@ -1,6 +1,6 @@
-packages:=boost openssl libevent
+packages:=boost openssl libevent zlib
 
-qt_packages = zlib
+qt_packages =
 
 qrencode_packages = qrencode
 
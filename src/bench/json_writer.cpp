@@ -0,0 +1,91 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+
+#include "pocketdb/helpers/JsonWriter.h"
+
+#include <string>
+
+// Content rows as GetContentsData reads them: plain columns and stored JSON of tags, images and settings
+static const int CONTENTS_COUNT = 1000;
+static const std::string TAGS = "[\"pocketnet\",\"bastyon\",\"crypto\",\"news\"]";
+static const std::string IMAGES = "[\"https://bastyon.com/images/0001.jpg\",\"https://bastyon.com/images/0002.jpg\"]";
+static const std::string SETTINGS = "{\"v\":\"1\",\"a\":\"\",\"f\":\"0\"}";
+static const std::string MESSAGE(1500, 'm');
+
+static void JsonContentsUniValue(benchmark::Bench& bench)
+{
+    bench.run([&] {
+        UniValue result(UniValue::VARR);
+        for (int i = 0; i < CONTENTS_COUNT; i++)
+        {
+            UniValue record(UniValue::VOBJ);
+            record.pushKV("txid", "7d2d9d9d4c2f1b1e2b4b4c0e8e0b3f9a9c7e5c3b1a0f8e6d4c2b0a9f8e7d6c5" + std::to_string(i));
+            record.pushKV("id", i);
+            record.pushKV("address", "PR7srzZt4EfcNb3s27grgmiG8aB9vYNV82");
+            record.pushKV("time", "1650000000");
+            record.pushKV("l", "en");
+            record.pushKV("c", "Caption");
+            record.pushKV("m", MESSAGE);
+            record.pushKV("type", "share");
+
+            UniValue t(UniValue::VARR);
+            t.read(TAGS);
+            record.pushKV("t", t);
+
+            UniValue ii(UniValue::VARR);
+            ii.read(IMAGES);
+            record.pushKV("i", ii);
+
+            UniValue s(UniValue::VOBJ);
+            s.read(SETTINGS);
+            record.pushKV("s", s);
+
+            record.pushKV("scoreCnt", "10");
+            record.pushKV("scoreSum", "45");
+            record.pushKV("comments", 3);
+
+            result.push_back(record);
+        }
+
+        auto reply = result.write();
+        ankerl::nanobench::doNotOptimizeAway(reply);
+    });
+}
+
+static void JsonContentsWriter(benchmark::Bench& bench)
+{
+    bench.run([&] {
+        UniValue result(UniValue::VARR);
+        for (int i = 0; i < CONTENTS_COUNT; i++)
+        {
+            PocketHelpers::JsonWriter record(2048);
+            record.BeginObject();
+            record.Key("txid").String("7d2d9d9d4c2f1b1e2b4b4c0e8e0b3f9a9c7e5c3b1a0f8e6d4c2b0a9f8e7d6c5" + std::to_string(i));
+            record.Key("id").Int(i);
+            record.Key("address").String("PR7srzZt4EfcNb3s27grgmiG8aB9vYNV82");
+            record.Key("time").String("1650000000");
+            record.Key("l").String("en");
+            record.Key("c").String("Caption");
+            record.Key("m").String(MESSAGE);
+            record.Key("type").String("share");
+            record.Key("t").Json(TAGS);
+            record.Key("i").Json(IMAGES);
+            record.Key("s").Json(SETTINGS);
+            record.Key("scoreCnt").String("10");
+            record.Key("scoreSum").String("45");
+            record.Key("comments").Int(3);
+            record.EndObject();
+
+            result.push_back(record.ToUniValue());
+        }
+
+        auto reply = result.write();
+        ankerl::nanobench::doNotOptimizeAway(reply);
+    });
+}
+
+BENCHMARK(JsonContentsUniValue);
+BENCHMARK(JsonContentsWriter);
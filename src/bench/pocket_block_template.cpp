@@ -0,0 +1,86 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <random.h>
+
+#include "pocketdb/consensus/BlockTemplate.h"
+#include "pocketdb/models/dto/action/ScoreContent.h"
+#include "pocketdb/models/dto/content/Comment.h"
+#include "pocketdb/models/dto/content/Post.h"
+
+#include <vector>
+
+using PocketHelpers::PTransactionRef;
+using PocketHelpers::PocketBlock;
+
+// Social mempool: posts, comments and scores of a few hundred accounts
+static std::vector<PTransactionRef> SocialMempool(int count)
+{
+    FastRandomContext det_rand{true};
+
+    std::vector<std::string> addresses;
+    for (int i = 0; i < 500; i++)
+        addresses.push_back("PAddress" + std::to_string(i));
+
+    std::vector<std::string> contents;
+    std::vector<PTransactionRef> txs;
+    for (int i = 0; i < count; i++)
+    {
+        PTransactionRef ptx;
+        auto kind = det_rand.randrange(3);
+        if (kind == 0 || contents.empty())
+        {
+            ptx = std::make_shared<PocketTx::Post>();
+            ptx->SetType(PocketTx::CONTENT_POST);
+            ptx->SetString2("root" + std::to_string(i));
+            contents.push_back("root" + std::to_string(i));
+        }
+        else if (kind == 1)
+        {
+            ptx = std::make_shared<PocketTx::Comment>();
+            ptx->SetType(PocketTx::CONTENT_COMMENT);
+            ptx->SetString2("comment" + std::to_string(i));
+            ptx->SetString3(contents[det_rand.randrange(contents.size())]);
+        }
+        else
+        {
+            ptx = std::make_shared<PocketTx::ScoreContent>();
+            ptx->SetType(PocketTx::ACTION_SCORE_CONTENT);
+            ptx->SetString2(contents[det_rand.randrange(contents.size())]);
+        }
+
+        ptx->SetHash("tx" + std::to_string(i));
+        ptx->SetString1(addresses[det_rand.randrange(addresses.size())]);
+        txs.push_back(ptx);
+    }
+
+    return txs;
+}
+
+// Template assembly with append/rollback per package and related transactions for every candidate
+static void PocketBlockTemplateAssemble(benchmark::Bench& bench)
+{
+    auto txs = SocialMempool(5000);
+
+    bench.run([&] {
+        PocketConsensus::BlockTemplateContext context(std::make_shared<PocketBlock>());
+
+        for (size_t i = 0; i < txs.size(); i += 2)
+        {
+            size_t size = context.Size();
+            for (size_t j = i; j < std::min(i + 2, txs.size()); j++)
+            {
+                auto related = context.Related(txs[j]);
+                context.Append(txs[j]);
+            }
+
+            // Every tenth package fails on its last transaction
+            if (i % 20 == 0)
+                context.Rollback(size);
+        }
+    });
+}
+
+BENCHMARK(PocketBlockTemplateAssemble);
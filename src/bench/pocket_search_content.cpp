@@ -0,0 +1,105 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <test/util/setup_common.h>
+
+#include "pocketdb/pocketnet.h"
+#include "pocketdb/repositories/web/WebRepository.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using PocketDb::SQLiteDatabase;
+using PocketDb::WebRepository;
+using PocketDbWeb::WebContent;
+
+// Blocks between scheduled merges of web post processor
+static const int BLOCKS_COUNT = 100;
+static const int CONTENTS_PER_BLOCK = 20;
+static const int MERGE_PAGES = 1000;
+
+static const std::vector<std::string> WORDS = {
+    "pocketnet", "bastyon", "crypto", "freedom", "speech", "network", "block", "chain",
+    "video", "music", "news", "science", "history", "travel", "photo", "story",
+};
+
+// Caption and message of post with words varying by content id - index gets many distinct terms
+static std::vector<WebContent> MakeBlock(int64_t& nextId)
+{
+    std::vector<WebContent> contents;
+    for (int i = 0; i < CONTENTS_PER_BLOCK; i++)
+    {
+        int64_t id = nextId++;
+
+        std::string caption = WORDS[id % WORDS.size()] + " " + WORDS[(id / 7) % WORDS.size()] + " " + std::to_string(id);
+        std::string message;
+        for (int w = 0; w < 60; w++)
+            message += WORDS[(id * 31 + w * 17) % WORDS.size()] + std::to_string((id + w) % 500) + " ";
+
+        contents.emplace_back(id, PocketTx::ContentFieldType_ContentPostCaption, caption);
+        contents.emplace_back(id, PocketTx::ContentFieldType_ContentPostMessage, message);
+    }
+
+    return contents;
+}
+
+// Web db connection as opened by web post processor stages
+static std::shared_ptr<SQLiteDatabase> OpenWebDb()
+{
+    auto db = std::make_shared<SQLiteDatabase>(false);
+    db->Init((GetDataDir() / "pocketdb").string(), "main");
+    db->AttachDatabase("web");
+    return db;
+}
+
+static void CloseWebDb(const std::shared_ptr<SQLiteDatabase>& db, WebRepository& repo)
+{
+    repo.Destroy();
+    db->DetachDatabase("web");
+    db->Close();
+}
+
+// Scheduled cycle of web post processor: blocks of new contents upserted one by one, then incremental merge
+static void PocketSearchContentMerge(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto db = OpenWebDb();
+    WebRepository repo(*db);
+    repo.ConfigureContentIndex();
+
+    int64_t nextId = 1;
+    bench.batch(BLOCKS_COUNT * CONTENTS_PER_BLOCK).unit("content").run([&] {
+        for (int b = 0; b < BLOCKS_COUNT; b++)
+            repo.UpsertContent(MakeBlock(nextId));
+
+        repo.MergeContentIndex(MERGE_PAGES);
+    });
+
+    CloseWebDb(db, repo);
+}
+
+// Web rebuild of -reindex=5: contents of every block upserted, whole index optimized at the end
+static void PocketSearchContentReindex(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto db = OpenWebDb();
+    WebRepository repo(*db);
+    repo.ConfigureContentIndex();
+
+    bench.batch(BLOCKS_COUNT * CONTENTS_PER_BLOCK).unit("content").run([&] {
+        // Same contents every run - rows of previous run are replaced as for reindexed chain
+        int64_t nextId = 1;
+        for (int b = 0; b < BLOCKS_COUNT; b++)
+            repo.UpsertContent(MakeBlock(nextId));
+
+        repo.OptimizeContentIndex();
+    });
+
+    CloseWebDb(db, repo);
+}
+
+BENCHMARK(PocketSearchContentMerge);
+BENCHMARK(PocketSearchContentReindex);
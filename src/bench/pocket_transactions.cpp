@@ -0,0 +1,119 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <test/util/setup_common.h>
+
+#include "pocketdb/pocketnet.h"
+#include "pocketdb/models/dto/content/Post.h"
+#include "pocketdb/models/dto/money/Default.h"
+
+#include <cassert>
+#include <vector>
+
+using PocketHelpers::PTransactionRef;
+using PocketHelpers::PocketBlock;
+
+static const int TRANSACTIONS_COUNT = 1000;
+static const std::string MESSAGE(1500, 'm');
+
+// Posts with full payload, two inputs and three outputs - the shape explorer and GetBlock read back
+static std::vector<std::string> FillTransactions(int count)
+{
+    PocketBlock block;
+    std::vector<std::string> hashes;
+    for (int i = 0; i < count; i++)
+    {
+        auto hash = "tx" + std::to_string(i);
+
+        PTransactionRef ptx = std::make_shared<PocketTx::Post>();
+        ptx->SetType(PocketTx::CONTENT_POST);
+        ptx->SetHash(hash);
+        ptx->SetTime(1650000000 + i);
+        ptx->SetString1("PR7srzZt4EfcNb3s27grgmiG8aB9vYNV82");
+        ptx->SetString2(hash);
+
+        ptx->GeneratePayload();
+        ptx->GetPayload()->SetTxHash(hash);
+        ptx->GetPayload()->SetString1("en");
+        ptx->GetPayload()->SetString2(MESSAGE);
+        ptx->GetPayload()->SetString3("Caption");
+        ptx->GetPayload()->SetString4("[\"pocketnet\",\"bastyon\",\"crypto\"]");
+        ptx->GetPayload()->SetString5("[\"https://bastyon.com/images/0001.jpg\"]");
+
+        // Inputs are read joined with spent outputs, so spent transactions are stored with their outputs
+        auto spentHash = "spent" + std::to_string(i);
+        PTransactionRef spent = std::make_shared<PocketTx::Default>();
+        spent->SetHash(spentHash);
+        spent->SetTime(1650000000 + i);
+
+        for (int n = 0; n < 2; n++)
+        {
+            PocketTx::TransactionInput input;
+            input.SetSpentTxHash(hash);
+            input.SetTxHash(spentHash);
+            input.SetNumber(n);
+            ptx->Inputs().push_back(input);
+
+            PocketTx::TransactionOutput output;
+            output.SetTxHash(spentHash);
+            output.SetNumber(n);
+            output.SetAddressHash("PR7srzZt4EfcNb3s27grgmiG8aB9vYNV82");
+            output.SetValue(150000000);
+            output.SetScriptPubKey("76a914a0b1c2d3e4f5a6b7c8d9e0f1a2b3c4d5e6f7a8b988ac");
+            spent->Outputs().push_back(output);
+        }
+
+        for (int n = 0; n < 3; n++)
+        {
+            PocketTx::TransactionOutput output;
+            output.SetTxHash(hash);
+            output.SetNumber(n);
+            output.SetAddressHash("PR7srzZt4EfcNb3s27grgmiG8aB9vYNV82");
+            output.SetValue(100000000);
+            output.SetScriptPubKey("76a914a0b1c2d3e4f5a6b7c8d9e0f1a2b3c4d5e6f7a8b988ac");
+            ptx->Outputs().push_back(output);
+        }
+
+        block.push_back(spent);
+        block.push_back(ptx);
+        hashes.push_back(hash);
+    }
+
+    PocketDb::TransRepoInst.InsertTransactions(block);
+    return hashes;
+}
+
+// Transactions with payload: one model and payload reconstructed per row
+static void PocketTransactionsListPayload(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto hashes = FillTransactions(TRANSACTIONS_COUNT);
+
+    bench.run([&] {
+        auto txs = PocketDb::TransRepoInst.List(hashes, true);
+        ankerl::nanobench::doNotOptimizeAway(txs);
+    });
+}
+
+// Full transactions: header, payload, inputs and outputs read by separate typed queries
+static void PocketTransactionsListFull(benchmark::Bench& bench)
+{
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {"-nodebuglogfile", "-nodebug"}};
+    auto hashes = FillTransactions(TRANSACTIONS_COUNT);
+
+    // Every transaction is reconstructed with all inputs and outputs
+    auto check = PocketDb::TransRepoInst.List(hashes, true, true, true);
+    assert(check && check->size() == hashes.size());
+    for (const auto& ptx : *check)
+        assert(ptx->Inputs().size() == 2 && ptx->Outputs().size() == 3);
+
+    bench.run([&] {
+        auto txs = PocketDb::TransRepoInst.List(hashes, true, true, true);
+        ankerl::nanobench::doNotOptimizeAway(txs);
+    });
+}
+
+BENCHMARK(PocketTransactionsListPayload);
+BENCHMARK(PocketTransactionsListFull);
@@ -0,0 +1,156 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+
+#include <httprpc.h>
+#include <httpserver.h>
+#include <rpc/protocol.h>
+#include <rpc/server.h>
+#include <support/events.h>
+#include <test/util/setup_common.h>
+#include <util/ref.h>
+
+#include <univalue.h>
+
+#include <event2/buffer.h>
+#include <event2/keyvalq_struct.h>
+
+#include <cassert>
+#include <string>
+
+// Typical page load of web client: batch of independent lookups
+static const int BATCH_SIZE = 16;
+// Public port of bench server, out of ports used by regtest node
+static const int BENCH_PUBLIC_PORT = 39187;
+static const int BENCH_PRIVATE_PORT = 39188;
+
+struct BenchHTTPReply
+{
+    struct event_base* base = nullptr;
+    int status = 0;
+    std::string body;
+};
+
+static void BenchRequestDone(struct evhttp_request* req, void* ctx)
+{
+    auto reply = static_cast<BenchHTTPReply*>(ctx);
+    // Keep-alive connection holds event loop - break it after every reply
+    event_base_loopbreak(reply->base);
+
+    // Null request - connection failed, status stays zero
+    if (!req)
+        return;
+
+    reply->status = evhttp_request_get_response_code(req);
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (size_t size = evbuffer_get_length(buf); size > 0)
+    {
+        reply->body.assign((const char*) evbuffer_pullup(buf, size), size);
+        evbuffer_drain(buf, size);
+    }
+}
+
+static BenchHTTPReply BenchPost(struct event_base* base, struct evhttp_connection* evcon, const std::string& body)
+{
+    BenchHTTPReply reply;
+    reply.base = base;
+
+    raii_evhttp_request req = obtain_evhttp_request(BenchRequestDone, (void*) &reply);
+    assert(req);
+
+    struct evkeyvalq* headers = evhttp_request_get_output_headers(req.get());
+    evhttp_add_header(headers, "Host", "127.0.0.1");
+    evhttp_add_header(headers, "Content-Type", "application/json");
+    evbuffer_add(evhttp_request_get_output_buffer(req.get()), body.data(), body.size());
+
+    // Connection owns request from now on
+    int r = evhttp_make_request(evcon, req.release(), EVHTTP_REQ_POST, "/");
+    assert(r == 0);
+
+    event_base_dispatch(base);
+    return reply;
+}
+
+// Batch of address lookups - method is not cached, so every element reaches sqlite
+static std::string MakeBatch()
+{
+    UniValue batch(UniValue::VARR);
+    for (int i = 0; i < BATCH_SIZE; i++)
+    {
+        UniValue params(UniValue::VARR);
+        params.push_back("PR7srzZt4EfcNb3s27grgmiG8aB9vYNV8" + std::to_string(i));
+
+        UniValue request(UniValue::VOBJ);
+        request.pushKV("method", "getaddressid");
+        request.pushKV("params", params);
+        request.pushKV("id", i);
+        batch.push_back(request);
+    }
+
+    return batch.write();
+}
+
+// Batch requests of single client sent through public port and served by worker pool.
+// Pool of one worker has no idle workers to help, so batch elements are executed one by one
+static void RpcBatch(benchmark::Bench& bench, int poolThreads)
+{
+    const std::string poolArg = "-rpcpoolthreads=" + std::to_string(poolThreads);
+    const std::string publicPortArg = "-publicrpcport=" + std::to_string(BENCH_PUBLIC_PORT);
+    const std::string privatePortArg = "-rpcport=" + std::to_string(BENCH_PRIVATE_PORT);
+    TestingSetup test_setup{CBaseChainParams::REGTEST, {
+        "-nodebuglogfile",
+        "-nodebug",
+        "-api=1",
+        poolArg.c_str(),
+        publicPortArg.c_str(),
+        privatePortArg.c_str(),
+    }};
+
+    if (RPCIsInWarmup(nullptr))
+        SetRPCWarmupFinished();
+
+    util::Ref context{test_setup.m_node};
+    bool started = StartHTTPRPC(context);
+    assert(started);
+    StartHTTPServer();
+
+    const std::string body = MakeBatch();
+    {
+        raii_event_base base = obtain_event_base();
+        raii_evhttp_connection evcon = obtain_evhttp_connection_base(base.get(), "127.0.0.1", BENCH_PUBLIC_PORT);
+
+        // Every element of batch has own reply
+        auto check = BenchPost(base.get(), evcon.get(), body);
+        assert(check.status == HTTP_OK);
+        UniValue replies;
+        bool parsed = replies.read(check.body);
+        assert(parsed && replies.isArray() && replies.size() == (size_t) BATCH_SIZE);
+
+        bench.unit("request").run([&] {
+            auto reply = BenchPost(base.get(), evcon.get(), body);
+            assert(reply.status == HTTP_OK);
+            ankerl::nanobench::doNotOptimizeAway(reply);
+        });
+    }
+
+    // Event loop of server exits only after client connection is closed
+    InterruptHTTPRPC();
+    InterruptHTTPServer();
+    StopHTTPRPC();
+    StopHTTPServer();
+}
+
+static void RpcBatchSequential(benchmark::Bench& bench)
+{
+    RpcBatch(bench, 1);
+}
+
+static void RpcBatchParallel(benchmark::Bench& bench)
+{
+    RpcBatch(bench, 4);
+}
+
+BENCHMARK(RpcBatchSequential);
+BENCHMARK(RpcBatchParallel);
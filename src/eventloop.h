@@ -35,7 +35,7 @@ public:
     * @return true if element was filled
     * @return false if element was not filled
     */
-    bool GetNext(T& out, const condCheck& pre, const condCheck& post)
+    virtual bool GetNext(T& out, const condCheck& pre, const condCheck& post)
     {
         WAIT_LOCK(m_mutex, lock);
 
@@ -64,7 +64,7 @@ public:
         return true;
     }
 
-    bool Add(T entry)
+    virtual bool Add(T entry)
     {
         LOCK(m_mutex);
 
@@ -76,7 +76,7 @@ public:
         m_cv.notify_one();
         return true;
     }
-    void Interrupt()
+    virtual void Interrupt()
     {
         LOCK(m_mutex);
         // This just simply unblocks all threads that are waiting for value.
@@ -88,7 +88,7 @@ public:
         m_cv.notify_all();
     }
 
-    size_t Size()
+    virtual size_t Size()
     {
         LOCK(m_mutex);
         return _Size();
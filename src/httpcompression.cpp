@@ -0,0 +1,227 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <httpcompression.h>
+
+#include <util/strencodings.h>
+#include <util/string.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include <zlib.h>
+
+/** Balance between reply size and worker time */
+static const int HTTP_COMPRESSION_LEVEL = 6;
+/** Maximum length of deflate stored block */
+static const size_t MAX_STORED_BLOCK = 65535;
+
+static std::vector<std::string> Split(const std::string& str, char separator)
+{
+    std::vector<std::string> result;
+    size_t begin = 0;
+    while (true)
+    {
+        size_t end = str.find(separator, begin);
+        result.push_back(str.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos)
+            return result;
+
+        begin = end + 1;
+    }
+}
+
+/** Quality in thousandths, malformed value keeps coding acceptable */
+static int64_t ParseQuality(const std::vector<std::string>& params)
+{
+    int64_t quality = 1000;
+    for (size_t i = 1; i < params.size(); i++)
+    {
+        auto param = TrimString(params[i]);
+        if (param.size() > 2 && ToLower(param.substr(0, 2)) == "q=")
+        {
+            int64_t value;
+            if (ParseFixedPoint(param.substr(2), 3, &value) && value >= 0 && value <= 1000)
+                quality = value;
+        }
+    }
+
+    return quality;
+}
+
+HTTPEncoding SelectHTTPEncoding(const std::string& acceptEncoding)
+{
+    // -1 - coding is not listed in header
+    int64_t gzip = -1;
+    int64_t deflate = -1;
+    int64_t any = -1;
+
+    for (const auto& item : Split(acceptEncoding, ','))
+    {
+        auto params = Split(item, ';');
+        auto coding = ToLower(TrimString(params[0]));
+        auto quality = ParseQuality(params);
+
+        if (coding == "gzip" || coding == "x-gzip")
+            gzip = std::max(gzip, quality);
+        else if (coding == "deflate")
+            deflate = std::max(deflate, quality);
+        else if (coding == "*")
+            any = std::max(any, quality);
+    }
+
+    // Wildcard applies only to codings not listed explicitly
+    if (gzip < 0)
+        gzip = any;
+    if (deflate < 0)
+        deflate = any;
+
+    // Coding with zero quality is not acceptable, gzip wins ties
+    if (gzip > 0 && gzip >= deflate)
+        return HTTPEncoding::Gzip;
+
+    if (deflate > 0)
+        return HTTPEncoding::Deflate;
+
+    return HTTPEncoding::Identity;
+}
+
+const char* HTTPEncodingName(HTTPEncoding encoding)
+{
+    switch (encoding)
+    {
+        case HTTPEncoding::Gzip: return "gzip";
+        case HTTPEncoding::Deflate: return "deflate";
+        default: return "identity";
+    }
+}
+
+static uint32_t Crc32(const std::string& data)
+{
+    return crc32(0L, (const Bytef*) data.data(), (uInt) data.size());
+}
+
+static uint32_t Adler32(const std::string& data)
+{
+    return adler32(1L, (const Bytef*) data.data(), (uInt) data.size());
+}
+
+HTTPDeflateChunk DeflateChunk(const std::string& data)
+{
+    HTTPDeflateChunk chunk;
+    chunk.size = data.size();
+    chunk.crc32 = Crc32(data);
+    chunk.adler32 = Adler32(data);
+
+    // Raw stream without header - chunk is wrapped into gzip or zlib container later
+    z_stream stream{};
+    if (deflateInit2(&stream, HTTP_COMPRESSION_LEVEL, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        throw std::runtime_error("Failed to initialize deflate");
+
+    chunk.data.resize(deflateBound(&stream, data.size()) + 16);
+    stream.next_in = (Bytef*) data.data();
+    stream.avail_in = (uInt) data.size();
+
+    // Sync flush aligns output to byte boundary without marking last block as final
+    size_t used = 0;
+    while (true)
+    {
+        stream.next_out = (Bytef*) &chunk.data[used];
+        stream.avail_out = (uInt) (chunk.data.size() - used);
+
+        int ret = deflate(&stream, Z_SYNC_FLUSH);
+        used = chunk.data.size() - stream.avail_out;
+
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            deflateEnd(&stream);
+            throw std::runtime_error("Failed to deflate reply");
+        }
+
+        if (stream.avail_out != 0)
+            break;
+
+        chunk.data.resize(chunk.data.size() * 2);
+    }
+
+    deflateEnd(&stream);
+    chunk.data.resize(used);
+    return chunk;
+}
+
+bool IsDeflateChunkOf(const HTTPDeflateChunk& chunk, const std::string& data)
+{
+    return chunk.size == data.size() && chunk.crc32 == Crc32(data) && chunk.adler32 == Adler32(data);
+}
+
+/** Append data as uncompressed deflate blocks, final block closes stream */
+static void AppendStoredBlocks(std::string& out, const std::string& data, bool final)
+{
+    size_t offset = 0;
+    do
+    {
+        size_t len = std::min(MAX_STORED_BLOCK, data.size() - offset);
+        bool last = final && offset + len == data.size();
+
+        out += (char) (last ? 0x01 : 0x00);
+        out += (char) (len & 0xff);
+        out += (char) (len >> 8);
+        out += (char) (~len & 0xff);
+        out += (char) ((~len >> 8) & 0xff);
+        out.append(data, offset, len);
+
+        offset += len;
+    }
+    while (offset < data.size());
+}
+
+static void AppendLE32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out += (char) ((value >> (8 * i)) & 0xff);
+}
+
+static void AppendBE32(std::string& out, uint32_t value)
+{
+    for (int i = 3; i >= 0; i--)
+        out += (char) ((value >> (8 * i)) & 0xff);
+}
+
+std::string EncodeHTTPBody(HTTPEncoding encoding, const std::string& prefix, const HTTPDeflateChunk& chunk, const std::string& suffix)
+{
+    std::string out;
+    out.reserve(prefix.size() + chunk.data.size() + suffix.size() + 64);
+
+    if (encoding == HTTPEncoding::Gzip)
+        out.append("\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff", 10);
+    else
+        out.append("\x78\x9c", 2);
+
+    AppendStoredBlocks(out, prefix, false);
+    out += chunk.data;
+    AppendStoredBlocks(out, suffix, true);
+
+    // Checksums of whole body are combined from checksums of parts
+    if (encoding == HTTPEncoding::Gzip)
+    {
+        uint32_t crc = crc32_combine(Crc32(prefix), chunk.crc32, (z_off_t) chunk.size);
+        crc = crc32_combine(crc, Crc32(suffix), (z_off_t) suffix.size());
+        AppendLE32(out, crc);
+        AppendLE32(out, (uint32_t) (prefix.size() + chunk.size + suffix.size()));
+    }
+    else
+    {
+        uint32_t adler = adler32_combine(Adler32(prefix), chunk.adler32, (z_off_t) chunk.size);
+        adler = adler32_combine(adler, Adler32(suffix), (z_off_t) suffix.size());
+        AppendBE32(out, adler);
+    }
+
+    return out;
+}
+
+std::string EncodeHTTPBody(HTTPEncoding encoding, const std::string& data)
+{
+    return EncodeHTTPBody(encoding, "", DeflateChunk(data), "");
+}
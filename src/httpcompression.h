@@ -0,0 +1,48 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCOIN_HTTPCOMPRESSION_H
+#define POCKETCOIN_HTTPCOMPRESSION_H
+
+#include <cstdint>
+#include <string>
+
+/** Content encodings of HTTP replies */
+enum class HTTPEncoding
+{
+    Identity,
+    Gzip,
+    Deflate,
+};
+
+/** Encoding with highest quality in Accept-Encoding header value, gzip over deflate on equal quality */
+HTTPEncoding SelectHTTPEncoding(const std::string& acceptEncoding);
+
+/** Content-Encoding header value */
+const char* HTTPEncodingName(HTTPEncoding encoding);
+
+/** Raw deflate blocks of data ending on byte boundary, with checksums of uncompressed data.
+ * Compressed once and placed between different prefixes and suffixes of replies.
+ */
+struct HTTPDeflateChunk
+{
+    std::string data;
+    uint64_t size = 0;
+    uint32_t crc32 = 0;
+    uint32_t adler32 = 1;
+};
+
+/** Compress data into chunk, throws std::runtime_error if zlib fails */
+HTTPDeflateChunk DeflateChunk(const std::string& data);
+
+/** Chunk was compressed from data */
+bool IsDeflateChunkOf(const HTTPDeflateChunk& chunk, const std::string& data);
+
+/** Reply body for encoding with prefix and suffix stored uncompressed around compressed chunk */
+std::string EncodeHTTPBody(HTTPEncoding encoding, const std::string& prefix, const HTTPDeflateChunk& chunk, const std::string& suffix);
+
+/** Compressed reply body for encoding */
+std::string EncodeHTTPBody(HTTPEncoding encoding, const std::string& data);
+
+#endif // POCKETCOIN_HTTPCOMPRESSION_H
@@ -91,7 +91,7 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
 
 static bool HTTPReq_JSONRPC_Anonymous(const util::Ref& context, HTTPRequest* req)
 {
-    return g_webSocket->HTTPReq(req, context, g_webSocket->m_table_rpc);
+    return g_webSocket->HTTPReq(req, context, g_webSocket->m_table_rpc, g_webSocket->m_workQueue);
 }
 
 static bool HTTPReq_JSONRPC_Post_Anonymous(const util::Ref& context, HTTPRequest* req)
@@ -16,11 +16,14 @@
 #include <node/ui_interface.h>
 #include <memory>
 #include <cstdlib>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <future>
 #include <rpc/register.h>
 #include <walletinitinterface.h>
 #include "eventloop.h"
+#include "pocketdb/helpers/JsonWriter.h"
 
 #ifdef EVENT__HAVE_NETINET_IN_H
 #include <netinet/in.h>
@@ -35,6 +38,12 @@
 
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
+/** Maximum part of request body searched for method names */
+static const size_t MAX_CLASSIFY_BODY_SIZE = 4096;
+/** Cheap requests taken from queue for every heavy one */
+static const int CHEAP_LANE_WEIGHT = 4;
+/** Single source of all requests of private socket */
+static const std::string PRIVATE_QUEUE_SOURCE = "private";
 
 class ExecutorSqlite : public IQueueProcessor<std::unique_ptr<HTTPClosure>>
 {
@@ -56,7 +65,7 @@ private:
 struct HTTPPathHandler
 {
     HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler,
-                    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> _queue) :
+                    std::shared_ptr<HTTPWorkQueue> _queue) :
         prefix(_prefix), exactMatch(_exactMatch), handler(_handler), queue(_queue)
     {
     }
@@ -64,7 +73,7 @@ struct HTTPPathHandler
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
-    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> queue;
+    std::shared_ptr<HTTPWorkQueue> queue;
 };
 
 /** HTTP module state */
@@ -75,6 +84,10 @@ static struct event_base *eventBase = nullptr;
 static struct evhttp *eventHTTP = nullptr;
 //! List of subnets to allow RPC connections from
 static std::vector<CSubNet> rpc_allow_subnets;
+//! Average execution time in milliseconds from which requests are queued in heavy lane
+static int64_t heavyMethodTime = DEFAULT_HTTP_HEAVY_METHOD_TIME;
+//! Minimum size of compressed replies, 0 - compression disabled
+static int64_t compressMinSize = DEFAULT_HTTP_COMPRESS_MIN_SIZE;
 
 //! HTTP socket objects to handle requests on different routes
 HTTPSocket *g_socket;
@@ -83,6 +96,8 @@ HTTPSocket *g_staticSocket;
 HTTPSocket *g_restSocket;
 
 static std::thread g_thread_http;
+//! Workers of public sockets
+static std::unique_ptr<HTTPWorkerPool> g_workerPool;
 
 /** Check if a network address is allowed to access the HTTP server */
 static bool ClientAllowed(const CNetAddr &netaddr)
@@ -147,6 +162,54 @@ std::string RequestMethodString(HTTPRequest::RequestMethod m)
     }
 }
 
+/** Key of request statistic recorded by work item - REST and static handlers are measured per path prefix */
+static std::string GetStatKey(const HTTPSocket* httpSock, const HTTPPathHandler& handler)
+{
+    if (httpSock == g_restSocket)
+        return handler.prefix;
+
+    if (httpSock == g_staticSocket)
+        return "static" + handler.prefix;
+
+    return "";
+}
+
+/** Lane of request by average execution time of requested methods or handler, unknown ones are cheap */
+static HTTPWorkLane ClassifyRequest(const HTTPRequest& req, const std::string& statKey)
+{
+    if (heavyMethodTime <= 0)
+        return HTTPWorkLane::Cheap;
+
+    std::vector<std::string> keys;
+    if (!statKey.empty())
+        keys.push_back(statKey);
+
+    // Method names of single and batch JSON-RPC requests without parsing whole body
+    std::string body = keys.empty() ? req.PeekBody(MAX_CLASSIFY_BODY_SIZE) : "";
+    static const std::string token = "\"method\"";
+    for (size_t pos = body.find(token); pos != std::string::npos; pos = body.find(token, pos))
+    {
+        size_t begin = body.find('"', pos + token.size());
+        size_t end = begin == std::string::npos ? begin : body.find('"', begin + 1);
+        if (end == std::string::npos)
+            break;
+
+        keys.push_back(body.substr(begin + 1, end - begin - 1));
+        pos = end + 1;
+    }
+
+    if (keys.empty())
+        keys.push_back(req.GetURI());
+
+    for (const auto& key : keys)
+    {
+        if (gStatEngineInstance.GetAverageExecution(key).count() >= heavyMethodTime)
+            return HTTPWorkLane::Heavy;
+    }
+
+    return HTTPWorkLane::Cheap;
+}
+
 /** HTTP request callback */
 static void http_request_cb(struct evhttp_request *req, void *arg)
 {
@@ -196,34 +259,25 @@ static void http_request_cb(struct evhttp_request *req, void *arg)
 
     // Find registered handler for prefix
     std::string strURI = hreq->GetURI();
-    std::string path;
-    auto i = httpSock->m_pathHandlers.begin();
-    auto iend = httpSock->m_pathHandlers.end();
-
-    for (; i != iend; ++i)
-    {
-        bool match = false;
-        if (i->exactMatch)
-            match = (strURI == i->prefix);
-        else
-            match = (strURI.substr(0, i->prefix.size()) == i->prefix);
-
-        if (match)
-        {
-            path = strURI.substr(i->prefix.size());
-            break;
-        }
-    }
+    int index = httpSock->m_pathTrie.Find(strURI);
 
     // Dispatch to worker thread
-    if (i != iend)
+    if (index >= 0)
     {
-        auto item = std::make_unique<HTTPWorkItem>(hreq, path, i->handler);
+        const auto& handler = httpSock->m_pathHandlers[index];
+        std::string path = strURI.substr(handler.prefix.size());
+        std::string statKey = GetStatKey(httpSock, handler);
+        auto item = std::make_unique<HTTPWorkItem>(hreq, path, handler.handler, statKey);
+
+        // Private socket keeps arrival order: one source in cheap lane is never reordered or displaced
+        bool queued = httpSock->m_publicAccess ?
+            handler.queue->Add(std::move(item), ClassifyRequest(*hreq, statKey), hreq->GetPeer().ToStringIP()) :
+            handler.queue->Add(std::move(item), HTTPWorkLane::Cheap, PRIVATE_QUEUE_SOURCE);
 
-        if (!i->queue->Add(std::move(item)))
+        if (!queued)
         {
             LogPrint(BCLog::RPCERROR, "WARNING: request rejected because http work queue depth exceeded.\n");
-            hreq->WriteReply(HTTP_INTERNAL, "Work queue depth exceeded");
+            hreq->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Work queue depth exceeded");
         }
     }
     else
@@ -366,6 +420,8 @@ bool InitHTTPServer(const util::Ref& context)
 #endif
     
     int timeout = gArgs.GetArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT);
+    heavyMethodTime = gArgs.GetArg("-rpcheavymethodtime", DEFAULT_HTTP_HEAVY_METHOD_TIME);
+    compressMinSize = gArgs.GetArg("-rpccompressminsize", DEFAULT_HTTP_COMPRESS_MIN_SIZE);
     int workQueueMainDepth = std::max((long) gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
     int workQueuePostDepth = std::max((long) gArgs.GetArg("-rpcpostworkqueue", DEFAULT_HTTP_POST_WORKQUEUE), 1L);
     int workQueuePublicDepth = std::max((long) gArgs.GetArg("-rpcpublicworkqueue", DEFAULT_HTTP_PUBLIC_WORKQUEUE), 1L);
@@ -383,6 +439,7 @@ bool InitHTTPServer(const util::Ref& context)
     RegisterMiscRPCCommands(g_socket->m_table_rpc);
     RegisterMiningRPCCommands(g_socket->m_table_rpc);
     RegisterRawTransactionRPCCommands(g_socket->m_table_rpc);
+    RegisterPocketnetPrivateRPCCommands(g_socket->m_table_rpc);
 
     for (const auto& client : node.chain_clients) {
         client->registerRpcs();
@@ -438,35 +495,66 @@ void StartHTTPServer()
 {
     LogPrint(BCLog::HTTP, "Starting HTTP server\n");
     int rpcMainThreads = std::max((long) gArgs.GetArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1L);
-    int rpcPostThreads = std::max((long) gArgs.GetArg("-rpcpostthreads", DEFAULT_HTTP_POST_THREADS), 1L);
-    int rpcPublicThreads = std::max((long) gArgs.GetArg("-rpcpublicthreads", DEFAULT_HTTP_PUBLIC_THREADS), 1L);
-    int rpcStaticThreads = std::max((long) gArgs.GetArg("-rpcstaticthreads", DEFAULT_HTTP_STATIC_THREADS), 1L);
-    int rpcRestThreads = std::max((long) gArgs.GetArg("-rpcrestthreads", DEFAULT_HTTP_REST_THREADS), 1L);
+    int rpcPostWeight = std::max((long) gArgs.GetArg("-rpcpostthreads", DEFAULT_HTTP_POST_THREADS), 1L);
+    int rpcPublicWeight = std::max((long) gArgs.GetArg("-rpcpublicthreads", DEFAULT_HTTP_PUBLIC_THREADS), 1L);
+    int rpcStaticWeight = std::max((long) gArgs.GetArg("-rpcstaticthreads", DEFAULT_HTTP_STATIC_THREADS), 1L);
+    int rpcRestWeight = std::max((long) gArgs.GetArg("-rpcrestthreads", DEFAULT_HTTP_REST_THREADS), 1L);
+
+    // Requests mostly wait for sqlite reads - twice more workers than cores by default
+    int rpcPoolThreads = gArgs.GetArg("-rpcpoolthreads", DEFAULT_HTTP_POOL_THREADS);
+
+    // Per socket thread counts of old configs are weights of the shared pool now
+    bool legacyThreads = false;
+    for (const auto& arg : { "-rpcpublicthreads", "-rpcpostthreads", "-rpcstaticthreads", "-rpcrestthreads" })
+        legacyThreads |= gArgs.IsArgSet(arg);
+
+    if (legacyThreads)
+    {
+        if (!gArgs.IsArgSet("-rpcpoolthreads"))
+        {
+            // Keep the number of threads the config asked for
+            rpcPoolThreads = 0;
+            if (g_webSocket) rpcPoolThreads += rpcPublicWeight + rpcPostWeight;
+            if (g_staticSocket) rpcPoolThreads += rpcStaticWeight;
+            if (g_restSocket) rpcPoolThreads += rpcRestWeight;
+        }
+
+        LogPrintf("WARNING: -rpcpublicthreads, -rpcpostthreads, -rpcstaticthreads and -rpcrestthreads are deprecated "
+                  "and set weights of the shared worker pool, use -rpcpoolthreads for the number of threads\n");
+    }
+
+    if (rpcPoolThreads <= 0)
+        rpcPoolThreads = std::max(4, GetNumCores() * 2);
 
     g_thread_http = std::thread(ThreadHTTP, eventBase);
 
+    // Private socket keeps own threads so node management is not blocked by public load
     if (g_socket)
     {
         g_socket->StartHTTPSocket(rpcMainThreads, false);
         LogPrintf("HTTP: starting %d Main worker threads\n", rpcMainThreads);
     }
 
-    // The same worker threads will service POST and PUBLIC RPC requests
+    g_workerPool = std::make_unique<HTTPWorkerPool>();
     if (g_webSocket)
     {
-        g_webSocket->StartHTTPSocket(rpcPublicThreads, rpcPostThreads, true);
-        LogPrintf("HTTP: starting %d Public worker threads\n", rpcPublicThreads);
+        g_workerPool->AddQueue("public", g_webSocket->m_workQueue, rpcPublicWeight);
+        g_workerPool->AddQueue("post", g_webSocket->m_workPostQueue, rpcPostWeight);
     }
     if (g_staticSocket)
-    {
-        g_staticSocket->StartHTTPSocket(rpcStaticThreads, false);
-        LogPrintf("HTTP: starting %d Static worker threads\n", rpcStaticThreads);
-    }
+        g_workerPool->AddQueue("static", g_staticSocket->m_workQueue, rpcStaticWeight);
     if (g_restSocket)
-    {
-        g_restSocket->StartHTTPSocket(rpcRestThreads, true);
-        LogPrintf("HTTP: starting %d Rest worker threads\n", rpcRestThreads);
-    }
+        g_workerPool->AddQueue("rest", g_restSocket->m_workQueue, rpcRestWeight);
+
+    g_workerPool->Start(rpcPoolThreads);
+}
+
+UniValue GetHTTPWorkerPoolStatistic()
+{
+    if (!g_workerPool)
+        return NullUniValue;
+
+    return g_workerPool->GetStatistic();
 }
 
 void InterruptHTTPServer()
@@ -476,6 +564,7 @@ void InterruptHTTPServer()
     if (g_webSocket) g_webSocket->InterruptHTTPSocket();
     if (g_staticSocket) g_staticSocket->InterruptHTTPSocket();
     if (g_restSocket) g_restSocket->InterruptHTTPSocket();
+    if (g_workerPool) g_workerPool->Stop();
 }
 
 void StopHTTPServer()
@@ -487,6 +576,7 @@ void StopHTTPServer()
     if (g_webSocket) g_webSocket->StopHTTPSocket();
     if (g_staticSocket) g_staticSocket->StopHTTPSocket();
     if (g_restSocket) g_restSocket->StopHTTPSocket();
+    g_workerPool.reset();
 
     if (eventBase)
     {
@@ -553,7 +643,9 @@ HTTPSocket::HTTPSocket(struct event_base *base, int timeout, int queueDepth, boo
         evhttp_cmd_type::EVHTTP_REQ_OPTIONS
     );
 
-    m_workQueue = std::make_shared<QueueLimited<std::unique_ptr<HTTPClosure>>>(queueDepth);
+    // Node management requests of private socket are never shed by deadline
+    int64_t deadline = publicAccess ? gArgs.GetArg("-rpcqueuedeadline", DEFAULT_HTTP_QUEUE_DEADLINE) : 0;
+    m_workQueue = std::make_shared<HTTPWorkQueue>(queueDepth, deadline);
     LogPrintf("HTTP: creating work queue of depth %d\n", queueDepth);
 
     // transfer ownership to eventBase/HTTP via .release()
@@ -608,15 +700,16 @@ void HTTPSocket::StopHTTPSocket()
 
 void HTTPSocket::InterruptHTTPSocket()
 {
-    if (m_thread_http_workers.empty())
-        return;
-        
     if (m_eventHTTP)
     {
         // Reject requests on current connections
         evhttp_set_gencb(m_eventHTTP, http_reject_request_cb, nullptr);
     }
 
+    // Sockets served by worker pool have no own threads
+    if (m_thread_http_workers.empty())
+        return;
+
     // Do not clear queue so if we want to start again call StartHTTPSocket
     // and new threads will be created to process already exists queue.
     LogPrint(BCLog::HTTP, "Waiting for HTTP worker threads to exit\n");
@@ -651,10 +744,11 @@ int HTTPSocket::GetAddressCount()
 }
 
 void HTTPSocket::RegisterHTTPHandler(const std::string &prefix, bool exactMatch,
-                                     const HTTPRequestHandler &handler, std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> _queue)
+                                     const HTTPRequestHandler &handler, std::shared_ptr<HTTPWorkQueue> _queue)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
     m_pathHandlers.emplace_back(prefix, exactMatch, handler, _queue);
+    m_pathTrie.Build(m_pathHandlers);
 }
 
 void HTTPSocket::UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
@@ -668,7 +762,585 @@ void HTTPSocket::UnregisterHTTPHandler(const std::string &prefix, bool exactMatc
     {
         LogPrint(BCLog::HTTP, "Unregistering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
         m_pathHandlers.erase(i);
+        m_pathTrie.Build(m_pathHandlers);
+    }
+}
+
+void HTTPPathTrie::Build(const std::vector<HTTPPathHandler>& handlers)
+{
+    m_root = Node();
+
+    for (int index = 0; index < (int) handlers.size(); index++)
+    {
+        Node* node = &m_root;
+        for (char ch : handlers[index].prefix)
+        {
+            auto& child = node->children[ch];
+            if (!child)
+                child = std::make_unique<Node>();
+
+            node = child.get();
+        }
+
+        int& target = handlers[index].exactMatch ? node->exactIndex : node->prefixIndex;
+        if (target < 0)
+            target = index;
+    }
+}
+
+int HTTPPathTrie::Find(const std::string& uri) const
+{
+    auto better = [](int current, int candidate) {
+        return candidate >= 0 && (current < 0 || candidate < current) ? candidate : current;
+    };
+
+    int result = -1;
+    const Node* node = &m_root;
+    for (size_t i = 0; ; i++)
+    {
+        result = better(result, node->prefixIndex);
+
+        if (i == uri.size())
+        {
+            result = better(result, node->exactIndex);
+            break;
+        }
+
+        auto child = node->children.find(uri[i]);
+        if (child == node->children.end())
+            break;
+
+        node = child->second.get();
     }
+
+    return result;
+}
+
+HTTPWorkQueue::HTTPWorkQueue(size_t maxDepth, int64_t deadlineMillis) :
+    m_maxDepth(maxDepth), m_deadlineMillis(deadlineMillis)
+{
+}
+
+bool HTTPWorkQueue::GetNext(Entry& out, const condCheck& pre, const condCheck& post)
+{
+    bool result = false;
+    std::vector<Entry> expired;
+
+    {
+        WAIT_LOCK(m_mutex, lock);
+
+        if (pre && !pre())
+            return false;
+
+        if (m_size == 0)
+            m_cv.wait(lock);
+
+        if (post && !post())
+            return false;
+
+        result = PopReadyLocked(out, expired);
+    }
+
+    ShedExpired(expired);
+    return result;
+}
+
+bool HTTPWorkQueue::TryGetNext(Entry& out)
+{
+    bool result = false;
+    std::vector<Entry> expired;
+
+    {
+        LOCK(m_mutex);
+        result = PopReadyLocked(out, expired);
+    }
+
+    ShedExpired(expired);
+    return result;
+}
+
+void HTTPWorkQueue::SetListener(std::function<void()> listener)
+{
+    LOCK(m_mutex);
+    m_listener = std::move(listener);
+}
+
+bool HTTPWorkQueue::Add(Entry entry)
+{
+    return Add(std::move(entry), HTTPWorkLane::Cheap, "");
+}
+
+bool HTTPWorkQueue::Add(Entry entry, HTTPWorkLane lane, const std::string& source)
+{
+    Entry displaced;
+    std::function<void()> listener;
+
+    {
+        LOCK(m_mutex);
+
+        // Internal work of empty source is not limited and not counted in depth
+        auto internal = m_sourceSizes.find("");
+        size_t depth = m_size - (internal == m_sourceSizes.end() ? 0 : internal->second);
+
+        if (!source.empty() && depth >= m_maxDepth)
+        {
+            displaced = DisplaceLocked(lane, source);
+
+            if (!displaced)
+            {
+                m_rejected++;
+                return false;
+            }
+        }
+
+        auto& target = m_lanes[(int) lane];
+        auto& queue = target.sources[source];
+        if (queue.empty())
+            target.rotation.push_back(source);
+
+        queue.push_back(Item{std::move(entry), GetTimeMillis() + m_deadlineMillis});
+        target.size++;
+        m_sourceSizes[source]++;
+        m_size++;
+        m_added[(int) lane]++;
+
+        m_cv.notify_one();
+        listener = m_listener;
+    }
+
+    if (listener)
+        listener();
+
+    if (displaced)
+    {
+        m_displaced++;
+        displaced->Shed("Work queue depth exceeded");
+    }
+
+    return true;
+}
+
+void HTTPWorkQueue::Interrupt()
+{
+    LOCK(m_mutex);
+    m_cv.notify_all();
+}
+
+size_t HTTPWorkQueue::Size()
+{
+    LOCK(m_mutex);
+    return m_size;
+}
+
+UniValue HTTPWorkQueue::GetStatistic()
+{
+    UniValue result(UniValue::VOBJ);
+
+    {
+        LOCK(m_mutex);
+        result.pushKV("depth", (int64_t) m_size);
+        result.pushKV("cheap", (int64_t) m_lanes[(int) HTTPWorkLane::Cheap].size);
+        result.pushKV("heavy", (int64_t) m_lanes[(int) HTTPWorkLane::Heavy].size);
+        result.pushKV("sources", (int64_t) m_sourceSizes.size());
+    }
+
+    result.pushKV("cheaptotal", (int64_t) m_added[(int) HTTPWorkLane::Cheap].load());
+    result.pushKV("heavytotal", (int64_t) m_added[(int) HTTPWorkLane::Heavy].load());
+    result.pushKV("rejected", (int64_t) m_rejected.load());
+    result.pushKV("displaced", (int64_t) m_displaced.load());
+    result.pushKV("expired", (int64_t) m_expired.load());
+
+    return result;
+}
+
+bool HTTPWorkQueue::PopReadyLocked(Entry& out, std::vector<Entry>& expired)
+{
+    int64_t now = GetTimeMillis();
+    while (m_size > 0)
+    {
+        Item item = PopLocked();
+        if (m_deadlineMillis > 0 && item.deadline < now)
+        {
+            expired.push_back(std::move(item.entry));
+            continue;
+        }
+
+        out = std::move(item.entry);
+        return true;
+    }
+
+    return false;
+}
+
+void HTTPWorkQueue::ShedExpired(std::vector<Entry>& expired)
+{
+    // Client has most likely given up waiting for these requests
+    m_expired += expired.size();
+    for (auto& entry : expired)
+        entry->Shed("Work queue deadline exceeded");
+}
+
+HTTPWorkQueue::Item HTTPWorkQueue::PopLocked()
+{
+    auto& cheap = m_lanes[(int) HTTPWorkLane::Cheap];
+    auto& heavy = m_lanes[(int) HTTPWorkLane::Heavy];
+
+    // Weighted turns between lanes - heavy requests are slowed down but never starve
+    bool takeCheap = cheap.size > 0 && (heavy.size == 0 || m_cheapServed < CHEAP_LANE_WEIGHT);
+    m_cheapServed = takeCheap ? m_cheapServed + 1 : 0;
+    auto& lane = takeCheap ? cheap : heavy;
+
+    // Sources of lane are served in turn
+    std::string source = std::move(lane.rotation.front());
+    lane.rotation.pop_front();
+
+    auto it = lane.sources.find(source);
+    Item item = std::move(it->second.front());
+    it->second.pop_front();
+
+    if (it->second.empty())
+        lane.sources.erase(it);
+    else
+        lane.rotation.push_back(source);
+
+    auto size = m_sourceSizes.find(source);
+    if (--size->second == 0)
+        m_sourceSizes.erase(size);
+
+    lane.size--;
+    m_size--;
+    return item;
+}
+
+HTTPWorkQueue::Entry HTTPWorkQueue::DisplaceLocked(HTTPWorkLane lane, const std::string& source)
+{
+    auto sourceSize = m_sourceSizes.find(source);
+    size_t ownSize = sourceSize == m_sourceSizes.end() ? 0 : sourceSize->second;
+
+    // Heavy request may displace only heavy ones, cheap request - any
+    for (int victimLane = (int) HTTPWorkLane::Heavy; victimLane >= (int) lane; victimLane--)
+    {
+        auto& target = m_lanes[victimLane];
+
+        auto victim = target.sources.end();
+        size_t victimSize = 0;
+        for (auto it = target.sources.begin(); it != target.sources.end(); it++)
+        {
+            if (it->first.empty())
+                continue;
+
+            size_t size = m_sourceSizes[it->first];
+            if (size > victimSize)
+            {
+                victim = it;
+                victimSize = size;
+            }
+        }
+
+        // New request would not make queue more fair
+        if (victim == target.sources.end() || victimSize <= ownSize + 1)
+            continue;
+
+        Entry entry = std::move(victim->second.back().entry);
+        victim->second.pop_back();
+
+        auto size = m_sourceSizes.find(victim->first);
+        if (--size->second == 0)
+            m_sourceSizes.erase(size);
+
+        if (victim->second.empty())
+        {
+            target.rotation.erase(std::find(target.rotation.begin(), target.rotation.end(), victim->first));
+            target.sources.erase(victim);
+        }
+
+        target.size--;
+        m_size--;
+        return entry;
+    }
+
+    return nullptr;
+}
+
+HTTPWorkerPool::~HTTPWorkerPool()
+{
+    Stop();
+
+    // Queues are shared with path handlers and may outlive pool
+    for (const auto& member : m_members)
+        member->queue->SetListener(nullptr);
+}
+
+void HTTPWorkerPool::AddQueue(const std::string& name, std::shared_ptr<HTTPWorkQueue> queue, int weight)
+{
+    if (!queue)
+        return;
+
+    auto member = std::make_unique<Member>();
+    member->name = name;
+    member->queue = std::move(queue);
+    member->weight = std::max(weight, 1);
+    member->queue->SetListener([this]() { Notify(); });
+    m_members.push_back(std::move(member));
+}
+
+void HTTPWorkerPool::Start(int threadCount)
+{
+    if (m_members.empty())
+        return;
+
+    {
+        LOCK(m_mutex);
+        m_running = true;
+    }
+
+    m_startMicros = GetTimeMicros();
+
+    for (int i = 0; i < threadCount; i++)
+    {
+        // Next worker is home for queue with least workers by weight - every queue gets at least one
+        size_t home = 0;
+        for (size_t m = 1; m < m_members.size(); m++)
+        {
+            if ((int64_t) m_members[m]->homeWorkers * m_members[home]->weight <
+                (int64_t) m_members[home]->homeWorkers * m_members[m]->weight)
+                home = m;
+        }
+
+        m_members[home]->homeWorkers++;
+        m_threads.emplace_back(&HTTPWorkerPool::Worker, this, home);
+    }
+
+    for (const auto& member : m_members)
+        LogPrintf("HTTP: starting %d %s worker threads of %d in pool\n", member->homeWorkers, member->name, threadCount);
+}
+
+void HTTPWorkerPool::Stop()
+{
+    {
+        LOCK(m_mutex);
+        m_running = false;
+    }
+
+    m_cond.notify_all();
+
+    for (auto& thread : m_threads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+
+    m_threads.clear();
+}
+
+void HTTPWorkerPool::Notify()
+{
+    {
+        LOCK(m_mutex);
+        m_signals++;
+    }
+
+    m_cond.notify_one();
+}
+
+bool HTTPWorkerPool::Take(size_t home, std::unique_ptr<HTTPClosure>& entry, size_t& source)
+{
+    if (m_members[home]->queue->TryGetNext(entry))
+    {
+        source = home;
+        return true;
+    }
+
+    // Steal from queues with largest backlog by weight first
+    std::vector<std::pair<uint64_t, size_t>> candidates;
+    for (size_t m = 0; m < m_members.size(); m++)
+    {
+        if (m == home)
+            continue;
+
+        size_t size = m_members[m]->queue->Size();
+        if (size > 0)
+            candidates.emplace_back((uint64_t) size * m_members[m]->weight, m);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), std::greater<>());
+    for (const auto& [backlog, m] : candidates)
+    {
+        if (m_members[m]->queue->TryGetNext(entry))
+        {
+            source = m;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HTTPWorkerPool::Worker(size_t home)
+{
+    util::ThreadRename("http." + m_members[home]->name);
+
+    ExecutorSqlite executor(true);
+    while (true)
+    {
+        uint64_t signals;
+        {
+            LOCK(m_mutex);
+            if (!m_running)
+                break;
+
+            signals = m_signals;
+        }
+
+        std::unique_ptr<HTTPClosure> entry;
+        size_t source;
+        if (Take(home, entry, source))
+        {
+            int64_t start = GetTimeMicros();
+
+            try
+            {
+                executor.Process(std::move(entry));
+            }
+            catch (const std::exception& e)
+            {
+                LogPrintf("HTTP worker pool thread exception: %s\n", e.what());
+            }
+
+            auto& member = *m_members[source];
+            member.executed++;
+            member.busyMicros += GetTimeMicros() - start;
+            if (source != home)
+                member.stolen++;
+
+            continue;
+        }
+
+        WAIT_LOCK(m_mutex, lock);
+        m_idle++;
+        while (m_running && m_signals == signals)
+            m_cond.wait(lock);
+        m_idle--;
+    }
+}
+
+int HTTPWorkerPool::GetIdle()
+{
+    LOCK(m_mutex);
+    return m_idle;
+}
+
+UniValue HTTPWorkerPool::GetStatistic()
+{
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("threads", (int64_t) m_threads.size());
+
+    // Part of pool capacity spent on requests of every queue since start
+    double capacity = (double) std::max((int64_t) 1, GetTimeMicros() - m_startMicros) * (double) std::max((size_t) 1, m_threads.size());
+
+    UniValue queues(UniValue::VOBJ);
+    for (const auto& member : m_members)
+    {
+        UniValue queue(UniValue::VOBJ);
+        queue.pushKV("homethreads", member->homeWorkers);
+        queue.pushKV("depth", (int64_t) member->queue->Size());
+        queue.pushKV("executed", (int64_t) member->executed.load());
+        queue.pushKV("stolen", (int64_t) member->stolen.load());
+        queue.pushKV("utilization", (double) member->busyMicros.load() / capacity);
+        queues.pushKV(member->name, queue);
+    }
+
+    result.pushKV("queues", queues);
+    return result;
+}
+
+/** Shared state of batch executed by several workers */
+struct HTTPBatchState
+{
+    HTTPBatchState(const JSONRPCRequest& _jreq, const UniValue& _requests, const CRPCTable& _table) :
+        jreq(_jreq), requests(_requests), table(_table), replies(_requests.size())
+    {
+    }
+
+    JSONRPCRequest jreq;
+    const UniValue requests;
+    const CRPCTable& table;
+    std::vector<UniValue> replies;
+
+    std::atomic<size_t> next{0};
+    Mutex mutex;
+    std::condition_variable cond;
+    size_t done = 0;
+
+    /** Execute not started elements with db connection of current worker */
+    void Run(const DbConnectionRef& dbConnection)
+    {
+        size_t index;
+        while ((index = next++) < requests.size())
+        {
+            JSONRPCRequest elementReq(jreq);
+            elementReq.SetDbConnection(dbConnection);
+            auto reply = JSONRPCExecOne(elementReq, requests[index], table);
+
+            LOCK(mutex);
+            replies[index] = std::move(reply);
+            if (++done == requests.size())
+                cond.notify_all();
+        }
+    }
+};
+
+/** Work item helping to execute batch elements on other worker */
+class HTTPBatchItem final : public HTTPClosure
+{
+public:
+    explicit HTTPBatchItem(std::shared_ptr<HTTPBatchState> _state) : state(std::move(_state))
+    {
+    }
+
+    void operator()(DbConnectionRef& dbConnection) override
+    {
+        state->Run(dbConnection);
+    }
+
+private:
+    std::shared_ptr<HTTPBatchState> state;
+};
+
+/** Maximum number of workers helping one batch */
+static const size_t MAX_BATCH_HELPERS = 16;
+
+std::string JSONRPCExecBatchParallel(const JSONRPCRequest& jreq, const UniValue& vReq, const CRPCTable& table,
+    const std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>>& queue)
+{
+    if (vReq.size() < 2 || !queue)
+        return JSONRPCExecBatch(jreq, vReq, table);
+
+    auto state = std::make_shared<HTTPBatchState>(jreq, vReq, table);
+
+    // Busy workers would take helpers only after queued requests of other clients,
+    // so only idle ones are asked. Helpers started after all elements are taken finish immediately
+    size_t idle = g_workerPool ? (size_t) std::max(0, g_workerPool->GetIdle()) : 0;
+    size_t helpers = std::min({vReq.size() - 1, MAX_BATCH_HELPERS, idle});
+    for (size_t i = 0; i < helpers; i++)
+    {
+        if (!queue->Add(std::make_unique<HTTPBatchItem>(state)))
+            break;
+    }
+
+    state->Run(jreq.DbConnection());
+
+    {
+        WAIT_LOCK(state->mutex, lock);
+        while (state->done < vReq.size())
+            state->cond.wait(lock);
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (auto& reply : state->replies)
+        ret.push_back(std::move(reply));
+
+    return PocketHelpers::JsonWriter::Write(ret) + "\n";
 }
 
 static inline std::string gen_random(const int len) {
@@ -691,7 +1363,8 @@ static inline std::string gen_random(const int len) {
 
 }
 
-bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable& table)
+bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable& table,
+    const std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>>& batchQueue)
 {
     // JSONRPC handles only POST
     if (req->GetRequestMethod() != HTTPRequest::POST) {
@@ -705,6 +1378,7 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
     string peer;
     auto start = gStatEngineInstance.GetCurrentSystemTime();
     bool executeSuccess = true;
+    size_t replySize = 0;
 
     JSONRPCRequest jreq(context);
     try
@@ -717,6 +1391,7 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
         // Set the URI
         jreq.URI = req->GetURI();
         std::string strReply;
+        HTTPEncoding encoding = HTTPEncoding::Identity;
 
         // singleton request
         if (valRequest.isObject())
@@ -741,13 +1416,36 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
                 uri, method, rpcKey, (execute.count() - start.count()));
 
             // Send reply
-            strReply = JSONRPCReply(result, NullUniValue, jreq.id);
+            // Pocketnet methods return JSON written by JsonWriter inside univalue tree - spliced as is
+            std::string json = PocketHelpers::JsonWriter::Write(result);
+            encoding = req->GetReplyEncoding(json.size());
+            if (encoding != HTTPEncoding::Identity)
+            {
+                // Result of cached request is compressed once and wrapped into replies with own ids
+                auto compressed = table.getCompressedCache(jreq);
+                if (!compressed || !IsDeflateChunkOf(*compressed, json))
+                {
+                    compressed = std::make_shared<const HTTPDeflateChunk>(DeflateChunk(json));
+                    table.putCompressedCache(jreq, compressed);
+                }
+
+                strReply = EncodeHTTPBody(encoding, "{\"result\":", *compressed, ",\"error\":null,\"id\":" + jreq.id.write() + "}\n");
+            }
+            else
+            {
+                strReply = "{\"result\":" + json + ",\"error\":null,\"id\":" + jreq.id.write() + "}\n";
+            }
         }
         else
         {
             if (valRequest.isArray())
             {
-                strReply = JSONRPCExecBatch(jreq, valRequest.get_array(), table);
+                jreq.SetDbConnection(req->DbConnection());
+
+                if (batchQueue)
+                    strReply = JSONRPCExecBatchParallel(jreq, valRequest.get_array(), table, batchQueue);
+                else
+                    strReply = JSONRPCExecBatch(jreq, valRequest.get_array(), table);
             }
             else
             {
@@ -755,8 +1453,12 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
             }
         }
 
+        replySize = strReply.size();
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strReply);
+        if (encoding != HTTPEncoding::Identity)
+            req->WriteEncodedReply(HTTP_OK, encoding, strReply);
+        else
+            req->WriteReply(HTTP_OK, strReply);
     }
     catch (const UniValue& objError)
     {
@@ -771,21 +1473,20 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
         executeSuccess = false;
     }
 
-    // Collect statistic data
-    if (LogInstance().WillLogCategory(BCLog::STAT))
+    // Collect statistic data - per method histograms are always recorded without locks
     {
         auto finish = gStatEngineInstance.GetCurrentSystemTime();
 
         gStatEngineInstance.AddSample(
             Statistic::RequestSample{
-                uri,
+                method.empty() ? uri : method,
                 req->Created,
                 start,
                 finish,
                 peer,
                 !executeSuccess,
                 0,
-                0
+                replySize
             }
         );
     }
@@ -797,18 +1498,12 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
 HTTPWebSocket::HTTPWebSocket(struct event_base* base, int timeout, int queueDepth, int queuePostDepth, bool publicAccess)
     : HTTPSocket(base, timeout, queueDepth, publicAccess)
 {
-    m_workPostQueue = std::make_shared<QueueLimited<std::unique_ptr<HTTPClosure>>>(queuePostDepth);
+    m_workPostQueue = std::make_shared<HTTPWorkQueue>(queuePostDepth, gArgs.GetArg("-rpcqueuedeadline", DEFAULT_HTTP_QUEUE_DEADLINE));
     LogPrintf("HTTP: creating work post queue of depth %d\n", queuePostDepth);
 }
 
 HTTPWebSocket::~HTTPWebSocket() = default;
 
-void HTTPWebSocket::StartHTTPSocket(int threadCount, int threadPostCount, bool selfDbConnection)
-{
-    StartThreads("HTTPWebSocket::StartHTTPSocket (GET)", m_workQueue, threadCount, selfDbConnection);
-    StartThreads("HTTPWebSocket::StartHTTPSocket (POST)", m_workPostQueue, threadPostCount, selfDbConnection);
-}
-
 void HTTPWebSocket::StopHTTPSocket()
 {   
     // Interrupting socket here because stop without interrupting is illegal.
@@ -890,6 +1585,21 @@ std::string HTTPRequest::ReadBody()
     return rv;
 }
 
+std::string HTTPRequest::PeekBody(size_t maxSize) const
+{
+    struct evbuffer *buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+
+    std::string rv(std::min(evbuffer_get_length(buf), maxSize), '\0');
+    if (rv.empty())
+        return rv;
+
+    ev_ssize_t copied = evbuffer_copyout(buf, &rv[0], rv.size());
+    rv.resize(copied < 0 ? 0 : (size_t) copied);
+    return rv;
+}
+
 void HTTPRequest::WriteHeader(const std::string &hdr, const std::string &value)
 {
     struct evkeyvalq *headers = evhttp_request_get_output_headers(req);
@@ -905,6 +1615,45 @@ void HTTPRequest::WriteHeader(const std::string &hdr, const std::string &value)
 void HTTPRequest::WriteReply(int nStatus, const std::string &strReply)
 {
     assert(!replySent && req);
+
+    // Compression runs here on worker thread, not in event loop
+    auto encoding = GetReplyEncoding(strReply.size());
+    if (encoding != HTTPEncoding::Identity)
+    {
+        WriteEncodedReply(nStatus, encoding, EncodeHTTPBody(encoding, strReply));
+        return;
+    }
+
+    if (compressMinSize > 0 && strReply.size() >= (size_t) compressMinSize)
+        WriteHeader("Vary", "Accept-Encoding");
+
+    SendBody(nStatus, strReply);
+}
+
+HTTPEncoding HTTPRequest::GetReplyEncoding(size_t size) const
+{
+    if (compressMinSize <= 0 || size < (size_t) compressMinSize)
+        return HTTPEncoding::Identity;
+
+    // Handler has encoded reply itself
+    struct evkeyvalq *headers = evhttp_request_get_output_headers(req);
+    if (headers && evhttp_find_header(headers, "Content-Encoding"))
+        return HTTPEncoding::Identity;
+
+    auto [present, acceptEncoding] = GetHeader("Accept-Encoding");
+    return present ? SelectHTTPEncoding(acceptEncoding) : HTTPEncoding::Identity;
+}
+
+void HTTPRequest::WriteEncodedReply(int nStatus, HTTPEncoding encoding, const std::string& body)
+{
+    assert(!replySent && req);
+    WriteHeader("Content-Encoding", HTTPEncodingName(encoding));
+    WriteHeader("Vary", "Accept-Encoding");
+    SendBody(nStatus, body);
+}
+
+void HTTPRequest::SendBody(int nStatus, const std::string& body)
+{
     if (ShutdownRequested())
     {
         WriteHeader("Connection", "close");
@@ -912,7 +1661,35 @@ void HTTPRequest::WriteReply(int nStatus, const std::string &strReply)
     // Send event to main http thread to send reply message
     struct evbuffer *evb = evhttp_request_get_output_buffer(req);
     assert(evb);
-    evbuffer_add(evb, strReply.data(), strReply.size());
+    evbuffer_add(evb, body.data(), body.size());
+    SendReply(nStatus);
+}
+
+void HTTPRequest::WriteReply(int nStatus, std::shared_ptr<const std::string> body)
+{
+    assert(!replySent && req);
+    if (ShutdownRequested())
+    {
+        WriteHeader("Connection", "close");
+    }
+    struct evbuffer *evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (body && !body->empty())
+    {
+        // Buffer holds reference to body until data is written to socket
+        auto holder = new std::shared_ptr<const std::string>(std::move(body));
+        auto cleanup = [](const void*, size_t, void* arg) { delete static_cast<std::shared_ptr<const std::string>*>(arg); };
+        if (evbuffer_add_reference(evb, (*holder)->data(), (*holder)->size(), cleanup, holder) != 0)
+        {
+            evbuffer_add(evb, (*holder)->data(), (*holder)->size());
+            delete holder;
+        }
+    }
+    SendReply(nStatus);
+}
+
+void HTTPRequest::SendReply(int nStatus)
+{
     auto req_copy = req;
     auto *ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]
     {
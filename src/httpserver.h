@@ -9,6 +9,12 @@
 #include <cstdint>
 #include <functional>
 #include <future>
+#include <array>
+#include <deque>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <rpc/protocol.h> // For HTTP status codes
 #include <event2/thread.h>
 #include <event2/buffer.h>
@@ -20,18 +26,24 @@
 #include "init.h"
 #include "pocketdb/SQLiteConnection.h"
 #include <eventloop.h>
+#include <httpcompression.h>
 
 static const int DEFAULT_HTTP_THREADS = 4;
-static const int DEFAULT_HTTP_POST_THREADS = 4;
+static const int DEFAULT_HTTP_POOL_THREADS = 0;
+// Shares of public sockets in worker pool
+static const int DEFAULT_HTTP_POST_THREADS = 2;
 static const int DEFAULT_HTTP_PUBLIC_THREADS = 4;
-static const int DEFAULT_HTTP_STATIC_THREADS = 4;
-static const int DEFAULT_HTTP_REST_THREADS = 4;
+static const int DEFAULT_HTTP_STATIC_THREADS = 1;
+static const int DEFAULT_HTTP_REST_THREADS = 1;
 static const int DEFAULT_HTTP_WORKQUEUE = 16;
 static const int DEFAULT_HTTP_POST_WORKQUEUE = 16;
 static const int DEFAULT_HTTP_PUBLIC_WORKQUEUE = 16;
 static const int DEFAULT_HTTP_STATIC_WORKQUEUE = 16;
 static const int DEFAULT_HTTP_REST_WORKQUEUE = 16;
 static const int DEFAULT_HTTP_SERVER_TIMEOUT = 30;
+static const int DEFAULT_HTTP_QUEUE_DEADLINE = 10000;
+static const int DEFAULT_HTTP_HEAVY_METHOD_TIME = 100;
+static const int DEFAULT_HTTP_COMPRESS_MIN_SIZE = 1024;
 
 static const bool DEFAULT_API_ENABLE = true;
 static const bool DEFAULT_REST_ENABLE = false;
@@ -65,6 +77,8 @@ void StartHTTPServer();
 void InterruptHTTPServer();
 /** Stop HTTP server */
 void StopHTTPServer();
+/** Utilization of public sockets worker pool, null if server is not started */
+UniValue GetHTTPWorkerPoolStatistic();
 
 /** Change logging level for libevent. Removes BCLog::LIBEVENT from log categories if
  * libevent doesn't support debug logging.*/
@@ -89,6 +103,9 @@ private:
 
     DbConnectionRef dbConnection;
 
+    void SendReply(int nStatus);
+    void SendBody(int nStatus, const std::string& body);
+
 public:
     explicit HTTPRequest(struct evhttp_request* req, bool _replySent = false);
     ~HTTPRequest();
@@ -131,6 +148,11 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Copy beginning of request body without consuming it.
+     */
+    std::string PeekBody(size_t maxSize) const;
+
     /**
      * Write output header.
      *
@@ -148,6 +170,22 @@ public:
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
 
+    /**
+     * Encoding of reply with size negotiated with client, identity if reply is not worth compression.
+     */
+    HTTPEncoding GetReplyEncoding(size_t size) const;
+
+    /**
+     * Write HTTP reply with body already compressed with encoding.
+     */
+    void WriteEncodedReply(int nStatus, HTTPEncoding encoding, const std::string& body);
+
+    /**
+     * Write HTTP reply without copying the body.
+     * The body is referenced by libevent output buffer and released after it is sent.
+     */
+    void WriteReply(int nStatus, std::shared_ptr<const std::string> body);
+
     void SetDbConnection(const DbConnectionRef& _dbConnection);
 
     const DbConnectionRef& DbConnection() const;
@@ -159,6 +197,8 @@ class HTTPClosure
 {
 public:
     virtual void operator()(DbConnectionRef& sqliteConnection) = 0;
+    /** Called instead of execution when work queue drops the closure */
+    virtual void Shed(const std::string& reason) {}
     virtual ~HTTPClosure() {}
 };
 
@@ -226,11 +266,12 @@ private:
 class HTTPWorkItem final : public HTTPClosure
 {
 public:
-    HTTPWorkItem(std::shared_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler &_func) :
-        req(std::move(_req)), path(_path), func(_func)
+    /** Execution is recorded in request statistic with statKey if set,
+     * JSON-RPC handlers record their samples per method themselves */
+    HTTPWorkItem(std::shared_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler &_func,
+        const std::string& _statKey = "") :
+        req(std::move(_req)), path(_path), func(_func), statKey(_statKey)
     {
-        // log = LogInstance().WillLogCategory(BCLog::STAT);
-        // created = gStatEngineInstance.GetCurrentSystemTime();
     }
 
     void operator()(DbConnectionRef& dbConnection) override
@@ -238,29 +279,30 @@ public:
         auto jreq = req.get();
         jreq->SetDbConnection(dbConnection);
 
-        // auto uri = jreq->GetURI();
-        // auto peer = jreq->GetPeer().ToString().substr(0, jreq->GetPeer().ToString().find(':'));
-
-        // auto start = gStatEngineInstance.GetCurrentSystemTime();
-
-        func(jreq, path);
-
-        // auto stop = gStatEngineInstance.GetCurrentSystemTime();
-
-        // if (log)
-        // {
-        //     gStatEngineInstance.AddSample(
-        //         Statistic::RequestSample{
-        //             uri,
-        //             created,
-        //             stop,
-        //             finish,
-        //             peer,
-        //             0,
-        //             0
-        //         }
-        //     );
-        // }
+        auto start = gStatEngineInstance.GetCurrentSystemTime();
+
+        bool success = func(jreq, path);
+
+        if (!statKey.empty())
+        {
+            gStatEngineInstance.AddSample(
+                Statistic::RequestSample{
+                    statKey,
+                    jreq->Created,
+                    start,
+                    gStatEngineInstance.GetCurrentSystemTime(),
+                    jreq->GetPeer().ToStringIP(),
+                    !success,
+                    0,
+                    0
+                }
+            );
+        }
+    }
+
+    void Shed(const std::string& reason) override
+    {
+        req->WriteReply(HTTP_SERVICE_UNAVAILABLE, reason);
     }
 
     std::shared_ptr<HTTPRequest> req;
@@ -268,8 +310,160 @@ public:
 private:
     std::string path;
     HTTPRequestHandler func;
-    // bool log;
-    // Statistic::RequestTime created;
+    std::string statKey;
+};
+
+/** Prefix tree of registered path handlers.
+ * Lookup walks the URI once instead of comparing it with every handler prefix,
+ * the first-registered matching handler is returned as with linear scan.
+ */
+class HTTPPathTrie
+{
+public:
+    void Build(const std::vector<HTTPPathHandler>& handlers);
+    /** Index of the first-registered handler matching uri or -1 */
+    int Find(const std::string& uri) const;
+
+private:
+    struct Node
+    {
+        std::map<char, std::unique_ptr<Node>> children;
+        // Lowest index of prefix handler ending at this node
+        int prefixIndex = -1;
+        // Lowest index of exact match handler ending at this node
+        int exactIndex = -1;
+    };
+
+    Node m_root;
+};
+
+/** Execute elements of JSON-RPC batch in parallel on workers of queue.
+ * Helpers are queued only for idle pool workers and do not count in queue depth.
+ * Calling worker executes elements too, so batch completes even when all workers are busy
+ * or queue is full. Replies are placed in request order.
+ */
+std::string JSONRPCExecBatchParallel(const JSONRPCRequest& jreq, const UniValue& vReq, const CRPCTable& table,
+    const std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>>& queue);
+
+/** Lanes of work queue */
+enum class HTTPWorkLane
+{
+    Cheap = 0,
+    Heavy = 1,
+};
+
+/** Work queue with separate lanes for cheap and heavy requests and fair queuing of request sources.
+ * Workers take cheap requests several times more often than heavy ones, and sources of one lane in turn,
+ * so a storm of heavy requests from one client delays mostly this client.
+ * Requests waiting longer than deadline are shed. When queue is full, new request displaces
+ * the latest request of the source holding most of the queue instead of being rejected.
+ * Private socket puts all requests to one source without deadline, so its queue stays plain FIFO.
+ */
+class HTTPWorkQueue : public Queue<std::unique_ptr<HTTPClosure>>
+{
+public:
+    using Entry = std::unique_ptr<HTTPClosure>;
+
+    HTTPWorkQueue(size_t maxDepth, int64_t deadlineMillis);
+
+    bool GetNext(Entry& out, const condCheck& pre, const condCheck& post) override;
+    /** Take next request without waiting */
+    bool TryGetNext(Entry& out);
+    /** Add internal work to cheap lane, never displaces queued requests and is not limited by depth */
+    bool Add(Entry entry) override;
+    bool Add(Entry entry, HTTPWorkLane lane, const std::string& source);
+    void Interrupt() override;
+    size_t Size() override;
+
+    UniValue GetStatistic();
+
+    /** Called after every added request, for workers waiting on several queues */
+    void SetListener(std::function<void()> listener);
+
+private:
+    struct Item
+    {
+        Entry entry;
+        int64_t deadline;
+    };
+
+    struct Lane
+    {
+        std::map<std::string, std::deque<Item>> sources;
+        // Sources with queued items in order of service
+        std::deque<std::string> rotation;
+        size_t size = 0;
+    };
+
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::array<Lane, 2> m_lanes;
+    std::map<std::string, size_t> m_sourceSizes;
+    size_t m_size = 0;
+    size_t m_maxDepth;
+    int64_t m_deadlineMillis;
+    int m_cheapServed = 0;
+    std::function<void()> m_listener;
+
+    std::array<std::atomic<uint64_t>, 2> m_added{};
+    std::atomic<uint64_t> m_rejected{0};
+    std::atomic<uint64_t> m_displaced{0};
+    std::atomic<uint64_t> m_expired{0};
+
+    Item PopLocked();
+    bool PopReadyLocked(Entry& out, std::vector<Entry>& expired);
+    void ShedExpired(std::vector<Entry>& expired);
+    Entry DisplaceLocked(HTTPWorkLane lane, const std::string& source);
+};
+
+/** Worker threads shared by work queues of public sockets.
+ * Every worker has home queue assigned in proportion to queue weight and takes requests from it first.
+ * Idle worker steals from the queue with largest backlog by weight, so spare capacity of one socket
+ * serves saturated ones. Every worker has own db connection.
+ */
+class HTTPWorkerPool
+{
+public:
+    ~HTTPWorkerPool();
+
+    /** Register queue before Start */
+    void AddQueue(const std::string& name, std::shared_ptr<HTTPWorkQueue> queue, int weight);
+    void Start(int threadCount);
+    /** Stop and join all workers, queued requests are kept */
+    void Stop();
+
+    /** Workers waiting for requests */
+    int GetIdle();
+
+    /** Per queue share of workers time */
+    UniValue GetStatistic();
+
+private:
+    struct Member
+    {
+        std::string name;
+        std::shared_ptr<HTTPWorkQueue> queue;
+        int weight;
+        int homeWorkers = 0;
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> busyMicros{0};
+    };
+
+    std::vector<std::unique_ptr<Member>> m_members;
+    std::vector<std::thread> m_threads;
+    int64_t m_startMicros = 0;
+
+    Mutex m_mutex;
+    std::condition_variable m_cond;
+    bool m_running = false;
+    // Incremented on every added request - worker sleeps only if nothing was added since its last look
+    uint64_t m_signals = 0;
+    int m_idle = 0;
+
+    void Notify();
+    void Worker(size_t home);
+    bool Take(size_t home, std::unique_ptr<HTTPClosure>& entry, size_t& source);
 };
 
 class HTTPSocket
@@ -293,8 +487,9 @@ public:
     
     /** Work queue for handling longer requests off the event loop thread */
     CRPCTable m_table_rpc;
-    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> m_workQueue;
+    std::shared_ptr<HTTPWorkQueue> m_workQueue;
     std::vector<HTTPPathHandler> m_pathHandlers;
+    HTTPPathTrie m_pathTrie;
 
     /** Start worker threads to listen on bound http sockets */
     void StartHTTPSocket(int threadCount, bool selfDbConnection);
@@ -312,23 +507,24 @@ public:
      * be invoked.
      */
     void RegisterHTTPHandler(const std::string& prefix, bool exactMatch,
-        const HTTPRequestHandler& handler, std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> _queue);
+        const HTTPRequestHandler& handler, std::shared_ptr<HTTPWorkQueue> _queue);
 
     /** Unregister handler for prefix */
     void UnregisterHTTPHandler(const std::string& prefix, bool exactMatch);
 
-    bool HTTPReq(HTTPRequest* req, const util::Ref& context,  CRPCTable& table);
+    /** Batch elements are executed in parallel on workers of batchQueue if set */
+    bool HTTPReq(HTTPRequest* req, const util::Ref& context,  CRPCTable& table,
+        const std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>>& batchQueue = nullptr);
 };
 
 class HTTPWebSocket: public HTTPSocket
 {
 public:
     CRPCTable m_table_post_rpc;
-    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> m_workPostQueue;
+    std::shared_ptr<HTTPWorkQueue> m_workPostQueue;
 
     HTTPWebSocket(struct event_base* base, int timeout, int queueDepth, int queuePostDepth, bool publicAccess);
     ~HTTPWebSocket();
-    void StartHTTPSocket(int threadCount, int threadPostCount, bool selfDbConnection);
     void StopHTTPSocket();
     void InterruptHTTPSocket();
 };
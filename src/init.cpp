@@ -101,10 +101,11 @@
 static bool fFeeEstimatesInitialized = false;
 static const bool DEFAULT_PROXYRANDOMIZE = true;
 static const bool DEFAULT_STOPAFTERBLOCKIMPORT = false;
+static const int DEFAULT_WS_THREADS = 2;
 
 Statistic::RequestStatEngine gStatEngineInstance;
 
-std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections;
+std::shared_ptr<WSConnectionsRegistry> WSConnections;
 std::shared_ptr<QueueEventLoopThread<std::pair<CBlock, CBlockIndex*>>> notifyClientsThread;
 std::shared_ptr<Queue<std::pair<CBlock, CBlockIndex*>>> notifyClientsQueue;
 
@@ -632,6 +633,13 @@ void SetupServerArgs(NodeContext& node)
 
     argsman.AddArg("-static", strprintf("Accept public requests to static resources (default: %u)", DEFAULT_STATIC_ENABLE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-staticpath", "Path to static resources (default: GetDataDir()/wwwroot", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-searchmergepages=<n>", strprintf("Amount of work in pages for scheduled search index merge (default: %d)", 1000), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-webbatchblocks=<n>", strprintf("Maximum number of blocks processed at once by web tags and search workers (default: %d)", 100), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-eventsinboxdepth=<n>", strprintf("Number of last blocks kept in events inbox for notifications summary (default: %d)", 1440), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-notificationsdepth=<n>", strprintf("Number of last blocks with precalculated notifications for getnotifications (default: %d)", 100), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-staticcachesize=<n>", strprintf("Maximum amount of memory in megabytes for cached static resources (default: %d MB)", 128), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-staticcheckinterval=<n>", strprintf("Interval in seconds for checking cached static resources for changes on disk, -1 to disable (default: %d)", 5), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-staticmaxage=<n>", strprintf("Cache-Control max-age in seconds for static resources except html (default: %d)", 3600), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
 
     
     argsman.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
@@ -641,16 +649,18 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcport=<port>", strprintf("Listen for JSON-RPC connections on <port> (default: %u, testnet: %u, signet: %u, regtest: %u)", defaultBaseParams->RPCPort(), testnetBaseParams->RPCPort(), signetBaseParams->RPCPort(), regtestBaseParams->RPCPort()), ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-wsport=<port>", strprintf("Listen for WebSocket connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->WsPort(), testnetBaseParams->WsPort(), regtestBaseParams->WsPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-wsthreads=<n>", strprintf("Set the number of threads to service WebSocket connections (default: %d)", DEFAULT_WS_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-publicrpcport=<port>", strprintf("Listen for public JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->PublicRPCPort(), testnetBaseParams->PublicRPCPort(), regtestBaseParams->PublicRPCPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-staticrpcport=<port>", strprintf("Listen for static JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->StaticRPCPort(), testnetBaseParams->StaticRPCPort(), regtestBaseParams->StaticRPCPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-restport=<port>", strprintf("Listen for static REST connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->RestPort(), testnetBaseParams->RestPort(), regtestBaseParams->RestPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcserialversion", strprintf("Sets the serialization of raw transaction or block hex returned in non-verbose mode, non-segwit(0) or segwit(1) (default: %d)", DEFAULT_RPC_SERIALIZE_VERSION), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpcthreads=<n>", strprintf("Set the number of threads to service RPC (MAIN) calls (default: %d)", DEFAULT_HTTP_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
-    argsman.AddArg("-rpcpublicthreads=<n>", strprintf("Set the number of threads to service RPC (PUBLIC) calls (default: %d)", DEFAULT_HTTP_PUBLIC_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
-    argsman.AddArg("-rpcstaticthreads=<n>", strprintf("Set the number of threads to service RPC (STATIC) calls (default: %d)", DEFAULT_HTTP_STATIC_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
-    argsman.AddArg("-rpcpostthreads=<n>", strprintf("Set the number of threads to service RPC (POST) calls (default: %d)", DEFAULT_HTTP_POST_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
-    argsman.AddArg("-rpcrestthreads=<n>", strprintf("Set the number of threads to service RPC (REST) calls (default: %d)", DEFAULT_HTTP_REST_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcpoolthreads=<n>", strprintf("Set the number of threads shared by PUBLIC, POST, STATIC and REST calls, 0 for twice the number of cores. If not set while any of deprecated -rpcpublicthreads, -rpcpostthreads, -rpcstaticthreads, -rpcrestthreads is set, their sum is used (default: %d)", DEFAULT_HTTP_POOL_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcpublicthreads=<n>", strprintf("Set the share of pool threads servicing RPC (PUBLIC) calls first (default: %d)", DEFAULT_HTTP_PUBLIC_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcstaticthreads=<n>", strprintf("Set the share of pool threads servicing RPC (STATIC) calls first (default: %d)", DEFAULT_HTTP_STATIC_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcpostthreads=<n>", strprintf("Set the share of pool threads servicing RPC (POST) calls first (default: %d)", DEFAULT_HTTP_POST_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcrestthreads=<n>", strprintf("Set the share of pool threads servicing RPC (REST) calls first (default: %d)", DEFAULT_HTTP_REST_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
 
     argsman.AddArg("-rpcuser=<user>", "Username for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     argsman.AddArg("-rpcwhitelist=<whitelist>", "Set a whitelist to filter incoming RPC calls for a specific user. The field <whitelist> comes in the format: <USERNAME>:<rpc 1>,<rpc 2>,...,<rpc n>. If multiple whitelists are set for a given user, they are set-intersected. See -rpcwhitelistdefault documentation for information on default whitelist behavior.", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
@@ -660,6 +670,9 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rpcstaticworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC (STATIC) calls (default: %d)", DEFAULT_HTTP_STATIC_WORKQUEUE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcpostworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC (POST) calls (default: %d)", DEFAULT_HTTP_POST_WORKQUEUE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcrestworkqueue=<n>", strprintf("Set the depth of the work queue to service RPC (REST) calls (default: %d)", DEFAULT_HTTP_REST_WORKQUEUE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcqueuedeadline=<n>", strprintf("Maximum time in milliseconds a request of public sockets waits in work queue before it is rejected, 0 to disable (default: %d)", DEFAULT_HTTP_QUEUE_DEADLINE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcheavymethodtime=<n>", strprintf("Average execution time in milliseconds from which requests of JSON-RPC method, REST or static path prefix are queued after cheap ones, 0 to disable (default: %d)", DEFAULT_HTTP_HEAVY_METHOD_TIME), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpccompressminsize=<n>", strprintf("Minimum size in bytes of replies compressed for clients accepting gzip or deflate, 0 to disable (default: %d)", DEFAULT_HTTP_COMPRESS_MIN_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpccachesize=<n>", strprintf("Maximum amount of memory in megabytes allowed for RPCcache usage (default: %d MB)", 64), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-server", "Accept command line and JSON-RPC commands", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
 
@@ -667,6 +680,10 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-sqltimeout", strprintf("Timeout for ReadOnly sql querys (default: %ds)", 10), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqlsharedcache", strprintf("Experimental: enable shared cache for sqlite connections (default: disabled)"), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqlcachesize", strprintf("Experimental: Cache size for SQLite connection in megabytes (default: %d mb)", 5), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-accountcachesize=<n>", strprintf("Maximum number of accounts in current account state cache (default: %d)", 100000), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-contentcachesize=<n>", strprintf("Maximum amount of memory in megabytes for contents and profiles of web responses (default: %d MB)", 64), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-profilebatchwindow=<n>", strprintf("Time in milliseconds to collect concurrent account profile requests into one query, 0 to disable (default: %d)", 2), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-likerscachesize=<n>", strprintf("Maximum amount of memory in megabytes for in-memory likers index (default: %d MB)", 64), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-withoutweb", strprintf("Disable WEB part of database (default: %u)", false), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
 
 
@@ -881,38 +898,41 @@ static void ThreadImport(ChainstateManager& chainman, const util::Ref& context,
             LogPrintf("Building a Web database: 0%%\n");
 
             int i = 0;
-            int percent = ChainActive().Height() / 100;
+            int top = ChainActive().Height();
+            int percent = std::max(1, top / 100);
+            int batch = (int) std::max((int64_t) 1, args.GetArg("-webbatchblocks", 100));
             int64_t startTime = GetTimeMicros();
-            while (i <= ChainActive().Height() && !ShutdownRequested())
+            while (i <= top && !ShutdownRequested())
             {
-                CBlockIndex* pblockindex = ChainActive()[i];
-                if (!pblockindex)
-                {
-                    LogPrintf("ERROR: Block not found in chainActive[%d]\n", i);
-                    StartShutdown();
-                    break;
-                }
+                // Web data is built from actual transactions versions by heights ranges
+                int last = std::min(top, i + batch - 1);
 
                 try
                 {
-                    PocketServices::WebPostProcessorInst.ProcessTags(pblockindex->GetBlockHash().GetHex());
-                    PocketServices::WebPostProcessorInst.ProcessSearchContent(pblockindex->GetBlockHash().GetHex());
+                    PocketServices::WebPostProcessorInst.ProcessTags(i, last);
+                    PocketServices::WebPostProcessorInst.SetProcessed(PocketServices::WebStageTags, last);
+                    PocketServices::WebPostProcessorInst.ProcessSearchContent(i, last);
+                    PocketServices::WebPostProcessorInst.SetProcessed(PocketServices::WebStageSearch, last);
                 }
                 catch (std::exception& ex)
                 {
-                    LogPrintf("ERROR: Process web db building failed - block:%s height:%d what:%s\n", pblockindex->GetBlockHash().GetHex(), pblockindex->nHeight, ex.what());
+                    LogPrintf("ERROR: Process web db building failed - heights:%d-%d what:%s\n", i, last, ex.what());
                     StartShutdown();
                     break;
                 }
 
-                if (i % percent == 0)
+                if (i / percent != (last + 1) / percent)
                 {
                     int64_t time = GetTimeMicros();
-                    LogPrintf("Building a Web database: %d%% (%.2fm)\n", (i / percent), (0.000001 * (time - startTime)) / 60.0);
+                    LogPrintf("Building a Web database: %d%% (%.2fm)\n", ((last + 1) / percent), (0.000001 * (time - startTime)) / 60.0);
                 }
 
-                i += 1;
+                i = last + 1;
             }
+
+            // Compact search index after bulk load
+            if (!ShutdownRequested())
+                PocketServices::WebPostProcessorInst.OptimizeSearchContent(true);
         }
 
         BlockValidationState state;
@@ -1460,6 +1480,7 @@ static void StartWS()
 {
     WsServer server;
     server.config.port = gArgs.GetArg("-wsport", BaseParams().WsPort());
+    server.config.thread_pool_size = std::max(1, (int) gArgs.GetArg("-wsthreads", DEFAULT_WS_THREADS));
 
     auto& ws = server.endpoint["^/ws/?$"];
     ws.on_message = [](std::shared_ptr<WsServer::Connection> connection,
@@ -1542,7 +1563,7 @@ static void StartWS()
 
 static void InitWS()
 {
-    WSConnections = std::make_shared<ProtectedMap<std::string, WSUser>>();
+    WSConnections = std::make_shared<WSConnectionsRegistry>();
     auto notifyProcessor = std::make_shared<NotifyBlockProcessor>(WSConnections);
     notifyClientsQueue = std::make_shared<Queue<std::pair<CBlock, CBlockIndex*>>>();
     notifyClientsThread = std::make_shared<QueueEventLoopThread<std::pair<CBlock, CBlockIndex*>>>(notifyClientsQueue, notifyProcessor);
@@ -1669,6 +1690,21 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
     if (args.GetArg("-reindex", 0) == 4)
         PocketDb::SQLiteDbInst.RebuildIndexes();
 
+    // Content counters are filled once after migration and then maintained by chain indexing.
+    // Built in background - contents without counters are calculated on the fly until then.
+    threadGroup.create_thread([] {
+        TraceThread("contentstats", [] {
+            try
+            {
+                PocketDb::ChainRepoInst.BuildContentStats();
+            }
+            catch (const std::exception& e)
+            {
+                LogPrintf("Failed build content counters: %s\n", e.what());
+            }
+        });
+    });
+
     // ********************************************************* Step 4b: Start servers
 
     GetMainSignals().RegisterBackgroundSignalScheduler(*node.scheduler);
@@ -232,9 +232,10 @@ void BlockAssembler::onlyUnconfirmed(CTxMemPool::setEntries& testSet)
     }
 }
 
-bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef& pblockTemplate, PocketBlockRef& pblock)
+bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketConsensus::BlockTemplateContext& pocketTemplate)
 {
-    auto ptx = PocketDb::TransRepoInst.Get(tx->GetHash().GetHex(), true);
+    // Check consensus - payload and result are cached between templates
+    auto[ptx, ok, result] = PocketConsensus::BlockTemplatePayloadsInst.GetChecked(tx, ChainActive().Height() + 1);
 
     // Payload should be in operative table Transactions
     if (!ptx)
@@ -245,8 +246,7 @@ bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef&
         return false;
     }
 
-    // Check consensus
-    if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Check(tx, ptx, ChainActive().Height() + 1); !ok)
+    if (!ok)
     {
         LogPrint(BCLog::CONSENSUS, "Warning: build block skip transaction %s with check result %d\n",
             tx->GetHash().GetHex(), (int) result);
@@ -254,8 +254,9 @@ bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef&
         return false;
     }
 
-    // Validate consensus
-    if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Validate(tx, ptx, pblockTemplate, ChainActive().Height() + 1); !ok)
+    // Validate consensus only with template transactions related to this one
+    auto related = pocketTemplate.Related(ptx);
+    if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Validate(tx, ptx, related, ChainActive().Height() + 1); !ok)
     {
         LogPrint(BCLog::CONSENSUS, "Warning: build block skip transaction %s with validate result %d\n",
             tx->GetHash().GetHex(), (int) result);
@@ -264,8 +265,7 @@ bool BlockAssembler::TestTransaction(const CTransactionRef& tx, PocketBlockRef&
     }
 
     // All is good - save for descendants
-    pblockTemplate->push_back(ptx);
-    pblock->push_back(ptx);
+    pocketTemplate.Append(ptx);
     return true;
 }
 
@@ -411,6 +411,10 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
     const int64_t MAX_CONSECUTIVE_FAILURES = 1000;
     int64_t nConsecutiveFailed = 0;
 
+    // Pocketnet part of template with indexes for consensus validation
+    PocketConsensus::BlockTemplatePayloadsInst.NewTemplate();
+    PocketConsensus::BlockTemplateContext pocketTemplate(pblocktemplate->pocketBlock);
+
     while (mi != m_mempool.mapTx.get<ancestor_score>().end() || !mapModifiedTx.empty())
     {
         // First try to find a new transaction in mapTx to evaluate.
@@ -526,16 +530,15 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
         // Test pocketnet part for all ancestors
         bool testPocketnetPart = true;
 
-        // Temporary pocketblock object for test all transactions
-        PocketBlockRef pblock = make_shared<PocketBlock>(PocketBlock{});
-        PocketBlockRef pblockTemplate = make_shared<PocketBlock>(PocketBlock{});
-        for (const auto& it : *pblocktemplate->pocketBlock)
-            pblockTemplate->push_back(it);
+        // Package transactions are appended to template and rolled back if any of them fails
+        size_t pocketTemplateSize = pocketTemplate.Size();
 
         for (CTxMemPool::txiter it : sortedEntries)
         {
-            if (!TestTransaction(it->GetSharedTx(), pblockTemplate, pblock))
+            if (!TestTransaction(it->GetSharedTx(), pocketTemplate))
             {
+                pocketTemplate.Rollback(pocketTemplateSize);
+
                 if (fUsingModified)
                 {
                     mapModifiedTx.get<ancestor_score>().erase(modit);
@@ -548,10 +551,6 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
         }
         if (!testPocketnetPart)
             continue;
-        
-        // Move tested pocketnet transactions to template block
-        for (const auto& it : *pblock)
-            pblocktemplate->pocketBlock->push_back(it);
 
         // This transaction will make it in; reset the failed counter.
         nConsecutiveFailed = 0;
@@ -18,6 +18,7 @@
 
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/consensus/Helper.h"
+#include "pocketdb/consensus/BlockTemplate.h"
 
 using namespace PocketHelpers;
 
@@ -185,8 +186,8 @@ private:
     /** Remove confirmed (inBlock) entries from given set */
     void onlyUnconfirmed(CTxMemPool::setEntries& testSet);
 
-    // Check transaction with AntiBot
-    bool TestTransaction(const CTransactionRef& tx, PocketBlockRef& pblockTemplate, PocketBlockRef& pblock);
+    // Check transaction with AntiBot and append it to pocketnet part of template
+    bool TestTransaction(const CTransactionRef& tx, PocketConsensus::BlockTemplateContext& pocketTemplate);
 
     /** Test if a new package would "fit" in the block */
     bool TestPackage(uint64_t packageSize, int64_t packageSigOpsCost) const;
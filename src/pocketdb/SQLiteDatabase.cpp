@@ -65,6 +65,10 @@ namespace PocketDb
         SystemRepoInst.Init();
         MigrationRepoInst.Init();
 
+        AccountStateCacheInst.Init();
+        WebContentCacheInst.Init();
+        AccountProfileLoaderInst.Init();
+
         // Execute migration scripts
         if (gArgs.GetArg("-reindex", 0) == 0)
         {
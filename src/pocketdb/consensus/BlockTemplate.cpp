@@ -0,0 +1,175 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/BlockTemplate.h"
+#include "pocketdb/consensus/Helper.h"
+#include "pocketdb/pocketnet.h"
+
+#include <algorithm>
+
+namespace PocketConsensus
+{
+    BlockTemplatePayloads BlockTemplatePayloadsInst;
+
+    BlockTemplateContext::BlockTemplateContext(PocketBlockRef block) : m_block(std::move(block))
+    {
+        auto txs = std::move(*m_block);
+        m_block->clear();
+
+        for (const auto& ptx : txs)
+            Append(ptx);
+    }
+
+    bool BlockTemplateContext::IsAccount(const PTransactionRef& ptx)
+    {
+        return ptx->GetType() && TransactionHelper::IsIn(*ptx->GetType(), { ACCOUNT_USER, ACCOUNT_DELETE });
+    }
+
+    void BlockTemplateContext::Index(unordered_map<string, vector<size_t>>& index, const optional<string>& key, size_t position)
+    {
+        if (key && !key->empty())
+            index[*key].push_back(position);
+    }
+
+    void BlockTemplateContext::Unindex(unordered_map<string, vector<size_t>>& index, const optional<string>& key, size_t position)
+    {
+        if (!key || key->empty())
+            return;
+
+        auto it = index.find(*key);
+        if (it == index.end())
+            return;
+
+        // Positions are appended in order - rolled back transaction is always the last one
+        if (!it->second.empty() && it->second.back() == position)
+            it->second.pop_back();
+
+        if (it->second.empty())
+            index.erase(it);
+    }
+
+    void BlockTemplateContext::Append(const PTransactionRef& ptx)
+    {
+        size_t position = m_block->size();
+        m_block->push_back(ptx);
+
+        Index(m_byString1, ptx->GetString1(), position);
+        Index(m_byString2, ptx->GetString2(), position);
+
+        if (IsAccount(ptx))
+        {
+            Index(m_accountsByAddress, ptx->GetString1(), position);
+            m_accounts.push_back(position);
+        }
+    }
+
+    void BlockTemplateContext::Rollback(size_t size)
+    {
+        while (m_block->size() > size)
+        {
+            size_t position = m_block->size() - 1;
+            const auto& ptx = m_block->back();
+
+            Unindex(m_byString1, ptx->GetString1(), position);
+            Unindex(m_byString2, ptx->GetString2(), position);
+
+            if (IsAccount(ptx))
+            {
+                Unindex(m_accountsByAddress, ptx->GetString1(), position);
+                m_accounts.pop_back();
+            }
+
+            m_block->pop_back();
+        }
+    }
+
+    PocketBlockRef BlockTemplateContext::Related(const PTransactionRef& ptx) const
+    {
+        vector<size_t> positions;
+
+        auto collect = [&](const unordered_map<string, vector<size_t>>& index, const optional<string>& key)
+        {
+            if (!key || key->empty())
+                return;
+
+            if (auto it = index.find(*key); it != index.end())
+                positions.insert(positions.end(), it->second.begin(), it->second.end());
+        };
+
+        collect(m_byString1, ptx->GetString1());
+        collect(m_byString2, ptx->GetString2());
+
+        for (const auto& value : { ptx->GetString1(), ptx->GetString2(), ptx->GetString3(), ptx->GetString4(), ptx->GetString5() })
+            collect(m_accountsByAddress, value);
+
+        if (IsAccount(ptx) || (ptx->GetType() && TransactionHelper::IsIn(*ptx->GetType(), { ACTION_BLOCKING, ACTION_BLOCKING_CANCEL })))
+            positions.insert(positions.end(), m_accounts.begin(), m_accounts.end());
+
+        sort(positions.begin(), positions.end());
+        positions.erase(unique(positions.begin(), positions.end()), positions.end());
+
+        auto related = make_shared<PocketBlock>();
+        related->reserve(positions.size());
+        for (auto position : positions)
+            related->push_back((*m_block)[position]);
+
+        return related;
+    }
+
+    void BlockTemplatePayloads::NewTemplate()
+    {
+        LOCK(m_mutex);
+
+        m_generation++;
+
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (it->second.Generation + 1 < m_generation)
+                it = m_entries.erase(it);
+            else
+                it++;
+        }
+    }
+
+    tuple<PTransactionRef, bool, SocialConsensusResult> BlockTemplatePayloads::GetChecked(const CTransactionRef& tx, int height)
+    {
+        auto txHash = tx->GetHash().GetHex();
+
+        {
+            LOCK(m_mutex);
+
+            auto it = m_entries.find(txHash);
+            if (it != m_entries.end() && it->second.CheckHeight == height)
+            {
+                it->second.Generation = m_generation;
+                return { it->second.Ptx, it->second.CheckOk, it->second.CheckResult };
+            }
+        }
+
+        auto ptx = PocketDb::MempoolPayloadsInst.Get(txHash);
+        if (!ptx)
+            ptx = PocketDb::TransRepoInst.Get(txHash, true);
+        if (!ptx)
+            return { nullptr, false, SocialConsensusResult_NotFound };
+
+        auto[ok, result] = SocialConsensusHelper::Check(tx, ptx, height);
+
+        LOCK(m_mutex);
+
+        auto& entry = m_entries[txHash];
+        entry.Ptx = ptx;
+        entry.CheckHeight = height;
+        entry.CheckOk = ok;
+        entry.CheckResult = result;
+        entry.Generation = m_generation;
+
+        return { ptx, ok, result };
+    }
+
+    size_t BlockTemplatePayloads::Size()
+    {
+        LOCK(m_mutex);
+        return m_entries.size();
+    }
+}
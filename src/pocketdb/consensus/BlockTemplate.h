@@ -0,0 +1,87 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_BLOCKTEMPLATE_H
+#define POCKETCONSENSUS_BLOCKTEMPLATE_H
+
+#include <unordered_map>
+
+#include "sync.h"
+#include "primitives/transaction.h"
+#include "pocketdb/helpers/TransactionHelper.h"
+#include "pocketdb/models/base/Transaction.h"
+#include "pocketdb/consensus/Base.h"
+
+namespace PocketConsensus
+{
+    using namespace std;
+    using namespace PocketTx;
+    using namespace PocketHelpers;
+
+    // Pocket part of block template under construction.
+    // Transactions of candidate package are appended one by one and rolled back if package fails.
+    // Indexes give consensus rules of next candidate only template transactions they can compare with.
+    class BlockTemplateContext
+    {
+    public:
+        explicit BlockTemplateContext(PocketBlockRef block);
+
+        const PocketBlockRef& Block() const { return m_block; }
+        size_t Size() const { return m_block->size(); }
+
+        void Append(const PTransactionRef& ptx);
+        // Drop transactions appended after template had size
+        void Rollback(size_t size);
+
+        // Template transactions in template order sharing String1 or String2 with ptx and account
+        // transactions of any ptx string value (registration checks). All accounts are added for account ptx
+        // (names checks) and blockings with addresses list in payload.
+        // Every ValidateBlock rule compares ptx only with transactions of these kinds.
+        PocketBlockRef Related(const PTransactionRef& ptx) const;
+
+    private:
+        PocketBlockRef m_block;
+
+        unordered_map<string, vector<size_t>> m_byString1;
+        unordered_map<string, vector<size_t>> m_byString2;
+        unordered_map<string, vector<size_t>> m_accountsByAddress;
+        vector<size_t> m_accounts;
+
+        static bool IsAccount(const PTransactionRef& ptx);
+        static void Index(unordered_map<string, vector<size_t>>& index, const optional<string>& key, size_t position);
+        static void Unindex(unordered_map<string, vector<size_t>>& index, const optional<string>& key, size_t position);
+    };
+
+    // Payloads of mempool transactions with context-free check results shared between block templates.
+    // Entries not requested by two last templates are dropped - mined and evicted transactions leave cache.
+    class BlockTemplatePayloads
+    {
+    public:
+        // Start next template and prune stale entries
+        void NewTemplate();
+
+        // Payload from mempool or Transactions table checked for height, nullptr if payload not found
+        tuple<PTransactionRef, bool, SocialConsensusResult> GetChecked(const CTransactionRef& tx, int height);
+
+        size_t Size();
+
+    private:
+        struct PayloadEntry
+        {
+            PTransactionRef Ptx;
+            int CheckHeight = -1;
+            bool CheckOk = false;
+            SocialConsensusResult CheckResult = SocialConsensusResult_Success;
+            uint64_t Generation = 0;
+        };
+
+        Mutex m_mutex;
+        unordered_map<string, PayloadEntry> m_entries;
+        uint64_t m_generation = 0;
+    };
+
+    extern BlockTemplatePayloads BlockTemplatePayloadsInst;
+}
+
+#endif // POCKETCONSENSUS_BLOCKTEMPLATE_H
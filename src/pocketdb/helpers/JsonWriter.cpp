@@ -0,0 +1,441 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/helpers/JsonWriter.h"
+
+#include <random>
+
+namespace PocketHelpers
+{
+    static const int MAX_JSON_DEPTH = 512;
+
+    JsonWriter::JsonWriter(size_t reserve)
+    {
+        m_buffer.reserve(reserve);
+    }
+
+    void JsonWriter::Separate()
+    {
+        if (m_afterKey)
+        {
+            m_afterKey = false;
+            return;
+        }
+
+        if (m_first.empty())
+            return;
+
+        if (!m_first.back())
+            m_buffer += ',';
+
+        m_first.back() = false;
+    }
+
+    void JsonWriter::Escape(const string& value)
+    {
+        static const char* hex = "0123456789abcdef";
+
+        m_buffer += '"';
+        for (unsigned char ch : value)
+        {
+            switch (ch)
+            {
+                case '"': m_buffer += "\\\""; break;
+                case '\\': m_buffer += "\\\\"; break;
+                case '\b': m_buffer += "\\b"; break;
+                case '\f': m_buffer += "\\f"; break;
+                case '\n': m_buffer += "\\n"; break;
+                case '\r': m_buffer += "\\r"; break;
+                case '\t': m_buffer += "\\t"; break;
+                default:
+                    if (ch < 0x20 || ch == 0x7f)
+                    {
+                        m_buffer += "\\u00";
+                        m_buffer += hex[ch >> 4];
+                        m_buffer += hex[ch & 0xf];
+                    }
+                    else
+                    {
+                        m_buffer += (char) ch;
+                    }
+            }
+        }
+        m_buffer += '"';
+    }
+
+    JsonWriter& JsonWriter::BeginObject()
+    {
+        Separate();
+        m_buffer += '{';
+        m_first.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::EndObject()
+    {
+        m_buffer += '}';
+        m_first.pop_back();
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::BeginArray()
+    {
+        Separate();
+        m_buffer += '[';
+        m_first.push_back(true);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::EndArray()
+    {
+        m_buffer += ']';
+        m_first.pop_back();
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Key(const string& key)
+    {
+        Separate();
+        Escape(key);
+        m_buffer += ':';
+        m_afterKey = true;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::String(const string& value)
+    {
+        Separate();
+        Escape(value);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Int(int64_t value)
+    {
+        Separate();
+        m_buffer += std::to_string(value);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Bool(bool value)
+    {
+        Separate();
+        m_buffer += value ? "true" : "false";
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Null()
+    {
+        Separate();
+        m_buffer += "null";
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Json(const string& value)
+    {
+        if (!IsValid(value))
+            return Null();
+
+        Separate();
+        m_buffer += value;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Value(const UniValue& value)
+    {
+        if (auto written = GetWritten(value))
+            return Raw(*written);
+
+        switch (value.getType())
+        {
+            case UniValue::VOBJ:
+            {
+                BeginObject();
+                const auto& keys = value.getKeys();
+                const auto& values = value.getValues();
+                for (size_t i = 0; i < keys.size(); i++)
+                    Key(keys[i]).Value(values[i]);
+                return EndObject();
+            }
+            case UniValue::VARR:
+            {
+                BeginArray();
+                for (const auto& item : value.getValues())
+                    Value(item);
+                return EndArray();
+            }
+            case UniValue::VSTR:
+                return String(value.get_str());
+            case UniValue::VNUM:
+                return Raw(value.getValStr());
+            case UniValue::VBOOL:
+                return Bool(value.get_bool());
+            default:
+                return Null();
+        }
+    }
+
+    JsonWriter& JsonWriter::Raw(const string& value)
+    {
+        Separate();
+        m_buffer += value;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Members(const string& members)
+    {
+        if (members.empty())
+            return *this;
+
+        if (!m_first.back())
+            m_buffer += ',';
+
+        m_first.back() = false;
+        m_buffer += members;
+        return *this;
+    }
+
+    // Reserved key is random per process - clients can't build object that would be spliced
+    static const string& WrittenKey()
+    {
+        static const string key = []()
+        {
+            std::random_device device;
+            string result("\0json:", 6);
+            for (int i = 0; i < 4; i++)
+                result += std::to_string(device());
+            return result;
+        }();
+
+        return key;
+    }
+
+    UniValue JsonWriter::ToUniValue() const
+    {
+        UniValue result(UniValue::VOBJ);
+        result.pushKV(WrittenKey(), m_buffer);
+        return result;
+    }
+
+    const string* JsonWriter::GetWritten(const UniValue& value)
+    {
+        if (!value.isObject() || value.size() != 1 || value.getKeys()[0] != WrittenKey())
+            return nullptr;
+
+        const auto& written = value.getValues()[0];
+        return written.isStr() ? &written.get_str() : nullptr;
+    }
+
+    string JsonWriter::Write(const UniValue& value)
+    {
+        JsonWriter writer;
+        writer.Value(value);
+        return writer.m_buffer;
+    }
+
+    // --------------------------------
+    // Validation without building values
+    // --------------------------------
+
+    static void SkipSpaces(const char*& p, const char* end)
+    {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r'))
+            p++;
+    }
+
+    static bool IsHex(char c)
+    {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    static bool ValidString(const char*& p, const char* end)
+    {
+        // Opening quote
+        p++;
+
+        while (p < end)
+        {
+            auto c = (unsigned char) *p;
+
+            if (c == '"')
+            {
+                p++;
+                return true;
+            }
+
+            if (c < 0x20)
+                return false;
+
+            if (c == '\\')
+            {
+                if (++p >= end)
+                    return false;
+
+                switch (*p)
+                {
+                    case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                        p++;
+                        break;
+                    case 'u':
+                        if (end - p < 5 || !IsHex(p[1]) || !IsHex(p[2]) || !IsHex(p[3]) || !IsHex(p[4]))
+                            return false;
+                        p += 5;
+                        break;
+                    default:
+                        return false;
+                }
+
+                continue;
+            }
+
+            // Multibyte UTF-8 sequence - univalue rejects invalid ones
+            int tail = 0;
+            if (c >= 0x80)
+            {
+                if ((c & 0xe0) == 0xc0 && c >= 0xc2) tail = 1;
+                else if ((c & 0xf0) == 0xe0) tail = 2;
+                else if ((c & 0xf8) == 0xf0 && c <= 0xf4) tail = 3;
+                else return false;
+
+                if (end - p <= tail)
+                    return false;
+
+                for (int i = 1; i <= tail; i++)
+                    if ((p[i] & 0xc0) != 0x80)
+                        return false;
+            }
+
+            p += tail + 1;
+        }
+
+        return false;
+    }
+
+    static bool ValidNumber(const char*& p, const char* end)
+    {
+        auto digits = [&]()
+        {
+            auto start = p;
+            while (p < end && *p >= '0' && *p <= '9')
+                p++;
+            return p > start;
+        };
+
+        if (*p == '-')
+            p++;
+
+        if (p < end && *p == '0')
+            p++;
+        else if (!digits())
+            return false;
+
+        if (p < end && *p == '.')
+        {
+            p++;
+            if (!digits())
+                return false;
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E'))
+        {
+            p++;
+            if (p < end && (*p == '+' || *p == '-'))
+                p++;
+            if (!digits())
+                return false;
+        }
+
+        return true;
+    }
+
+    static bool ValidLiteral(const char*& p, const char* end, const char* literal, size_t size)
+    {
+        if ((size_t) (end - p) < size || string(p, size) != literal)
+            return false;
+
+        p += size;
+        return true;
+    }
+
+    static bool ValidValue(const char*& p, const char* end, int depth)
+    {
+        SkipSpaces(p, end);
+        if (p >= end || depth > MAX_JSON_DEPTH)
+            return false;
+
+        switch (*p)
+        {
+            case '"':
+                return ValidString(p, end);
+            case 't':
+                return ValidLiteral(p, end, "true", 4);
+            case 'f':
+                return ValidLiteral(p, end, "false", 5);
+            case 'n':
+                return ValidLiteral(p, end, "null", 4);
+            case '[':
+            case '{':
+            {
+                bool isObject = (*p == '{');
+                char close = isObject ? '}' : ']';
+                p++;
+
+                SkipSpaces(p, end);
+                if (p < end && *p == close)
+                {
+                    p++;
+                    return true;
+                }
+
+                while (true)
+                {
+                    if (isObject)
+                    {
+                        SkipSpaces(p, end);
+                        if (p >= end || *p != '"' || !ValidString(p, end))
+                            return false;
+
+                        SkipSpaces(p, end);
+                        if (p >= end || *p != ':')
+                            return false;
+                        p++;
+                    }
+
+                    if (!ValidValue(p, end, depth + 1))
+                        return false;
+
+                    SkipSpaces(p, end);
+                    if (p >= end)
+                        return false;
+
+                    if (*p == close)
+                    {
+                        p++;
+                        return true;
+                    }
+
+                    if (*p != ',')
+                        return false;
+                    p++;
+                }
+            }
+            default:
+                if (*p == '-' || (*p >= '0' && *p <= '9'))
+                    return ValidNumber(p, end);
+
+                return false;
+        }
+    }
+
+    bool JsonWriter::IsValid(const string& json)
+    {
+        const char* p = json.data();
+        const char* end = p + json.size();
+
+        if (!ValidValue(p, end, 0))
+            return false;
+
+        SkipSpaces(p, end);
+        return p == end;
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETHELPERS_JSONWRITER_H
+#define POCKETHELPERS_JSONWRITER_H
+
+#include <string>
+#include <vector>
+#include <univalue.h>
+
+namespace PocketHelpers
+{
+    using namespace std;
+
+    // Writes JSON directly into one output buffer without building UniValue tree.
+    // Separators are placed automatically: object members are written as Key(...) followed by value.
+    // JSON stored in db (tags, images, settings) is spliced verbatim with Json(...).
+    class JsonWriter
+    {
+    public:
+        explicit JsonWriter(size_t reserve = 0);
+
+        JsonWriter& BeginObject();
+        JsonWriter& EndObject();
+        JsonWriter& BeginArray();
+        JsonWriter& EndArray();
+
+        JsonWriter& Key(const string& key);
+
+        JsonWriter& String(const string& value);
+        JsonWriter& Int(int64_t value);
+        JsonWriter& Bool(bool value);
+        JsonWriter& Null();
+        // Ready JSON value written as is, null if value is not valid JSON
+        JsonWriter& Json(const string& value);
+        // Univalue tree written the same way as univalue does, values from ToUniValue are spliced
+        JsonWriter& Value(const UniValue& value);
+        // Value serialized before by JsonWriter or UniValue, written as is without validation
+        JsonWriter& Raw(const string& value);
+        // Members of object serialized before by JsonWriter, appended to currently open object
+        JsonWriter& Members(const string& members);
+
+        const string& Buffer() const { return m_buffer; }
+
+        // Result for RPC reply - object with reserved key carries written JSON through univalue tree,
+        // RPC layer writes reply with Write() and splices it without parsing
+        UniValue ToUniValue() const;
+        // JSON carried by value from ToUniValue, nullptr for other values
+        static const string* GetWritten(const UniValue& value);
+        // JSON of univalue tree, values from ToUniValue are spliced as is
+        static string Write(const UniValue& value);
+
+        static bool IsValid(const string& json);
+
+    private:
+        string m_buffer;
+        // Nothing written yet on every open level
+        vector<bool> m_first;
+        bool m_afterKey = false;
+
+        void Separate();
+        void Escape(const string& value);
+    };
+}
+
+#endif // POCKETHELPERS_JSONWRITER_H
@@ -80,6 +80,13 @@ void PocketHelpers::NotificationsResult::InsertData(const PocketDb::ShortForm& s
     m_data.emplace_back(shortForm.Serialize(false));
 }
 
+void PocketHelpers::NotificationsResult::InsertData(const int64_t& blocknum, const UniValue& data)
+{
+    if (HasData(blocknum)) return;
+    m_txArrIndicies.insert({blocknum, m_data.size()});
+    m_data.emplace_back(data);
+}
+
 void PocketHelpers::NotificationsResult::InsertNotifiers(const int64_t& blocknum, PocketDb::ShortTxType contextType, std::map<std::string, std::optional<PocketDb::ShortAccount>> addresses)
 {
     for (const auto& address: addresses) {
@@ -283,15 +290,34 @@ void PocketHelpers::NotificationsReconstructor::FeedRow(sqlite3_stmt* stmt)
 
     auto blockNum = m_parser.ParseBlockNum(stmt); // blocknum is a unique key of tx because we are looking for txs in a single block
     // Do not perform parsing sql if we already has this tx
-    if (!m_notifications.HasData(blockNum)) {
-        m_notifications.InsertData(m_parser.ParseFull(stmt));
+    auto& data = m_data[blockNum];
+    if (!data) {
+        data = std::make_shared<const UniValue>(m_parser.ParseFull(stmt).Serialize(false));
     }
-    m_notifications.InsertNotifiers(blockNum, m_parser.ParseType(stmt), std::move(notifiers));
+    m_records[m_parser.ParseType(stmt)].push_back({blockNum, data, std::move(notifiers)});
 }
 
 PocketHelpers::NotificationsResult PocketHelpers::NotificationsReconstructor::GetResult() const
 {
-    return m_notifications;
+    return BuildResult(m_records, [](...) { return true; });
+}
+
+const PocketHelpers::NotificationRecords& PocketHelpers::NotificationsReconstructor::GetRecords() const
+{
+    return m_records;
+}
+
+PocketHelpers::NotificationsResult PocketHelpers::NotificationsReconstructor::BuildResult(const NotificationRecords& records, const std::function<bool(const ShortTxType&)>& predicate)
+{
+    NotificationsResult result;
+    for (const auto& [contextType, contextRecords]: records) {
+        if (!predicate(contextType)) continue;
+        for (const auto& record: contextRecords) {
+            result.InsertData(record.blockNum, *record.data);
+            result.InsertNotifiers(record.blockNum, contextType, record.notifiers);
+        }
+    }
+    return result;
 }
 
 void PocketHelpers::NotificationSummaryReconstructor::FeedRow(sqlite3_stmt* stmt)
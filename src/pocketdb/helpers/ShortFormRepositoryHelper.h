@@ -12,6 +12,7 @@
 #include <map>
 #include <optional>
 #include <functional>
+#include <memory>
 
 namespace PocketHelpers
 {
@@ -38,6 +39,17 @@ namespace PocketHelpers
         std::map<ShortTxType, std::vector<UniValue>> notifications;
     };
 
+    // Parsed notification row. Serialized tx data is shared between all rows of the same tx
+    struct NotificationRecord
+    {
+        int64_t blockNum;
+        std::shared_ptr<const UniValue> data;
+        std::map<std::string, std::optional<ShortAccount>> notifiers;
+    };
+
+    // Notification rows of one block grouped by context type
+    using NotificationRecords = std::map<ShortTxType, std::vector<NotificationRecord>>;
+
     class NotificationsResult
     {
     public:
@@ -45,6 +57,8 @@ namespace PocketHelpers
 
         void InsertData(const ShortForm& shortForm);
 
+        void InsertData(const int64_t& blocknum, const UniValue& data);
+
         void InsertNotifiers(const int64_t& blocknum, ShortTxType contextType, std::map<std::string, std::optional<ShortAccount>> addresses);
 
         UniValue Serialize() const;
@@ -100,9 +114,15 @@ namespace PocketHelpers
         void FeedRow(sqlite3_stmt* stmt);
 
         NotificationsResult GetResult() const;
+
+        const NotificationRecords& GetRecords() const;
+
+        // Build result from already parsed rows of context types allowed by predicate
+        static NotificationsResult BuildResult(const NotificationRecords& records, const std::function<bool(const ShortTxType&)>& predicate);
     private:
         ShortFormParser m_parser;
-        NotificationsResult m_notifications;
+        NotificationRecords m_records;
+        std::map<int64_t /* blocknum */, std::shared_ptr<const UniValue>> m_data;
     };
 
     class NotificationSummaryReconstructor : public RowAccessor
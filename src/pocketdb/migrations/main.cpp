@@ -192,6 +192,19 @@ namespace PocketDb
             );
         )sql");
 
+        // Counters of content for hydration, maintained by chain indexing
+        _tables.emplace_back(R"sql(
+            create table if not exists ContentStats
+            (
+                ContentId     int not null,
+                ScoresCount   int not null,
+                ScoresSum     int not null,
+                Reposted      int not null,
+                CommentsCount int not null,
+                primary key (ContentId)
+            );
+        )sql");
+
         
         _preProcessing = R"sql(
             insert or ignore into System (Db, Version) values ('main', 0);
@@ -51,6 +51,18 @@ namespace PocketDb
             );
         )sql");
 
+        _tables.emplace_back(R"sql(
+            create table if not exists EventsInbox
+            (
+                AddressHash text not null,
+                ActorHash   text not null,
+                Height      int not null,
+                BlockNum    int not null,
+                Type        int not null,
+                TxHash      text not null
+            );
+        )sql");
+
         // _tables.emplace_back(R"sql(
         //     create table if not exists Authors
         //     (
@@ -65,6 +77,9 @@ namespace PocketDb
             create index if not exists Tags_Lang_Id on Tags (Lang, Id);
             create index if not exists Tags_Lang_Value_Id on Tags (Lang, Value, Id);
             create index if not exists TagsMap_TagId_ContentId on TagsMap (TagId, ContentId);
+            create index if not exists EventsInbox_AddressHash_Height_Type on EventsInbox (AddressHash, Height, Type);
+            create index if not exists EventsInbox_ActorHash_Height_Type on EventsInbox (ActorHash, Height, Type);
+            create index if not exists EventsInbox_Height on EventsInbox (Height);
         )sql";
     }
 }
\ No newline at end of file
@@ -9,28 +9,28 @@ namespace PocketTx
     Payload::Payload() {}
 
     const optional<string>& Payload::GetTxHash() const { return m_txHash; }
-    void Payload::SetTxHash(string value) { m_txHash = value; }
+    void Payload::SetTxHash(string value) { m_txHash = std::move(value); }
 
     const optional<string>& Payload::GetString1() const { return m_string1; }
-    void Payload::SetString1(string value) { m_string1 = value; }
+    void Payload::SetString1(string value) { m_string1 = std::move(value); }
 
     const optional<string>& Payload::GetString2() const { return m_string2; }
-    void Payload::SetString2(string value) { m_string2 = value; }
+    void Payload::SetString2(string value) { m_string2 = std::move(value); }
 
     const optional<string>& Payload::GetString3() const { return m_string3; }
-    void Payload::SetString3(string value) { m_string3 = value; }
+    void Payload::SetString3(string value) { m_string3 = std::move(value); }
 
     const optional<string>& Payload::GetString4() const { return m_string4; }
-    void Payload::SetString4(string value) { m_string4 = value; }
+    void Payload::SetString4(string value) { m_string4 = std::move(value); }
 
     const optional<string>& Payload::GetString5() const { return m_string5; }
-    void Payload::SetString5(string value) { m_string5 = value; }
+    void Payload::SetString5(string value) { m_string5 = std::move(value); }
 
     const optional<string>& Payload::GetString6() const { return m_string6; }
-    void Payload::SetString6(string value) { m_string6 = value; }
+    void Payload::SetString6(string value) { m_string6 = std::move(value); }
 
     const optional<string>& Payload::GetString7() const { return m_string7; }
-    void Payload::SetString7(string value) { m_string7 = value; }
+    void Payload::SetString7(string value) { m_string7 = std::move(value); }
 
     const optional<int64_t>& Payload::GetInt1() const { return m_int1; }
     void Payload::SetInt1(int64_t value) { m_int1 = value; }
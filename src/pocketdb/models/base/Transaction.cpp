@@ -41,7 +41,7 @@ namespace PocketTx
     }
 
     const optional<string>& Transaction::GetHash() const { return m_hash; }
-    void Transaction::SetHash(string value) { m_hash = value; }
+    void Transaction::SetHash(string value) { m_hash = std::move(value); }
     bool Transaction::operator==(const string& hash) const { return m_hash && *m_hash == hash; }
 
     const optional<TxType>& Transaction::GetType() const { return m_type; }
@@ -54,25 +54,25 @@ namespace PocketTx
     void Transaction::SetHeight(int64_t value) { m_height = value; }
 
     const optional<string>& Transaction::GetBlockHash() const { return m_blockhash; }
-    void Transaction::SetBlockHash(string value) { m_blockhash = value; }
+    void Transaction::SetBlockHash(string value) { m_blockhash = std::move(value); }
 
     const optional<bool>& Transaction::GetLast() const { return m_last; }
     void Transaction::SetLast(bool value) { m_last = value; }
 
     const optional<string>& Transaction::GetString1() const { return m_string1; }
-    void Transaction::SetString1(string value) { m_string1 = value; }
+    void Transaction::SetString1(string value) { m_string1 = std::move(value); }
 
     const optional<string>& Transaction::GetString2() const { return m_string2; }
-    void Transaction::SetString2(string value) { m_string2 = value; }
+    void Transaction::SetString2(string value) { m_string2 = std::move(value); }
 
     const optional<string>& Transaction::GetString3() const { return m_string3; }
-    void Transaction::SetString3(string value) { m_string3 = value; }
+    void Transaction::SetString3(string value) { m_string3 = std::move(value); }
 
     const optional<string>& Transaction::GetString4() const { return m_string4; }
-    void Transaction::SetString4(string value) { m_string4 = value; }
+    void Transaction::SetString4(string value) { m_string4 = std::move(value); }
 
     const optional<string>& Transaction::GetString5() const { return m_string5; }
-    void Transaction::SetString5(string value) { m_string5 = value; }
+    void Transaction::SetString5(string value) { m_string5 = std::move(value); }
 
     const optional<int64_t>& Transaction::GetInt1() const { return m_int1; }
     void Transaction::SetInt1(int64_t value) { m_int1 = value; }
@@ -7,16 +7,16 @@
 namespace PocketTx
 {
     const optional<string>& TransactionInput::GetSpentTxHash() const { return m_spentTxHash; }
-    void TransactionInput::SetSpentTxHash(string value) { m_spentTxHash = value; }
+    void TransactionInput::SetSpentTxHash(string value) { m_spentTxHash = std::move(value); }
 
     const optional<string>& TransactionInput::GetTxHash() const { return m_txHash; }
-    void TransactionInput::SetTxHash(string value) { m_txHash = value; }
+    void TransactionInput::SetTxHash(string value) { m_txHash = std::move(value); }
 
     const optional<int64_t>& TransactionInput::GetNumber() const { return m_number; }
     void TransactionInput::SetNumber(int64_t value) { m_number = value; }
 
     const optional<string>& TransactionInput::GetAddressHash() const { return m_addresshash; }
-    void TransactionInput::SetAddressHash(string value) { m_addresshash = value; }
+    void TransactionInput::SetAddressHash(string value) { m_addresshash = std::move(value); }
 
     const optional<int64_t>& TransactionInput::GetValue() const { return m_value; }
     void TransactionInput::SetValue(int64_t value) { m_value = value; }
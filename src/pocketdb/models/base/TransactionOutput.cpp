@@ -7,22 +7,22 @@
 namespace PocketTx
 {
     const optional <string>& TransactionOutput::GetTxHash() const { return m_txHash; }
-    void TransactionOutput::SetTxHash(string value) { m_txHash = value; }
+    void TransactionOutput::SetTxHash(string value) { m_txHash = std::move(value); }
 
     const optional <int64_t>& TransactionOutput::GetNumber() const { return m_number; }
     void TransactionOutput::SetNumber(int64_t value) { m_number = value; }
 
     const optional <string>& TransactionOutput::GetAddressHash() const { return m_addressHash; }
-    void TransactionOutput::SetAddressHash(string value) { m_addressHash = value; }
+    void TransactionOutput::SetAddressHash(string value) { m_addressHash = std::move(value); }
 
     const optional <int64_t>& TransactionOutput::GetValue() const { return m_value; }
     void TransactionOutput::SetValue(int64_t value) { m_value = value; }
     
     const optional <string>& TransactionOutput::GetScriptPubKey() const { return m_scriptPubKey; }
-    void TransactionOutput::SetScriptPubKey(string value) { m_scriptPubKey = value; }
+    void TransactionOutput::SetScriptPubKey(string value) { m_scriptPubKey = std::move(value); }
         
     const optional<string>& TransactionOutput::GetSpentTxHash() const { return m_spentTxHash; }
-    void TransactionOutput::SetSpentTxHash(string value) { m_spentTxHash = value; }
+    void TransactionOutput::SetSpentTxHash(string value) { m_spentTxHash = std::move(value); }
 
     const optional<int64_t>& TransactionOutput::GetSpentHeight() const { return m_spentHeight; }
     void TransactionOutput::SetSpentHeight(int64_t value) { m_spentHeight = value; }
@@ -16,6 +16,11 @@ namespace PocketDb
     MigrationRepository MigrationRepoInst(SQLiteDbInst);
 
     CheckpointRepository CheckpointRepoInst;
+
+    AccountStateCache AccountStateCacheInst;
+    MempoolPayloads MempoolPayloadsInst;
+    WebContentCache WebContentCacheInst;
+    AccountProfileLoader AccountProfileLoaderInst;
 } // PocketDb
 
 namespace PocketWeb
@@ -17,11 +17,15 @@
 #include "pocketdb/repositories/RatingsRepository.h"
 #include "pocketdb/repositories/TransactionRepository.h"
 #include "pocketdb/repositories/ConsensusRepository.h"
+#include "pocketdb/repositories/AccountStateCache.h"
+#include "pocketdb/repositories/MempoolPayloads.h"
 #include "pocketdb/repositories/SystemRepository.h"
 #include "pocketdb/repositories/CheckpointRepository.h"
 #include "pocketdb/repositories/MigrationRepository.h"
 
 #include "pocketdb/repositories/web/WebRpcRepository.h"
+#include "pocketdb/repositories/web/WebContentCache.h"
+#include "pocketdb/repositories/web/AccountProfileLoader.h"
 #include "pocketdb/repositories/web/ExplorerRepository.h"
 #include "pocketdb/repositories/web/NotifierRepository.h"
 
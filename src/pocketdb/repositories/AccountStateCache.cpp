@@ -0,0 +1,79 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/repositories/AccountStateCache.h"
+
+namespace PocketDb
+{
+    static const int64_t DEFAULT_ACCOUNT_CACHE_SIZE = 100000;
+
+    void AccountStateCache::Init()
+    {
+        LOCK(m_mutex);
+        m_maxSize = (size_t) std::max((int64_t) 0, gArgs.GetArg("-accountcachesize", DEFAULT_ACCOUNT_CACHE_SIZE));
+    }
+
+    string AccountStateCache::IdKey(int64_t id)
+    {
+        return "#" + to_string(id);
+    }
+
+    void AccountStateCache::Invalidate(const vector<tuple<string, int64_t>>& accounts)
+    {
+        LOCK(m_mutex);
+
+        // Increment before erase - loads started earlier must not return dropped values to cache
+        m_generation++;
+
+        for (const auto& [address, id] : accounts)
+        {
+            for (const auto& key : { address, IdKey(id) })
+            {
+                auto it = m_entries.find(key);
+                if (it == m_entries.end())
+                    continue;
+
+                m_lru.erase(it->second.LruIt);
+                m_entries.erase(it);
+            }
+        }
+    }
+
+    void AccountStateCache::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_generation++;
+        m_entries.clear();
+        m_lru.clear();
+    }
+
+    size_t AccountStateCache::Size()
+    {
+        LOCK(m_mutex);
+        return m_entries.size();
+    }
+
+    AccountStateCache::CacheEntry& AccountStateCache::Touch(const string& key)
+    {
+        auto it = m_entries.find(key);
+        if (it != m_entries.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second.LruIt);
+            return it->second;
+        }
+
+        while (!m_lru.empty() && m_entries.size() >= m_maxSize)
+        {
+            m_entries.erase(m_lru.back());
+            m_lru.pop_back();
+        }
+
+        m_lru.push_front(key);
+        auto& entry = m_entries[key];
+        entry.LruIt = m_lru.begin();
+
+        return entry;
+    }
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_ACCOUNTSTATECACHE_H
+#define POCKETDB_ACCOUNTSTATECACHE_H
+
+#include <sync.h>
+#include <util/system.h>
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+#include "pocketdb/repositories/ConsensusRepository.h"
+
+namespace PocketDb
+{
+    using namespace std;
+
+    // Current chain state of one account
+    // Every field loads from db independently with the same query as uncached one
+    struct AccountState
+    {
+        optional<AccountData> Data;
+        optional<int> Reputation;
+        optional<int64_t> Balance;
+        optional<int64_t> RegistrationTime;
+    };
+
+    // Node-wide LRU cache of current account states shared by all db connections.
+    // Entries changed by a new block are dropped after block indexing, all entries on rollback.
+    // Values loaded from db while a block was indexing are not stored, because
+    // reader can see state before or after this block.
+    class AccountStateCache
+    {
+    public:
+        void Init();
+
+        // Key for values requested by account Id
+        static string IdKey(int64_t id);
+
+        template<typename T>
+        T GetOrLoad(const string& key, optional<T> AccountState::* field, const function<T()>& load)
+        {
+            {
+                LOCK(m_mutex);
+
+                auto it = m_entries.find(key);
+                if (it != m_entries.end() && (it->second.State.*field))
+                {
+                    m_lru.splice(m_lru.begin(), m_lru, it->second.LruIt);
+                    return *(it->second.State.*field);
+                }
+            }
+
+            auto generation = m_generation.load();
+            T value = load();
+
+            LOCK(m_mutex);
+            if (generation != m_generation.load() || m_maxSize == 0)
+                return value;
+
+            auto& entry = Touch(key);
+            entry.State.*field = value;
+
+            return value;
+        }
+
+        // Drop entries of accounts changed at height
+        void Invalidate(const vector<tuple<string, int64_t>>& accounts);
+
+        void Clear();
+
+        size_t Size();
+
+    private:
+        struct CacheEntry
+        {
+            AccountState State;
+            list<string>::iterator LruIt;
+        };
+
+        Mutex m_mutex;
+        unordered_map<string, CacheEntry> m_entries;
+        list<string> m_lru;
+        size_t m_maxSize = 0;
+        atomic<uint64_t> m_generation{0};
+
+        CacheEntry& Touch(const string& key);
+    };
+
+    extern AccountStateCache AccountStateCacheInst;
+} // namespace PocketDb
+
+#endif // POCKETDB_ACCOUNTSTATECACHE_H
@@ -91,6 +91,21 @@ namespace PocketDb
                 throw std::runtime_error(strprintf("%s: Failed execute SQL statement\n", __func__));
         }
 
+        // Step statement prepared once for many rows
+        // Statement resets for next binds and must be finalized by caller
+        void TryStepStatementReuse(shared_ptr<sqlite3_stmt*>& stmt)
+        {
+            int res = sqlite3_step(*stmt);
+            sqlite3_reset(*stmt);
+            sqlite3_clear_bindings(*stmt);
+
+            if (res != SQLITE_ROW && res != SQLITE_DONE)
+            {
+                FinalizeSqlStatement(*stmt);
+                throw std::runtime_error(strprintf("%s: Failed execute SQL statement\n", __func__));
+            }
+        }
+
         void TryTransactionBulk(const string& func, const vector<shared_ptr<sqlite3_stmt*>>& stmts)
     {
             if (!m_database.BeginTransaction())
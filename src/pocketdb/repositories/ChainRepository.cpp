@@ -54,10 +54,17 @@ namespace PocketDb
 
             int64_t nTime3 = GetTimeMicros();
 
-            LogPrint(BCLog::BENCH, "    - IndexBlock: %.2fms + %.2fms = %.2fms\n",
+            // Recalculate counters of contents affected by block
+            StageContentStats(height);
+            UpdateStagedContentStats();
+
+            int64_t nTime4 = GetTimeMicros();
+
+            LogPrint(BCLog::BENCH, "    - IndexBlock: %.2fms + %.2fms + %.2fms = %.2fms\n",
                 0.001 * double(nTime2 - nTime1),
                 0.001 * double(nTime3 - nTime2),
-                0.001 * double(nTime3 - nTime1)
+                0.001 * double(nTime4 - nTime3),
+                0.001 * double(nTime4 - nTime1)
             );
         });
     }
@@ -486,6 +493,11 @@ namespace PocketDb
         RollbackHeight(0);
         ClearBlockingList();
 
+        auto stmt = SetupSqlStatement(R"sql(
+            delete from ContentStats
+        )sql");
+        TryStepStatement(stmt);
+
         m_database.CreateStructure();
 
         return true;
@@ -498,9 +510,15 @@ namespace PocketDb
             // Update transactions
             TryTransactionStep(__func__, [&]()
             {
+                // Counters are deleted while contents have Id and recalculated after rollback
+                StageContentStats(height);
+                DeleteStagedContentStats();
+
                 RestoreOldLast(height);
                 RollbackBlockingList(height);
                 RollbackHeight(height);
+
+                UpdateStagedContentStats();
             });
 
             return true;
@@ -763,5 +781,207 @@ namespace PocketDb
         LogPrint(BCLog::BENCH, "        - ClearBlockingList (Delete blocking list): %.2fms\n", 0.001 * (nTime1 - nTime0));
     }
 
+    void ChainRepository::ClearContentStatsStage()
+    {
+        auto createStmt = SetupSqlStatement(R"sql(
+            create temp table if not exists ContentStatsStage
+            (
+                Hash text not null primary key
+            )
+        )sql");
+        TryStepStatement(createStmt);
+
+        auto clearStmt = SetupSqlStatement(R"sql(
+            delete from temp.ContentStatsStage
+        )sql");
+        TryStepStatement(clearStmt);
+    }
+
+    void ChainRepository::StageContentStats(int height)
+    {
+        int64_t nTime0 = GetTimeMicros();
+
+        ClearContentStatsStage();
+
+        auto stmt = SetupSqlStatement(R"sql(
+            insert or ignore into temp.ContentStatsStage (Hash)
+
+            -- Scores
+            select s.String2
+            from Transactions s indexed by Transactions_Height_Type
+            where s.Type in (300)
+              and s.Height >= ?
+
+            union
+
+            -- Comments
+            select c.String3
+            from Transactions c indexed by Transactions_Height_Type
+            where c.Type in (204, 205, 206)
+              and c.Height >= ?
+
+            union
+
+            -- New, edited and deleted contents and all contents reposted by any of their versions
+            select t.String2
+            from Transactions t indexed by Transactions_Height_Type
+            where t.Type in (200, 201, 202, 209, 210, 207)
+              and t.Height >= ?
+
+            union
+
+            select r.String3
+            from Transactions t indexed by Transactions_Height_Type
+            cross join Transactions r indexed by Transactions_Type_Last_String2_Height
+              on r.Type in (200, 201, 202, 209, 210) and r.Last in (0, 1) and r.String2 = t.String2
+            where t.Type in (200, 201, 202, 209, 210, 207)
+              and t.Height >= ?
+              and r.String3 is not null
+
+            union
+
+            -- Blocking changes comments count of all contents of blocker,
+            -- deleted account leaves blocking lists of contents authors
+            select c.String2
+            from Transactions b indexed by Transactions_Height_Type
+            cross join Transactions c indexed by Transactions_Type_Last_String1_Height_Id
+              on c.Type in (200, 201, 202, 209, 210, 207) and c.Last = 1 and c.String1 = b.String1 and c.Height > 0
+            where b.Type in (305, 306, 170)
+              and b.Height >= ?
+
+            union
+
+            select cm.String3
+            from Transactions a indexed by Transactions_Height_Type
+            cross join Transactions cm indexed by Transactions_Type_Last_String1_Height_Id
+              on cm.Type in (204, 205) and cm.Last = 1 and cm.String1 = a.String1 and cm.Height > 0
+            where a.Type in (170)
+              and a.Height >= ?
+        )sql");
+        for (int i = 1; i <= 6; i++)
+            TryBindStatementInt(stmt, i, height);
+        TryStepStatement(stmt);
+
+        int64_t nTime1 = GetTimeMicros();
+        LogPrint(BCLog::BENCH, "        - StageContentStats: %.2fms\n", 0.001 * (nTime1 - nTime0));
+    }
+
+    void ChainRepository::DeleteStagedContentStats()
+    {
+        auto stmt = SetupSqlStatement(R"sql(
+            delete from ContentStats
+            where ContentId in (
+                select t.Id
+                from temp.ContentStatsStage s
+                cross join Transactions t indexed by Transactions_Type_Last_String2_Height
+                  on t.Type in (200, 201, 202, 209, 210, 207) and t.Last = 1 and t.String2 = s.Hash and t.Height is not null
+            )
+        )sql");
+        TryStepStatement(stmt);
+    }
+
+    void ChainRepository::UpdateStagedContentStats()
+    {
+        int64_t nTime0 = GetTimeMicros();
+
+        // Same calculation as on-the-fly counters in WebRpcRepository::GetContentsData
+        auto stmt = SetupSqlStatement(R"sql(
+            insert or replace into ContentStats (ContentId, ScoresCount, ScoresSum, Reposted, CommentsCount)
+            select
+                t.Id,
+
+                (select count() from Transactions scr indexed by Transactions_Type_Last_String2_Height
+                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2),
+
+                ifnull((select sum(scr.Int1) from Transactions scr indexed by Transactions_Type_Last_String2_Height
+                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2),0),
+
+                (select count() from Transactions rep indexed by Transactions_Type_Last_String3_Height
+                    where rep.Type in (200,201,202,209,210) and rep.Last = 1 and rep.Height is not null and rep.String3 = t.String2),
+
+                (
+                    select count()
+                    from Transactions s indexed by Transactions_Type_Last_String3_Height
+                    where s.Type in (204, 205)
+                      and s.Height is not null
+                      and s.String3 = t.String2
+                      and s.Last = 1
+                      and not exists (
+                        select 1
+                        from BlockingLists bl
+                        join Transactions us on us.Id = bl.IdSource and us.Type = 100 and us.Last = 1
+                        join Transactions ut on ut.Id = bl.IdTarget and ut.Type = 100 and ut.Last = 1
+                        where us.String1 = t.String1 and ut.String1 = s.String1
+                      )
+                )
+
+            from temp.ContentStatsStage st
+            cross join Transactions t indexed by Transactions_Type_Last_String2_Height
+              on t.Type in (200, 201, 202, 209, 210, 207) and t.Last = 1 and t.String2 = st.Hash and t.Height is not null
+        )sql");
+        TryStepStatement(stmt);
+
+        int64_t nTime1 = GetTimeMicros();
+        LogPrint(BCLog::BENCH, "        - UpdateStagedContentStats: %.2fms\n", 0.001 * (nTime1 - nTime0));
+    }
+
+    void ChainRepository::BuildContentStats()
+    {
+        bool empty = true;
+        int64_t maxId = -1;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select
+                    exists (select 1 from ContentStats),
+                    (select max(t.Id) from Transactions t indexed by Transactions_Last_Id_Height where t.Last = 1)
+            )sql");
+
+            if (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
+                    empty = (value == 0);
+
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 1); ok)
+                    maxId = value;
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        if (!empty || maxId < 0)
+            return;
+
+        LogPrintf("Building content counters..\n");
+
+        // Every chunk in own transaction - chain indexing keeps built chunks actual
+        const int64_t chunk = 10000;
+        for (int64_t id = 0; id <= maxId && !ShutdownRequested(); id += chunk)
+        {
+            TryTransactionStep(__func__, [&]()
+            {
+                ClearContentStatsStage();
+
+                auto stmt = SetupSqlStatement(R"sql(
+                    insert or ignore into temp.ContentStatsStage (Hash)
+                    select t.String2
+                    from Transactions t indexed by Transactions_Last_Id_Height
+                    where t.Last = 1
+                      and t.Id >= ?
+                      and t.Id < ?
+                      and t.Height is not null
+                      and t.Type in (200, 201, 202, 209, 210, 207)
+                )sql");
+                TryBindStatementInt64(stmt, 1, id);
+                TryBindStatementInt64(stmt, 2, id + chunk);
+                TryStepStatement(stmt);
+
+                UpdateStagedContentStats();
+            });
+        }
+
+        LogPrintf("Content counters built\n");
+    }
 
 } // namespace PocketDb
@@ -48,6 +48,9 @@ namespace PocketDb
         // Check block exist in db
         tuple<bool, bool> ExistsBlock(const string& blockHash, int height);
 
+        // Fill ContentStats for all contents if table is empty - first start after migration
+        void BuildContentStats();
+
     private:
 
         void RollbackBlockingList(int height);
@@ -68,6 +71,12 @@ namespace PocketDb
 
         void ClearOldLast(const string& txHash);
 
+        void ClearContentStatsStage();
+        // Root hashes of contents whose counters changed by transactions great or equals height
+        void StageContentStats(int height);
+        void DeleteStagedContentStats();
+        void UpdateStagedContentStats();
+
     };
 
 } // namespace PocketDb
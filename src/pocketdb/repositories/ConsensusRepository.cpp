@@ -3,9 +3,17 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/repositories/ConsensusRepository.h"
+#include "pocketdb/repositories/AccountStateCache.h"
+#include "pocketdb/repositories/MempoolPayloads.h"
 
 namespace PocketDb
 {
+    // First version of content - edits have another hash with the same root String2
+    static bool IsOriginal(const PTransactionRef& ptx)
+    {
+        return ptx->GetHash() == ptx->GetString2();
+    }
+
     void ConsensusRepository::Init() {}
 
     void ConsensusRepository::Destroy() {}
@@ -407,67 +415,14 @@ namespace PocketDb
     bool ConsensusRepository::ExistsInMempool(const string& string1, const vector<TxType>& types)
     {
         assert(string1 != "");
-        bool result = false;
-
-        string sql = R"sql(
-            select 1
-            from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-            where Type in ( )sql" + join(vector<string>(types.size(), "?"), ",") + R"sql( )
-              and String1 = ?
-              and Height is null
-            limit 1
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(sql);
-            
-            int i = 1;
-            for (const auto& type: types)
-                TryBindStatementInt(stmt, i++, type);
-            TryBindStatementText(stmt, i++, string1);
-            
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                result = true;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(string1, types) > 0;
     }
 
     bool ConsensusRepository::ExistsInMempool(const string& string1, const string& string2, const vector<TxType>& types)
     {
         assert(string1 != "");
         assert(string2 != "");
-        bool result = false;
-
-        string sql = R"sql(
-            select 1
-            from Transactions indexed by Transactions_Type_String1_String2_Height
-            where Type in ( )sql" + join(vector<string>(types.size(), "?"), ",") + R"sql( )
-              and String1 = ?
-              and String2 = ?
-              and Height is null
-        )sql";
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(sql);
-            
-            int i = 1;
-            for (const auto& type: types)
-                TryBindStatementInt(stmt, i++, type);
-            TryBindStatementText(stmt, i++, string1);
-            TryBindStatementText(stmt, i++, string2);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                result = true;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(string1, types, [&](const PTransactionRef& ptx) { return ptx->GetString2() == string2; }) > 0;
     }
 
     bool ConsensusRepository::ExistsNotDeleted(const string& txHash, const string& address, const vector<TxType>& types)
@@ -505,6 +460,14 @@ namespace PocketDb
 
 
     int64_t ConsensusRepository::GetUserBalance(const string& address)
+    {
+        return AccountStateCacheInst.GetOrLoad<int64_t>(address, &AccountState::Balance, [&]()
+        {
+            return SelectUserBalance(address);
+        });
+    }
+
+    int64_t ConsensusRepository::SelectUserBalance(const string& address)
     {
         int64_t result = 0;
 
@@ -531,6 +494,14 @@ namespace PocketDb
     }
 
     int ConsensusRepository::GetUserReputation(const string& address)
+    {
+        return AccountStateCacheInst.GetOrLoad<int>(address, &AccountState::Reputation, [&]()
+        {
+            return SelectUserReputation(address);
+        });
+    }
+
+    int ConsensusRepository::SelectUserReputation(const string& address)
     {
         int result = 0;
 
@@ -566,6 +537,14 @@ namespace PocketDb
     }
 
     int ConsensusRepository::GetUserReputation(int addressId)
+    {
+        return AccountStateCacheInst.GetOrLoad<int>(AccountStateCache::IdKey(addressId), &AccountState::Reputation, [&]()
+        {
+            return SelectUserReputation(addressId);
+        });
+    }
+
+    int ConsensusRepository::SelectUserReputation(int addressId)
     {
         int result = 0;
 
@@ -594,6 +573,14 @@ namespace PocketDb
 
     // TODO (aok): maybe remove in future?
     int64_t ConsensusRepository::GetAccountRegistrationTime(int addressId)
+    {
+        return AccountStateCacheInst.GetOrLoad<int64_t>(AccountStateCache::IdKey(addressId), &AccountState::RegistrationTime, [&]()
+        {
+            return SelectAccountRegistrationTime(addressId);
+        });
+    }
+
+    int64_t ConsensusRepository::SelectAccountRegistrationTime(int addressId)
     {
         int64_t result = 0;
 
@@ -623,6 +610,14 @@ namespace PocketDb
     }
 
     AccountData ConsensusRepository::GetAccountData(const string& address)
+    {
+        return AccountStateCacheInst.GetOrLoad<AccountData>(address, &AccountState::Data, [&]()
+        {
+            return SelectAccountData(address);
+        });
+    }
+
+    AccountData ConsensusRepository::SelectAccountData(const string& address)
     {
         AccountData result = {address,-1,0,0,0,0,0};
 
@@ -689,6 +684,122 @@ namespace PocketDb
         return result;
     }
 
+    vector<tuple<string, int64_t>> ConsensusRepository::GetChangedAccounts(int height)
+    {
+        vector<tuple<string, int64_t>> result;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select b.AddressHash, -1
+                from Balances b indexed by Balances_Height
+                where b.Height = ?
+
+                union
+
+                select u.String1, u.Id
+                from Transactions u indexed by Transactions_Height_Type
+                where u.Height = ?
+                  and u.Type in (100, 170)
+
+                union
+
+                select u.String1, u.Id
+                from Ratings r indexed by Ratings_Height_Last
+                cross join Transactions u indexed by Transactions_Id
+                    on u.Id = r.Id and u.Type in (100, 170) and u.Last = 1
+                where r.Height = ?
+                  and r.Type in (0, 111, 112, 113)
+            )sql");
+
+            TryBindStatementInt(stmt, 1, height);
+            TryBindStatementInt(stmt, 2, height);
+            TryBindStatementInt(stmt, 3, height);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okAddress, address] = TryGetColumnString(*stmt, 0);
+                auto[okId, id] = TryGetColumnInt64(*stmt, 1);
+                if (okAddress)
+                    result.emplace_back(address, okId ? id : -1);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    tuple<vector<int64_t>, vector<string>, bool> ConsensusRepository::GetChangedWebContents(int height)
+    {
+        vector<int64_t> contentIds;
+        vector<string> addresses;
+        bool accountsDeleted = false;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select c.Id, null, c.Type
+                from Transactions c indexed by Transactions_Height_Type
+                where c.Height = ?
+                  and c.Type in (200, 201, 202, 209, 210, 207)
+
+                union
+
+                -- Profile fields, posts, subscribes and blockings counts
+                select null, t.String1, t.Type
+                from Transactions t indexed by Transactions_Height_Type
+                where t.Height = ?
+                  and t.Type in (100, 170, 200, 201, 202, 209, 210, 207, 302, 303, 304, 305, 306)
+
+                union
+
+                -- Subscribers counts
+                select null, t.String2, t.Type
+                from Transactions t indexed by Transactions_Height_Type
+                where t.Height = ?
+                  and t.Type in (302, 303, 304)
+
+                union
+
+                -- Flags
+                select null, t.String3, t.Type
+                from Transactions t indexed by Transactions_Height_Type
+                where t.Height = ?
+                  and t.Type in (410)
+
+                union
+
+                -- Reputation and likers
+                select null, u.String1, u.Type
+                from Ratings r indexed by Ratings_Height_Last
+                cross join Transactions u indexed by Transactions_Id
+                    on u.Id = r.Id and u.Type in (100, 170) and u.Last = 1
+                where r.Height = ?
+                  and r.Type in (0, 111, 112, 113)
+            )sql");
+
+            for (int i = 1; i <= 5; i++)
+                TryBindStatementInt(stmt, i, height);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                    contentIds.push_back(value);
+
+                if (auto[ok, value] = TryGetColumnString(*stmt, 1); ok)
+                    addresses.push_back(value);
+
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 2); ok && value == ACCOUNT_DELETE)
+                    accountsDeleted = true;
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return {contentIds, addresses, accountsDeleted};
+    }
+
     // Selects for get models data
     ScoreDataDtoRef ConsensusRepository::GetScoreData(const string& txHash)
     {
@@ -1017,84 +1128,22 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolBlocking(const string& address, const string& addressTo)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { ACTION_BLOCKING, ACTION_BLOCKING_CANCEL }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count()
-                from Transactions
-                where Type in (305, 306)
-                  and Height is null
-                  and String1 = ?
-                  and (String2 = ? or String3 is not null)
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, addressTo);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == addressTo || ptx->GetString3();
         });
-
-        return result;
     }
     int ConsensusRepository::CountMempoolSubscribe(const string& address, const string& addressTo)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { ACTION_SUBSCRIBE, ACTION_SUBSCRIBE_PRIVATE, ACTION_SUBSCRIBE_CANCEL }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions
-                where Type in (302, 303, 304)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, addressTo);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == addressTo;
         });
-
-        return result;
     }
 
     int ConsensusRepository::CountMempoolComment(const string& address)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (204)
-                  and Height is null
-                  and String1 = ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(address, { CONTENT_COMMENT }, IsOriginal);
     }
     int ConsensusRepository::CountChainCommentTime(const string& address, int64_t time)
     {
@@ -1155,29 +1204,7 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolComplain(const string& address)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions
-                where Type in (307)
-                  and Height is null
-                  and String1 = ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(address, { ACTION_COMPLAIN }, IsOriginal);
     }
     int ConsensusRepository::CountChainComplainTime(const string& address, int64_t time)
     {
@@ -1238,29 +1265,7 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolPost(const string& address)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (200)
-                  and Height is null
-                  and String1 = ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(address, { CONTENT_POST }, IsOriginal);
     }
     int ConsensusRepository::CountChainPostTime(const string& address, int64_t time)
     {
@@ -1319,6 +1324,10 @@ namespace PocketDb
     }
 
     int ConsensusRepository::CountMempoolVideo(const string& address)
+    {
+        return MempoolPayloadsInst.Count(address, { CONTENT_VIDEO }, IsOriginal);
+    }
+    int ConsensusRepository::CountChainVideo(const string& address, int height)
     {
         int result = 0;
 
@@ -1328,12 +1337,13 @@ namespace PocketDb
                 select count(*)
                 from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
                 where Type in (201)
-                  and Height is null
                   and String1 = ?
+                  and Height >= ?
                   and Hash = String2
             )sql");
 
             TryBindStatementText(stmt, 1, address);
+            TryBindStatementInt(stmt, 2, height);
 
             if (sqlite3_step(*stmt) == SQLITE_ROW)
                 if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
@@ -1344,7 +1354,12 @@ namespace PocketDb
 
         return result;
     }
-    int ConsensusRepository::CountChainVideo(const string& address, int height)
+
+    int ConsensusRepository::CountMempoolArticle(const string& address)
+    {
+        return MempoolPayloadsInst.Count(address, { CONTENT_ARTICLE }, IsOriginal);
+    }
+    int ConsensusRepository::CountChainArticle(const string& address, int height)
     {
         int result = 0;
 
@@ -1353,7 +1368,7 @@ namespace PocketDb
             auto stmt = SetupSqlStatement(R"sql(
                 select count(*)
                 from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (201)
+                where Type in (202)
                   and String1 = ?
                   and Height >= ?
                   and Hash = String2
@@ -1372,7 +1387,11 @@ namespace PocketDb
         return result;
     }
 
-    int ConsensusRepository::CountMempoolArticle(const string& address)
+    int ConsensusRepository::CountMempoolStream(const string& address)
+    {
+        return MempoolPayloadsInst.Count(address, { CONTENT_STREAM }, IsOriginal);
+    }
+    int ConsensusRepository::CountChainStream(const string& address, int height)
     {
         int result = 0;
 
@@ -1381,13 +1400,14 @@ namespace PocketDb
             auto stmt = SetupSqlStatement(R"sql(
                 select count(*)
                 from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (202)
-                  and Height is null
+                where Type in (209)
                   and String1 = ?
+                  and Height >= ?
                   and Hash = String2
             )sql");
 
             TryBindStatementText(stmt, 1, address);
+            TryBindStatementInt(stmt, 2, height);
 
             if (sqlite3_step(*stmt) == SQLITE_ROW)
                 if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
@@ -1398,7 +1418,12 @@ namespace PocketDb
 
         return result;
     }
-    int ConsensusRepository::CountChainArticle(const string& address, int height)
+
+    int ConsensusRepository::CountMempoolAudio(const string& address)
+    {
+        return MempoolPayloadsInst.Count(address, { CONTENT_AUDIO }, IsOriginal);
+    }
+    int ConsensusRepository::CountChainAudio(const string& address, int height)
     {
         int result = 0;
 
@@ -1407,7 +1432,7 @@ namespace PocketDb
             auto stmt = SetupSqlStatement(R"sql(
                 select count(*)
                 from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (202)
+                where Type in (210)
                   and String1 = ?
                   and Height >= ?
                   and Hash = String2
@@ -1426,138 +1451,9 @@ namespace PocketDb
         return result;
     }
 
-    int ConsensusRepository::CountMempoolStream(const string& address)
+    int ConsensusRepository::CountMempoolScoreComment(const string& address)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (209)
-                  and Height is null
-                  and String1 = ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
-    }
-    int ConsensusRepository::CountChainStream(const string& address, int height)
-    {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (209)
-                  and String1 = ?
-                  and Height >= ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementInt(stmt, 2, height);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
-    }
-
-    int ConsensusRepository::CountMempoolAudio(const string& address)
-    {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (210)
-                  and Height is null
-                  and String1 = ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
-    }
-    int ConsensusRepository::CountChainAudio(const string& address, int height)
-    {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (210)
-                  and String1 = ?
-                  and Height >= ?
-                  and Hash = String2
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementInt(stmt, 2, height);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
-    }
-
-    int ConsensusRepository::CountMempoolScoreComment(const string& address)
-    {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (301)
-                  and Height is null
-                  and String1 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(address, { ACTION_SCORE_COMMENT });
     }
     int ConsensusRepository::CountChainScoreCommentTime(const string& address, int64_t time)
     {
@@ -1616,28 +1512,7 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolScoreContent(const string& address)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_Height_Time_Int1
-                where Type in (300)
-                  and Height is null
-                  and String1 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(address, { ACTION_SCORE_CONTENT });
     }
     int ConsensusRepository::CountChainScoreContentTime(const string& address, int64_t time)
     {
@@ -1696,28 +1571,7 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolAccountSetting(const string& address)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
-        {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions
-                where Type in (103)
-                  and Height is null
-                  and String1 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
-        });
-
-        return result;
+        return MempoolPayloadsInst.Count(address, { ACCOUNT_SETTING });
     }
     int ConsensusRepository::CountChainAccountSetting(const string& address, int height)
     {
@@ -1780,30 +1634,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolCommentEdit(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (204,205,206)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
     int ConsensusRepository::CountChainCommentEdit(const string& address, const string& rootTxHash)
     {
@@ -1836,30 +1670,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolPostEdit(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_POST, CONTENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (200,207)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
     int ConsensusRepository::CountChainPostEdit(const string& address, const string& rootTxHash)
     {
@@ -1892,30 +1706,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolVideoEdit(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_VIDEO, CONTENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (201,207)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
     int ConsensusRepository::CountChainVideoEdit(const string& address, const string& rootTxHash)
     {
@@ -1948,30 +1742,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolArticleEdit(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_ARTICLE, CONTENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (202,207)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
     int ConsensusRepository::CountChainArticleEdit(const string& address, const string& rootTxHash)
     {
@@ -2004,30 +1778,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolStreamEdit(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_STREAM, CONTENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (209,207)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
     int ConsensusRepository::CountChainStreamEdit(const string& address, const string& rootTxHash)
     {
@@ -2060,30 +1814,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolAudioEdit(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_AUDIO, CONTENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count(*)
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (210,207)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
     int ConsensusRepository::CountChainAudioEdit(const string& address, const string& rootTxHash)
     {
@@ -2116,30 +1850,10 @@ namespace PocketDb
 
     int ConsensusRepository::CountMempoolContentDelete(const string& address, const string& rootTxHash)
     {
-        int result = 0;
-
-        TryTransactionStep(__func__, [&]()
+        return MempoolPayloadsInst.Count(address, { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_DELETE }, [&](const PTransactionRef& ptx)
         {
-            auto stmt = SetupSqlStatement(R"sql(
-                select count()
-                from Transactions indexed by Transactions_Type_String1_String2_Height
-                where Type in (200,201,202,209,210,207)
-                  and Height is null
-                  and String1 = ?
-                  and String2 = ?
-            )sql");
-
-            TryBindStatementText(stmt, 1, address);
-            TryBindStatementText(stmt, 2, rootTxHash);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok)
-                    result = value;
-
-            FinalizeSqlStatement(*stmt);
+            return ptx->GetString2() == rootTxHash;
         });
-
-        return result;
     }
 
     /* MODERATION */
@@ -97,6 +97,13 @@ namespace PocketDb
 
         AccountData GetAccountData(const string& address);
 
+        // Accounts with balance, registration or ratings changed at height
+        vector<tuple<string, int64_t>> GetChangedAccounts(int height);
+
+        // Contents with new version and addresses with short profile changed at height,
+        // flag is set when accounts deleted - subscriptions counts of unknown accounts changed
+        tuple<vector<int64_t>, vector<string>, bool> GetChangedWebContents(int height);
+
         ScoreDataDtoRef GetScoreData(const string& txHash);
         shared_ptr<map<string, string>> GetReferrers(const vector<string>& addresses, int minHeight);
         tuple<bool, string> GetReferrer(const string& address);
@@ -188,6 +195,13 @@ namespace PocketDb
         int CountModerationFlag(const string& address, int height, bool includeMempool);
         int CountModerationFlag(const string& address, const string& addressTo, bool includeMempool);
 
+
+    private:
+        int64_t SelectUserBalance(const string& address);
+        int SelectUserReputation(const string& address);
+        int SelectUserReputation(int addressId);
+        int64_t SelectAccountRegistrationTime(int addressId);
+        AccountData SelectAccountData(const string& address);
     };
 
     typedef shared_ptr<ConsensusRepository> ConsensusRepositoryRef;
@@ -0,0 +1,103 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/repositories/MempoolPayloads.h"
+
+namespace PocketDb
+{
+    void MempoolPayloads::Add(const PTransactionRef& ptx)
+    {
+        if (!ptx || !ptx->GetHash() || !ptx->GetType())
+            return;
+
+        LOCK(m_mutex);
+
+        if (!m_payloads.emplace(*ptx->GetHash(), ptx).second)
+            return;
+
+        if (ptx->GetString1())
+            m_byAddress[*ptx->GetString1()][(int) *ptx->GetType()].insert(*ptx->GetHash());
+    }
+
+    void MempoolPayloads::Remove(const string& hash)
+    {
+        LOCK(m_mutex);
+
+        auto it = m_payloads.find(hash);
+        if (it == m_payloads.end())
+            return;
+
+        const auto& ptx = it->second;
+        if (ptx->GetString1())
+        {
+            auto addressIt = m_byAddress.find(*ptx->GetString1());
+            if (addressIt != m_byAddress.end())
+            {
+                auto typeIt = addressIt->second.find((int) *ptx->GetType());
+                if (typeIt != addressIt->second.end())
+                {
+                    typeIt->second.erase(hash);
+                    if (typeIt->second.empty())
+                        addressIt->second.erase(typeIt);
+                }
+
+                if (addressIt->second.empty())
+                    m_byAddress.erase(addressIt);
+            }
+        }
+
+        m_payloads.erase(it);
+    }
+
+    void MempoolPayloads::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_payloads.clear();
+        m_byAddress.clear();
+    }
+
+    PTransactionRef MempoolPayloads::Get(const string& hash)
+    {
+        LOCK(m_mutex);
+
+        auto it = m_payloads.find(hash);
+        return it != m_payloads.end() ? it->second : nullptr;
+    }
+
+    int MempoolPayloads::Count(const string& address, const vector<TxType>& types, const function<bool(const PTransactionRef&)>& filter)
+    {
+        LOCK(m_mutex);
+
+        auto addressIt = m_byAddress.find(address);
+        if (addressIt == m_byAddress.end())
+            return 0;
+
+        int result = 0;
+        for (const auto& type : types)
+        {
+            auto typeIt = addressIt->second.find((int) type);
+            if (typeIt == addressIt->second.end())
+                continue;
+
+            if (!filter)
+            {
+                result += (int) typeIt->second.size();
+                continue;
+            }
+
+            for (const auto& hash : typeIt->second)
+                if (filter(m_payloads[hash]))
+                    result += 1;
+        }
+
+        return result;
+    }
+
+    size_t MempoolPayloads::Size()
+    {
+        LOCK(m_mutex);
+        return m_payloads.size();
+    }
+} // namespace PocketDb
@@ -0,0 +1,49 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_MEMPOOLPAYLOADS_H
+#define POCKETDB_MEMPOOLPAYLOADS_H
+
+#include <sync.h>
+
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "pocketdb/helpers/TransactionHelper.h"
+
+namespace PocketDb
+{
+    using namespace std;
+    using namespace PocketTx;
+    using namespace PocketHelpers;
+
+    // Payloads of transactions in node mempool indexed by address (String1) and type.
+    // Filled by CTxMemPool on add and remove - mempool consensus counters, miner and relay
+    // read payloads here instead of unconfirmed rows of Transactions table.
+    class MempoolPayloads
+    {
+    public:
+        void Add(const PTransactionRef& ptx);
+        void Remove(const string& hash);
+        void Clear();
+
+        // Payload of mempool transaction or nullptr
+        PTransactionRef Get(const string& hash);
+
+        // Count of address mempool transactions with types matched filter
+        int Count(const string& address, const vector<TxType>& types, const function<bool(const PTransactionRef&)>& filter = nullptr);
+
+        size_t Size();
+
+    private:
+        Mutex m_mutex;
+        unordered_map<string, PTransactionRef> m_payloads;
+        unordered_map<string, unordered_map<int, unordered_set<string>>> m_byAddress;
+    };
+
+    extern MempoolPayloads MempoolPayloadsInst;
+} // namespace PocketDb
+
+#endif // POCKETDB_MEMPOOLPAYLOADS_H
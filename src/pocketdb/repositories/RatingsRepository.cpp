@@ -6,123 +6,223 @@
 
 namespace PocketDb
 {
-    void RatingsRepository::InsertRatings(shared_ptr<vector<Rating>> ratings)
+    static const int64_t DEFAULT_LIKERS_CACHE_SIZE = 64;
+
+    void RatingsRepository::Init()
     {
-        for (const auto& rating: *ratings)
-        {
-            switch (*rating.GetType())
-            {
-            case RatingType::ACCOUNT_LIKERS:
-            case RatingType::ACCOUNT_LIKERS_POST:
-            case RatingType::ACCOUNT_LIKERS_COMMENT_ROOT:
-            case RatingType::ACCOUNT_LIKERS_COMMENT_ANSWER:
-            case RatingType::ACCOUNT_DISLIKERS_COMMENT_ANSWER:
-                InsertLiker(rating);
-                break;
-            default:
-                InsertRating(rating);
-                break;
-            }
-        }
+        LOCK(m_likersMutex);
+        m_likersMaxCount = (size_t) std::max((int64_t) 0, gArgs.GetArg("-likerscachesize", DEFAULT_LIKERS_CACHE_SIZE)) * 1024 * 1024 / sizeof(int);
     }
 
-    bool RatingsRepository::ExistsLiker(int addressId, int likerId, const vector<RatingType>& types)
+    void RatingsRepository::InsertRatings(shared_ptr<vector<Rating>> ratings)
     {
-        bool result = false;
-        
-        string sql = R"sql(
-            select 1
-            from Ratings indexed by Ratings_Type_Id_Value
-            where Type in ( )sql" + join(vector<string>(types.size(), "?"), ",") + R"sql( )
-                and Id = ?
-                and Value = ?
-        )sql";
+        if (ratings->empty())
+            return;
+
+        // All ratings produced by one block have the same height
+        int height = *ratings->front().GetHeight();
 
         TryTransactionStep(__func__, [&]()
         {
-            auto stmt = SetupSqlStatement(sql);
-
-            int i = 1;
-            for (const auto& type: types)
-                TryBindStatementInt(stmt, i++, type);
-            TryBindStatementInt(stmt, i++, addressId);
-            TryBindStatementInt(stmt, i++, likerId);
-
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
-                result = true;
+            // Stage block ratings in connection-local temp table
+            // Likers are inserted as is, other ratings accumulated with previous Last value
+            auto stmtStage = SetupSqlStatement(R"sql(
+                create temp table if not exists RatingsStage
+                (
+                    Type       int not null,
+                    Id         int not null,
+                    Value      int not null,
+                    Accumulate int not null
+                )
+            )sql");
+            TryStepStatement(stmtStage);
 
-            FinalizeSqlStatement(*stmt);
-        });
+            auto stmtClear = SetupSqlStatement(R"sql(
+                delete from temp.RatingsStage
+            )sql");
+            TryStepStatement(stmtClear);
 
-        return result;
-    }
+            auto stmtInsertStage = SetupSqlStatement(R"sql(
+                insert into temp.RatingsStage (Type, Id, Value, Accumulate) values (?,?,?,?)
+            )sql");
+            for (const auto& rating: *ratings)
+            {
+                TryBindStatementInt(stmtInsertStage, 1, *rating.GetType());
+                TryBindStatementInt64(stmtInsertStage, 2, rating.GetId());
+                TryBindStatementInt64(stmtInsertStage, 3, rating.GetValue());
+                TryBindStatementInt(stmtInsertStage, 4, IsLikerType(*rating.GetType()) ? 0 : 1);
+                TryStepStatementReuse(stmtInsertStage);
+            }
+            FinalizeSqlStatement(*stmtInsertStage);
 
-    void RatingsRepository::InsertRating(const Rating& rating)
-    {
-        TryTransactionStep(__func__, [&]()
-        {
-            // Insert new Last record
-            auto stmt = SetupSqlStatement(R"sql(
-                INSERT OR FAIL INTO Ratings (
+            // Insert new Last records
+            auto stmtInsert = SetupSqlStatement(R"sql(
+                insert or fail into Ratings (
                     Type,
                     Last,
                     Height,
                     Id,
                     Value
-                ) SELECT ?,1,?,?,
-                    ifnull((
-                        select r.Value
-                        from Ratings r indexed by Ratings_Type_Id_Last_Height
-                        where r.Type = ?
-                            and r.Last = 1
-                            and r.Id = ?
-                            and r.Height < ?
-                        limit 1
-                    ), 0) + ?
+                )
+                select
+                    s.Type,
+                    1,
+                    ?,
+                    s.Id,
+                    s.Value + (
+                        case when s.Accumulate = 1 then ifnull((
+                            select r.Value
+                            from Ratings r indexed by Ratings_Type_Id_Last_Height
+                            where r.Type = s.Type
+                                and r.Last = 1
+                                and r.Id = s.Id
+                                and r.Height < ?
+                            limit 1
+                        ), 0) else 0 end
+                    )
+                from temp.RatingsStage s
             )sql");
-            TryBindStatementInt(stmt, 1, *rating.GetType());
-            TryBindStatementInt(stmt, 2, rating.GetHeight());
-            TryBindStatementInt64(stmt, 3, rating.GetId());
-            TryBindStatementInt(stmt, 4, *rating.GetType());
-            TryBindStatementInt64(stmt, 5, rating.GetId());
-            TryBindStatementInt(stmt, 6, rating.GetHeight());
-            TryBindStatementInt64(stmt, 7, rating.GetValue());
-            TryStepStatement(stmt);
-
-            // Clear old Last record
+            TryBindStatementInt(stmtInsert, 1, height);
+            TryBindStatementInt(stmtInsert, 2, height);
+            TryStepStatement(stmtInsert);
+
+            // Clear old Last records of accumulated ratings
             auto stmtUpdate = SetupSqlStatement(R"sql(
                 update Ratings indexed by Ratings_Type_Id_Last_Height
                   set Last = 0
-                where Type = ?
+                where (Type, Id) in (
+                    select s.Type, s.Id
+                    from temp.RatingsStage s
+                    where s.Accumulate = 1
+                  )
                   and Last = 1
-                  and Id = ?
                   and Height < ?
             )sql");
-            TryBindStatementInt(stmtUpdate, 1, *rating.GetType());
-            TryBindStatementInt64(stmtUpdate, 2, rating.GetId());
-            TryBindStatementInt(stmtUpdate, 3, rating.GetHeight());
+            TryBindStatementInt(stmtUpdate, 1, height);
             TryStepStatement(stmtUpdate);
+
+            auto stmtClearEnd = SetupSqlStatement(R"sql(
+                delete from temp.RatingsStage
+            )sql");
+            TryStepStatement(stmtClearEnd);
         });
+
+        ExtendLikers(*ratings);
     }
 
-    void RatingsRepository::InsertLiker(const Rating& rating)
+    bool RatingsRepository::ExistsLiker(int addressId, int likerId, const vector<RatingType>& types)
+    {
+        LOCK(m_likersMutex);
+
+        auto& likers = LoadLikers(addressId);
+        for (const auto& type: types)
+        {
+            auto it = likers.find(type);
+            if (it != likers.end() && binary_search(it->second.begin(), it->second.end(), likerId))
+                return true;
+        }
+
+        return false;
+    }
+
+    void RatingsRepository::ResetLikers()
     {
+        LOCK(m_likersMutex);
+        m_likers.clear();
+        m_likersCount = 0;
+    }
+
+    map<int, vector<int>>& RatingsRepository::LoadLikers(int addressId)
+    {
+        auto it = m_likers.find(addressId);
+        if (it != m_likers.end())
+            return it->second;
+
+        map<int, vector<int>> likers;
+
         TryTransactionStep(__func__, [&]()
         {
-            auto stmtInsert = SetupSqlStatement(R"sql(
-                insert or fail into Ratings (
-                    Type,
-                    Last,
-                    Height,
-                    Id,
-                    Value
-                ) values ( ?,1,?,?,? )
+            auto stmt = SetupSqlStatement(R"sql(
+                select Type, Value
+                from Ratings indexed by Ratings_Type_Id_Value
+                where Type in (?,?,?,?,?)
+                  and Id = ?
             )sql");
-            TryBindStatementInt(stmtInsert, 1, *rating.GetType());
-            TryBindStatementInt(stmtInsert, 2, rating.GetHeight());
-            TryBindStatementInt64(stmtInsert, 3, rating.GetId());
-            TryBindStatementInt64(stmtInsert, 4, rating.GetValue());
-            TryStepStatement(stmtInsert);
+
+            TryBindStatementInt(stmt, 1, RatingType::ACCOUNT_LIKERS);
+            TryBindStatementInt(stmt, 2, RatingType::ACCOUNT_LIKERS_POST);
+            TryBindStatementInt(stmt, 3, RatingType::ACCOUNT_LIKERS_COMMENT_ROOT);
+            TryBindStatementInt(stmt, 4, RatingType::ACCOUNT_LIKERS_COMMENT_ANSWER);
+            TryBindStatementInt(stmt, 5, RatingType::ACCOUNT_DISLIKERS_COMMENT_ANSWER);
+            TryBindStatementInt(stmt, 6, addressId);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okType, type] = TryGetColumnInt(*stmt, 0);
+                auto[okValue, value] = TryGetColumnInt(*stmt, 1);
+                if (okType && okValue)
+                    likers[type].push_back(value);
+            }
+
+            FinalizeSqlStatement(*stmt);
         });
+
+        size_t count = 0;
+        for (auto& [type, ids] : likers)
+        {
+            sort(ids.begin(), ids.end());
+            ids.erase(unique(ids.begin(), ids.end()), ids.end());
+            count += ids.size();
+        }
+
+        // Simple bound for memory usage - start index from scratch when full
+        if (m_likersCount + count > m_likersMaxCount)
+        {
+            m_likers.clear();
+            m_likersCount = 0;
+        }
+
+        m_likersCount += count;
+        return m_likers.emplace(addressId, std::move(likers)).first->second;
+    }
+
+    void RatingsRepository::ExtendLikers(const vector<Rating>& ratings)
+    {
+        LOCK(m_likersMutex);
+
+        for (const auto& rating: ratings)
+        {
+            if (!IsLikerType(*rating.GetType()))
+                continue;
+
+            // Not loaded accounts will read new likers from db on first probe
+            auto it = m_likers.find((int) *rating.GetId());
+            if (it == m_likers.end())
+                continue;
+
+            auto& ids = it->second[*rating.GetType()];
+            int likerId = (int) *rating.GetValue();
+            auto pos = lower_bound(ids.begin(), ids.end(), likerId);
+            if (pos != ids.end() && *pos == likerId)
+                continue;
+
+            ids.insert(pos, likerId);
+            m_likersCount += 1;
+        }
+    }
+
+    bool RatingsRepository::IsLikerType(RatingType type)
+    {
+        switch (type)
+        {
+        case RatingType::ACCOUNT_LIKERS:
+        case RatingType::ACCOUNT_LIKERS_POST:
+        case RatingType::ACCOUNT_LIKERS_COMMENT_ROOT:
+        case RatingType::ACCOUNT_LIKERS_COMMENT_ANSWER:
+        case RatingType::ACCOUNT_DISLIKERS_COMMENT_ANSWER:
+            return true;
+        default:
+            return false;
+        }
     }
 }
@@ -6,6 +6,7 @@
 #define SRC_RATINGSREPOSITORY_H
 
 #include <util/system.h>
+#include <sync.h>
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 
@@ -26,7 +27,7 @@ namespace PocketDb
     public:
         explicit RatingsRepository(SQLiteDatabase& db) : BaseRepository(db) {}
 
-        void Init() override {}
+        void Init() override;
 
         void Destroy() override {}
 
@@ -35,11 +36,23 @@ namespace PocketDb
         bool ExistsLiker(int addressId, int likerId);
         bool ExistsLiker(int addressId, int likerId, const vector<RatingType>& types);
 
+        // Drop in-memory likers index - rolled back ratings will be reloaded from db
+        void ResetLikers();
+
     private:
 
-        void InsertRating(const Rating& rating);
+        // Likers stored as is, other ratings accumulated over previous Last value
+        static bool IsLikerType(RatingType type);
+
+        // In-memory likers index: account Id -> liker type -> sorted liker Ids
+        // Account loads from Ratings on first probe and extends with new block likers
+        Mutex m_likersMutex;
+        unordered_map<int, map<int, vector<int>>> m_likers;
+        size_t m_likersCount = 0;
+        size_t m_likersMaxCount = 0;
 
-        void InsertLiker(const Rating& rating);
+        map<int, vector<int>>& LoadLikers(int addressId);
+        void ExtendLikers(const vector<Rating>& ratings);
 
     }; // namespace PocketDb
 }
@@ -19,9 +19,14 @@ namespace PocketDb
     public:
         tuple<bool, string> TryGetColumnString(sqlite3_stmt* stmt, int index)
         {
-            return sqlite3_column_type(stmt, index) == SQLITE_NULL
-                   ? make_tuple(false, "")
-                   : make_tuple(true, string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, index))));
+            if (sqlite3_column_type(stmt, index) == SQLITE_NULL)
+                return make_tuple(false, "");
+
+            // sqlite3_column_bytes must be called after sqlite3_column_text for a correct length
+            auto text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+            auto size = (size_t) sqlite3_column_bytes(stmt, index);
+
+            return make_tuple(true, string(text, size));
         }
 
         tuple<bool, int64_t> TryGetColumnInt64(sqlite3_stmt* stmt, int index)
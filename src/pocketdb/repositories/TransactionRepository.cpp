@@ -9,175 +9,188 @@ namespace PocketDb
     class TransactionReconstructor : public RowAccessor
     {
     public:
-        TransactionReconstructor() {};
-
         /**
-         * Pass a new row for reconstructor to collect all necessary data from it.
-         * @param stmt - sqlite stmt. Null is not allowed and will potentially cause a segfault
-         * Returns boolean result of collecting data. If false is returned - all data inside reconstructor is possibly corrupted due to bad input (missing columns, etc)
-         * and it should not be used anymore
-         * 
-         * Columns: PartType (0), TxHash (1), ...
-         * PartTypes: 0 Tx, 1 Payload, 2 Input, 3 Output
+         * Slots for transactions are allocated once in the order of requested hashes,
+         * so every row is routed by a single hash lookup without rebalancing a tree
+         * and the result keeps the caller's order.
+         * @param txHashes - requested transaction hashes
          */
-        bool FeedRow(sqlite3_stmt* stmt)
+        explicit TransactionReconstructor(const vector<string>& txHashes)
         {
-            auto[okPartType, partType] = TryGetColumnInt(stmt, 0);
-            if (!okPartType) return false;
-
-            auto[okTxHash, txHash] = TryGetColumnString(stmt, 1);
-            if (!okTxHash) return false;
+            m_index.reserve(txHashes.size());
+            m_transactions.resize(txHashes.size());
 
-            if (partType > 0 && m_transactions.find(txHash) == m_transactions.end())
-                return false;
-
-            switch (partType)
-            {
-                case 0: {
-                    auto[ok, ptx] = ParseTransaction(stmt, txHash);
-                    if (!ok) return false;
-
-                    ptx->SetHash(txHash);
-                    m_transactions.emplace(txHash, ptx);
-                    
-                    return true;
-                }
-                case 1:
-                    return ParsePayload(stmt, m_transactions[txHash]);
-                case 2:
-                    return ParseInput(stmt, m_transactions[txHash], txHash);
-                case 3:
-                    return ParseOutput(stmt, m_transactions[txHash], txHash);
-                default:
-                    return false;
-            }
+            for (size_t i = 0; i < txHashes.size(); i++)
+                m_index.emplace(txHashes[i], i);
         }
 
         /**
-         * Return contructed block.
+         * Each Feed* method accepts a row of its own typed query with the columns listed below.
+         * @param stmt - sqlite stmt. Null is not allowed and will potentially cause a segfault
+         * Returns boolean result of collecting data. If false is returned - all data inside reconstructor is possibly corrupted due to bad input (missing columns, etc)
+         * and it should not be used anymore
+         *
+         * Index:   0     1     2     3          4       5     6   7        8        9        10       11       12
+         * Columns: Hash, Type, Time, BlockHash, Height, Last, Id, String1, String2, String3, String4, String5, Int1
          */
-        PocketBlockRef GetResult()
+        bool FeedTransaction(sqlite3_stmt* stmt)
         {
-            PocketBlockRef pocketBlock = make_shared<PocketBlock>();
-            for (const auto[txHash, ptx] : m_transactions)
-                pocketBlock->push_back(ptx);
-
-            return pocketBlock;
-        }
-
-    private:
-
-        map<string, PTransactionRef> m_transactions;
+            auto[txHash, slot] = FindSlot(stmt, 0);
+            if (!slot) return false;
 
-        /**
-         * This method parses transaction data, constructs if needed and return construct entry to fill
-         * Index:   0  1     2     3     4          5       6     7   8        9        10       11       12       13    14    15
-         * Columns: 0, Hash, Type, Time, BlockHash, Height, Last, Id, String1, String2, String3, String4, String5, null, null, Int1
-         */
-        tuple<bool, PTransactionRef> ParseTransaction(sqlite3_stmt* stmt, const string& txHash)
-        {
             // Try get Type and create pocket transaction instance
-            auto[okType, txType] = TryGetColumnInt(stmt, 2);
-            if (!okType) return {false, nullptr};
+            auto[okType, txType] = TryGetColumnInt(stmt, 1);
+            if (!okType) return false;
             
             PTransactionRef ptx = PocketHelpers::TransactionHelper::CreateInstance(static_cast<TxType>(txType));
-            if (!ptx) return {false, nullptr};
+            if (!ptx) return false;
+
+            ptx->SetHash(*txHash);
 
             // Required fields
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 3); ok) ptx->SetTime(value);
-            else return {false, nullptr};
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 2); ok) ptx->SetTime(value);
+            else return false;
 
             // Optional fields
-            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) ptx->SetBlockHash(value);
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 5); ok) ptx->SetHeight(value);
-            if (auto[ok, value] = TryGetColumnInt(stmt, 6); ok) ptx->SetLast(value == 1);
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 7); ok) ptx->SetId(value);
-            if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) ptx->SetString1(value);
-            if (auto[ok, value] = TryGetColumnString(stmt, 9); ok) ptx->SetString2(value);
-            if (auto[ok, value] = TryGetColumnString(stmt, 10); ok) ptx->SetString3(value);
-            if (auto[ok, value] = TryGetColumnString(stmt, 11); ok) ptx->SetString4(value);
-            if (auto[ok, value] = TryGetColumnString(stmt, 12); ok) ptx->SetString5(value);
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 15); ok) ptx->SetInt1(value);
-
-            return {true, ptx};
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) ptx->SetBlockHash(std::move(value));
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 4); ok) ptx->SetHeight(value);
+            if (auto[ok, value] = TryGetColumnInt(stmt, 5); ok) ptx->SetLast(value == 1);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 6); ok) ptx->SetId(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 7); ok) ptx->SetString1(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) ptx->SetString2(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 9); ok) ptx->SetString3(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 10); ok) ptx->SetString4(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 11); ok) ptx->SetString5(std::move(value));
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 12); ok) ptx->SetInt1(value);
+
+            *slot = ptx;
+            return true;
         }
 
         /**
-         * Parse Payload
-         * Index:   0  1       2     3     4     5     6     7     8        9        10       11       12       13       14       15
-         * Columns: 1, TxHash, null, null, null, null, null, null, String1, String2, String3, String4, String5, String6, String7, Int1
+         * Index:   0       1        2        3        4        5        6        7        8
+         * Columns: TxHash, String1, String2, String3, String4, String5, String6, String7, Int1
          */
-        bool ParsePayload(sqlite3_stmt* stmt, PTransactionRef& ptx)
+        bool FeedPayload(sqlite3_stmt* stmt)
         {
+            auto[txHash, slot] = FindSlot(stmt, 0);
+            if (!slot || !*slot) return false;
+
+            auto& ptx = *slot;
+
             ptx->GeneratePayload();
+            auto& payload = *ptx->GetPayload();
 
-            if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) { ptx->GetPayload()->SetString1(value); }
-            if (auto[ok, value] = TryGetColumnString(stmt, 9); ok) { ptx->GetPayload()->SetString2(value); }
-            if (auto[ok, value] = TryGetColumnString(stmt, 10); ok) { ptx->GetPayload()->SetString3(value); }
-            if (auto[ok, value] = TryGetColumnString(stmt, 11); ok) { ptx->GetPayload()->SetString4(value); }
-            if (auto[ok, value] = TryGetColumnString(stmt, 12); ok) { ptx->GetPayload()->SetString5(value); }
-            if (auto[ok, value] = TryGetColumnString(stmt, 13); ok) { ptx->GetPayload()->SetString6(value); }
-            if (auto[ok, value] = TryGetColumnString(stmt, 14); ok) { ptx->GetPayload()->SetString7(value); }
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 15); ok) { ptx->GetPayload()->SetInt1(value); }
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) payload.SetString1(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) payload.SetString2(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 3); ok) payload.SetString3(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) payload.SetString4(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) payload.SetString5(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 6); ok) payload.SetString6(std::move(value));
+            if (auto[ok, value] = TryGetColumnString(stmt, 7); ok) payload.SetString7(std::move(value));
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 8); ok) payload.SetInt1(value);
 
             return true;
         }
 
         /**
-         * Parse Inputs
-         * Index:   0  1              2     3     4         5         6        7     8              9     10    11    12    13    14    15
-         * Columns: 2, i.SpentTxHash, null, null, i.TxHash, i.Number, o.Value, null, o.AddressHash, null, null, null, null, null, null, null
+         * Index:   0              1         2         3        4
+         * Columns: i.SpentTxHash, i.TxHash, i.Number, o.Value, o.AddressHash
          */
-        bool ParseInput(sqlite3_stmt* stmt, PTransactionRef& ptx, const string& txHash)
+        bool FeedInput(sqlite3_stmt* stmt)
         {
+            auto[txHash, slot] = FindSlot(stmt, 0);
+            if (!slot || !*slot) return false;
+
+            auto& ptx = *slot;
+
             bool incomplete = false;
 
             TransactionInput input;
-            input.SetSpentTxHash(txHash);
+            input.SetSpentTxHash(*txHash);
 
-            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) input.SetTxHash(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 1); ok) input.SetTxHash(std::move(value));
             else incomplete = true;
 
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 5); ok) input.SetNumber(value);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 2); ok) input.SetNumber(value);
             else incomplete = true;
 
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 6); ok) input.SetValue(value);
-            if (auto[ok, value] = TryGetColumnString(stmt, 8); ok) input.SetAddressHash(value);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 3); ok) input.SetValue(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) input.SetAddressHash(std::move(value));
 
-            ptx->Inputs().push_back(input);
+            ptx->Inputs().push_back(std::move(input));
             return !incomplete;
         }
 
         /**
-         * Parse Outputs
-         * Index:   0  1       2     3       4            5      6     7     8     9     10            11    12    13    14           15
-         * Columns: 3, TxHash, null, Number, AddressHash, Value, null, null, null, null, ScriptPubKey, null, null, null, SpentTxHash, SpentHeight
+         * Index:   0       1       2            3      4             5            6
+         * Columns: TxHash, Number, AddressHash, Value, ScriptPubKey, SpentTxHash, SpentHeight
          */
-        bool ParseOutput(sqlite3_stmt* stmt, PTransactionRef& ptx, const string& txHash)
+        bool FeedOutput(sqlite3_stmt* stmt)
         {
+            auto[txHash, slot] = FindSlot(stmt, 0);
+            if (!slot || !*slot) return false;
+
+            auto& ptx = *slot;
+
             bool incomplete = false;
 
             TransactionOutput output;
-            output.SetTxHash(txHash);
+            output.SetTxHash(*txHash);
 
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 3); ok) output.SetNumber(value);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 1); ok) output.SetNumber(value);
             else incomplete = true;
 
-            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) output.SetAddressHash(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 2); ok) output.SetAddressHash(std::move(value));
             else incomplete = true;
 
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 5); ok) output.SetValue(value);
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 3); ok) output.SetValue(value);
             else incomplete = true;
 
-            if (auto[ok, value] = TryGetColumnString(stmt, 10); ok) output.SetScriptPubKey(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 4); ok) output.SetScriptPubKey(std::move(value));
             else incomplete = true;
 
-            if (auto[ok, value] = TryGetColumnString(stmt, 14); ok) output.SetSpentTxHash(value);
-            if (auto[ok, value] = TryGetColumnInt64(stmt, 15); ok) output.SetSpentHeight(value);
+            if (auto[ok, value] = TryGetColumnString(stmt, 5); ok) output.SetSpentTxHash(std::move(value));
+            if (auto[ok, value] = TryGetColumnInt64(stmt, 6); ok) output.SetSpentHeight(value);
 
-            ptx->Outputs().push_back(output);
+            ptx->Outputs().push_back(std::move(output));
             return !incomplete;
         }
+
+        /**
+         * Return contructed block in order of requested hashes.
+         */
+        PocketBlockRef GetResult()
+        {
+            PocketBlockRef pocketBlock = make_shared<PocketBlock>();
+            pocketBlock->reserve(m_transactions.size());
+
+            for (auto& ptx : m_transactions)
+                if (ptx)
+                    pocketBlock->push_back(std::move(ptx));
+
+            return pocketBlock;
+        }
+
+    private:
+
+        unordered_map<string, size_t> m_index;
+        vector<PTransactionRef> m_transactions;
+
+        /**
+         * Route row to the slot of requested transaction by hash in column `index`.
+         * Returns nullptrs if the hash was not requested.
+         */
+        tuple<const string*, PTransactionRef*> FindSlot(sqlite3_stmt* stmt, int index)
+        {
+            auto[okTxHash, txHash] = TryGetColumnString(stmt, index);
+            if (!okTxHash) return {nullptr, nullptr};
+
+            auto it = m_index.find(txHash);
+            if (it == m_index.end()) return {nullptr, nullptr};
+
+            return {&it->first, &m_transactions[it->second]};
+        }
     };
 
     void TransactionRepository::InsertTransactions(PocketBlock& pocketBlock)
@@ -208,73 +221,66 @@ namespace PocketDb
     {
         string txReplacers = join(vector<string>(txHashes.size(), "?"), ",");
 
-        auto sql = R"sql(
-            select (0)tp, Hash, Type, Time, BlockHash, Height, Last, Id, String1, String2, String3, String4, String5, null, null, Int1
+        // Every part is read with its own typed query - rows are routed to already
+        // allocated transactions, so no union, padding or sorting of parts is required
+        auto txSql = R"sql(
+            select Hash, Type, Time, BlockHash, Height, Last, Id, String1, String2, String3, String4, String5, Int1
             from Transactions
             where Hash in ( )sql" + txReplacers + R"sql( )
-        )sql" +
+        )sql";
 
-        // Payload part
-        (includePayload ? string(R"sql(
-            union
-            select (1)tp, TxHash, null, null, null, null, null, null, String1, String2, String3, String4, String5, String6, String7, Int1
+        auto payloadSql = R"sql(
+            select TxHash, String1, String2, String3, String4, String5, String6, String7, Int1
             from Payload
             where TxHash in ( )sql" + txReplacers + R"sql( )
-        )sql") : "") +
+        )sql";
 
-        // Inputs part
-        (includeInputs ? string(R"sql(
-            union
-            select (2)tp, i.SpentTxHash, null, null, i.TxHash, i.Number, o.Value, null, o.AddressHash, null, null, null, null, null, null, null
+        auto inputsSql = R"sql(
+            select i.SpentTxHash, i.TxHash, i.Number, o.Value, o.AddressHash
             from TxInputs i
             join TxOutputs o on o.TxHash = i.TxHash and o.Number = i.Number
             where i.SpentTxHash in ( )sql" + txReplacers + R"sql( )
-        )sql") : "") +
-        
-        // Outputs part
-        (includeOutputs ? string(R"sql(
-            union
-            select (3)tp, TxHash, null, Number, AddressHash, Value, null, null, null, null, ScriptPubKey, null, null, null, SpentTxHash, SpentHeight
+        )sql";
+
+        auto outputsSql = R"sql(
+            select TxHash, Number, AddressHash, Value, ScriptPubKey, SpentTxHash, SpentHeight
             from TxOutputs
             where TxHash in ( )sql" + txReplacers + R"sql( )
-        )sql") : "") +
+            order by TxHash, Number
+        )sql";
 
-        string(R"sql(
-            order by tp asc
-        )sql");
-        
-        TransactionReconstructor reconstructor;
+        TransactionReconstructor reconstructor(txHashes);
 
         TryTransactionStep(__func__, [&]()
         {
-            auto stmt = SetupSqlStatement(sql);
-            size_t i = 1;
-
-            for (auto& txHash : txHashes)
-                TryBindStatementText(stmt, i++, txHash);
-            
-            if (includePayload)
-                for (auto& txHash : txHashes)
-                    TryBindStatementText(stmt, i++, txHash);
-
-            if (includeInputs)
-                for (auto& txHash : txHashes)
-                    TryBindStatementText(stmt, i++, txHash);
+            auto feed = [&](const string& sql, bool(TransactionReconstructor::*feeder)(sqlite3_stmt*))
+            {
+                auto stmt = SetupSqlStatement(sql);
 
-            if (includeOutputs)
+                int i = 1;
                 for (auto& txHash : txHashes)
                     TryBindStatementText(stmt, i++, txHash);
 
-            while (sqlite3_step(*stmt) == SQLITE_ROW)
-            {
-                // TODO (aok): maybe throw exception if errors?
-                if (!reconstructor.FeedRow(*stmt))
+                while (sqlite3_step(*stmt) == SQLITE_ROW)
                 {
-                    break;
+                    // TODO (aok): maybe throw exception if errors?
+                    if (!(reconstructor.*feeder)(*stmt))
+                        break;
                 }
-            }
 
-            FinalizeSqlStatement(*stmt);
+                FinalizeSqlStatement(*stmt);
+            };
+
+            feed(txSql, &TransactionReconstructor::FeedTransaction);
+
+            if (includePayload)
+                feed(payloadSql, &TransactionReconstructor::FeedPayload);
+
+            if (includeInputs)
+                feed(inputsSql, &TransactionReconstructor::FeedInput);
+
+            if (includeOutputs)
+                feed(outputsSql, &TransactionReconstructor::FeedOutput);
         });
 
         return reconstructor.GetResult();
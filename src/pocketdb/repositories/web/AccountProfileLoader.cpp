@@ -0,0 +1,242 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/repositories/web/AccountProfileLoader.h"
+
+#include <util/time.h>
+
+namespace PocketDb
+{
+    static const int64_t DEFAULT_PROFILE_BATCH_WINDOW = 2;
+    static const int64_t PROFILE_CACHE_TTL_SECONDS = 10;
+    static const size_t MAX_BATCH_ADDRESSES = 1000;
+    static const size_t MAX_CACHE_ENTRIES = 100000;
+
+    void AccountProfileLoader::Init()
+    {
+        LOCK(m_mutex);
+        m_windowMicros = std::max((int64_t) 0, gArgs.GetArg("-profilebatchwindow", DEFAULT_PROFILE_BATCH_WINDOW)) * 1000;
+        m_ttlMicros = PROFILE_CACHE_TTL_SECONDS * 1000000;
+    }
+
+    map<string, UniValue> AccountProfileLoader::Load(const vector<string>& addresses, bool shortForm, int firstFlagsDepth,
+        const QueryFunc& query)
+    {
+        map<string, UniValue> result;
+        if (addresses.empty())
+            return result;
+
+        m_requests++;
+        m_requestedAddresses += addresses.size();
+
+        FormKey form{shortForm, firstFlagsDepth};
+        vector<string> missed;
+        shared_ptr<Batch> batch;
+        bool leader = false;
+
+        {
+            LOCK(m_mutex);
+
+            int64_t now = GetTimeMicros();
+            for (const auto& address : addresses)
+            {
+                auto it = m_cache.find(address);
+                if (it != m_cache.end())
+                {
+                    auto entry = it->second.find(form);
+                    if (entry != it->second.end() && entry->second.Expire > now)
+                    {
+                        result.insert_or_assign(address, entry->second.Value);
+                        continue;
+                    }
+                }
+
+                missed.push_back(address);
+            }
+
+            m_cacheHits += addresses.size() - missed.size();
+            if (missed.empty())
+                return result;
+
+            // Join batch collecting addresses now or open new one
+            auto open = m_open.find(form);
+            if (open != m_open.end() && open->second->Addresses.size() + missed.size() <= MAX_BATCH_ADDRESSES)
+            {
+                batch = open->second;
+            }
+            else
+            {
+                batch = make_shared<Batch>();
+                leader = true;
+
+                if (m_windowMicros > 0)
+                    m_open[form] = batch;
+            }
+
+            batch->Addresses.insert(missed.begin(), missed.end());
+        }
+
+        if (leader)
+        {
+            RunBatch(form, batch, query);
+        }
+        else
+        {
+            WAIT_LOCK(m_mutex, lock);
+            while (!batch->Done)
+                m_cond.wait(lock);
+        }
+
+        m_batchedRequests++;
+
+        if (!batch->Error.empty())
+            throw std::runtime_error(batch->Error);
+
+        for (const auto& address : missed)
+        {
+            auto it = batch->Result.find(address);
+            if (it != batch->Result.end())
+                result.insert_or_assign(address, it->second);
+        }
+
+        return result;
+    }
+
+    void AccountProfileLoader::RunBatch(const FormKey& form, const shared_ptr<Batch>& batch, const QueryFunc& query)
+    {
+        if (m_windowMicros > 0)
+            UninterruptibleSleep(std::chrono::microseconds{m_windowMicros});
+
+        vector<string> addresses;
+        uint64_t generation;
+        {
+            LOCK(m_mutex);
+
+            // Batch is closed - later requests open new one
+            auto it = m_open.find(form);
+            if (it != m_open.end() && it->second == batch)
+                m_open.erase(it);
+
+            addresses.assign(batch->Addresses.begin(), batch->Addresses.end());
+            generation = m_generation;
+        }
+
+        vector<tuple<string, int64_t, UniValue>> rows;
+        string error;
+        try
+        {
+            rows = query(addresses);
+        }
+        catch (const std::exception& ex)
+        {
+            error = ex.what();
+        }
+
+        m_queries++;
+        m_queriedAddresses += addresses.size();
+
+        {
+            LOCK(m_mutex);
+
+            // Profiles loaded while a block was indexing are returned but not shared
+            int64_t now = GetTimeMicros();
+            for (auto& [address, id, value] : rows)
+            {
+                if (generation == m_generation)
+                    PutLocked(form, address, value, now);
+
+                batch->Result.insert_or_assign(address, std::move(value));
+            }
+
+            batch->Error = error;
+            batch->Done = true;
+        }
+
+        m_cond.notify_all();
+    }
+
+    void AccountProfileLoader::PutLocked(const FormKey& form, const string& address, const UniValue& value, int64_t now)
+    {
+        if (m_ttlMicros <= 0)
+            return;
+
+        if (m_cacheCount >= MAX_CACHE_ENTRIES)
+        {
+            for (auto it = m_cache.begin(); it != m_cache.end();)
+            {
+                for (auto entry = it->second.begin(); entry != it->second.end();)
+                {
+                    if (entry->second.Expire <= now)
+                    {
+                        entry = it->second.erase(entry);
+                        m_cacheCount--;
+                    }
+                    else
+                    {
+                        entry++;
+                    }
+                }
+
+                it = it->second.empty() ? m_cache.erase(it) : std::next(it);
+            }
+
+            if (m_cacheCount >= MAX_CACHE_ENTRIES)
+            {
+                m_cache.clear();
+                m_cacheCount = 0;
+            }
+        }
+
+        auto& forms = m_cache[address];
+        if (forms.find(form) == forms.end())
+            m_cacheCount++;
+
+        forms.insert_or_assign(form, CacheEntry{value, now + m_ttlMicros});
+    }
+
+    void AccountProfileLoader::Invalidate(const vector<string>& addresses)
+    {
+        LOCK(m_mutex);
+
+        // Increment before erase - queries started earlier must not return dropped values to cache
+        m_generation++;
+
+        for (const auto& address : addresses)
+        {
+            auto it = m_cache.find(address);
+            if (it == m_cache.end())
+                continue;
+
+            m_cacheCount -= it->second.size();
+            m_cache.erase(it);
+        }
+    }
+
+    void AccountProfileLoader::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_generation++;
+        m_cache.clear();
+        m_cacheCount = 0;
+    }
+
+    UniValue AccountProfileLoader::GetStatistic()
+    {
+        uint64_t batchedRequests = m_batchedRequests.load();
+        uint64_t queries = m_queries.load();
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("requests", (int64_t) m_requests.load());
+        result.pushKV("addresses", (int64_t) m_requestedAddresses.load());
+        result.pushKV("cachehits", (int64_t) m_cacheHits.load());
+        result.pushKV("queries", (int64_t) queries);
+        result.pushKV("queriedaddresses", (int64_t) m_queriedAddresses.load());
+        // Requests served by one query and part of sql calls saved by batching
+        result.pushKV("avgbatchsize", queries > 0 ? (double) batchedRequests / (double) queries : 0.0);
+        result.pushKV("sqlreduction", batchedRequests > 0 ? 1.0 - (double) queries / (double) batchedRequests : 0.0);
+
+        return result;
+    }
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_ACCOUNTPROFILELOADER_H
+#define POCKETDB_ACCOUNTPROFILELOADER_H
+
+#include <sync.h>
+#include <util/system.h>
+#include <univalue.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+namespace PocketDb
+{
+    using namespace std;
+
+    // Loads account profiles for web requests of all threads.
+    // Requests with the same form arriving within -profilebatchwindow are merged into one query:
+    // first request waits the window, selects profiles for all collected addresses with own connection
+    // and fans results out to waiting requests.
+    // Loaded profiles are shared for a short time and dropped earlier when account changed by block.
+    class AccountProfileLoader
+    {
+    public:
+        using QueryFunc = function<vector<tuple<string, int64_t, UniValue>>(const vector<string>& addresses)>;
+
+        void Init();
+
+        map<string, UniValue> Load(const vector<string>& addresses, bool shortForm, int firstFlagsDepth, const QueryFunc& query);
+
+        // Drop profiles of accounts changed at height
+        void Invalidate(const vector<string>& addresses);
+
+        void Clear();
+
+        // Requests and queries counters for monitoring batching efficiency
+        UniValue GetStatistic();
+
+    private:
+        using FormKey = pair<bool, int>;
+
+        struct Batch
+        {
+            set<string> Addresses;
+            bool Done = false;
+            string Error;
+            map<string, UniValue> Result;
+        };
+
+        struct CacheEntry
+        {
+            UniValue Value;
+            int64_t Expire;
+        };
+
+        Mutex m_mutex;
+        std::condition_variable m_cond;
+        // Batches collecting addresses during window
+        map<FormKey, shared_ptr<Batch>> m_open;
+
+        unordered_map<string, map<FormKey, CacheEntry>> m_cache;
+        size_t m_cacheCount = 0;
+        uint64_t m_generation = 0;
+
+        int64_t m_windowMicros = 0;
+        int64_t m_ttlMicros = 0;
+
+        atomic<uint64_t> m_requests{0};
+        atomic<uint64_t> m_requestedAddresses{0};
+        atomic<uint64_t> m_cacheHits{0};
+        atomic<uint64_t> m_batchedRequests{0};
+        atomic<uint64_t> m_queries{0};
+        atomic<uint64_t> m_queriedAddresses{0};
+
+        void RunBatch(const FormKey& form, const shared_ptr<Batch>& batch, const QueryFunc& query);
+        void PutLocked(const FormKey& form, const string& address, const UniValue& value, int64_t now);
+    };
+
+    extern AccountProfileLoader AccountProfileLoaderInst;
+} // namespace PocketDb
+
+#endif // POCKETDB_ACCOUNTPROFILELOADER_H
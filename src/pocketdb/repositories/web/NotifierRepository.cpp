@@ -459,24 +459,26 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPostCountFromMySubscribes(const string& address, int height)
+    map<string, UniValue> NotifierRepository::GetPostCountFromMySubscribes(int height)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
 
+        // Counts for all subscribers of authors published in block - one pass instead of query per connection
         string sql = R"sql(
-            select count(1) as cntTotal,
-                   ifnull((case when post.Type = 200 then 1 else 0 end),0) as cntPost,
-                   ifnull((case when post.Type = 201 then 1 else 0 end),0) as cntVideo,
-                   ifnull((case when post.Type = 202 then 1 else 0 end),0) as cntArticle,
-                   ifnull((case when post.Type = 209 then 1 else 0 end),0) as cntStream,
-                   ifnull((case when post.Type = 210 then 1 else 0 end),0) as cntAudio
-            from Transactions sub
-            join Transactions post
-                on post.String1 = sub.String2 and post.Type in (200, 201, 202, 209, 210, 203) and post.Last = 1
-            where sub.Type in (302, 303)
-              and sub.Last = 1
+            select sub.String1 as address,
+                   count(1) as cntTotal,
+                   sum(case when post.Type = 200 then 1 else 0 end) as cntPost,
+                   sum(case when post.Type = 201 then 1 else 0 end) as cntVideo,
+                   sum(case when post.Type = 202 then 1 else 0 end) as cntArticle,
+                   sum(case when post.Type = 209 then 1 else 0 end) as cntStream,
+                   sum(case when post.Type = 210 then 1 else 0 end) as cntAudio
+            from Transactions post indexed by Transactions_Height_Type
+            join Transactions sub indexed by Transactions_Type_Last_String2_Height
+                on sub.Type in (302, 303) and sub.Last = 1 and sub.String2 = post.String1
+            where post.Type in (200, 201, 202, 209, 210, 203)
+              and post.Last = 1
               and post.Height = ?
-              and sub.String1 = ?
+            group by sub.String1
         )sql";
 
         TryTransactionStep(__func__, [&]()
@@ -484,16 +486,21 @@ namespace PocketDb
             auto stmt = SetupSqlStatement(sql);
 
             TryBindStatementInt(stmt, 1, height);
-            TryBindStatementText(stmt, 2, address);
 
-            if (sqlite3_step(*stmt) == SQLITE_ROW)
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 0); ok) result.pushKV("cntTotal", value);
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 1); ok) result.pushKV("cntPost", value);
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 2); ok) result.pushKV("cntVideo", value);
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 3); ok) result.pushKV("cntArticle", value);
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 4); ok) result.pushKV("cntStream", value);
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 5); ok) result.pushKV("cntAudio", value);
+                auto[okAddress, address] = TryGetColumnString(*stmt, 0);
+                if (!okAddress) continue;
+
+                UniValue record(UniValue::VOBJ);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 1); ok) record.pushKV("cntTotal", value);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 2); ok) record.pushKV("cntPost", value);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 3); ok) record.pushKV("cntVideo", value);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 4); ok) record.pushKV("cntArticle", value);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 5); ok) record.pushKV("cntStream", value);
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 6); ok) record.pushKV("cntAudio", value);
+
+                result.emplace(address, record);
             }
 
             FinalizeSqlStatement(*stmt);
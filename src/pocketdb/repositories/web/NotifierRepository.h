@@ -28,7 +28,7 @@ namespace PocketDb
         UniValue GetSubscribeAddressTo(const string& subscribeHash);
         UniValue GetCommentInfoAddressByScore(const string& commentScoreHash);
         UniValue GetFullCommentInfo(const string& commentHash);
-        UniValue GetPostCountFromMySubscribes(const string& address, int height);
+        map<string, UniValue> GetPostCountFromMySubscribes(int height);
     };
 
     typedef shared_ptr<NotifierRepository> NotifierRepositoryRef;
@@ -14,11 +14,21 @@ namespace PocketDb
     {
         UniValue result(UniValue::VARR);
 
-        string keyword = "%" + request.Keyword + "%";
+        // Plain substring search - escape like wildcards of keyword
+        string keyword = "%";
+        for (char c : request.Keyword)
+        {
+            if (c == '%' || c == '_' || c == '\\')
+                keyword += '\\';
+            keyword += c;
+        }
+        keyword += "%";
+
         string sql = R"sql(
-            select Value
-            from Tags t indexed by Tags_Value
-            where t.Value match ?
+            select t.Value
+            from web.Tags t
+            where t.Value like ? escape '\'
+            order by t.Value, t.Lang
             limit ?
             offset ?
         )sql";
@@ -126,6 +136,11 @@ namespace PocketDb
 
             cross join Payload p on p.TxHash=t.Hash
 
+            left join Ratings r indexed by Ratings_Type_Id_Last_Value
+                on r.Type = 0
+                and r.Id = t.Id
+                and r.Last = 1
+
             where t.Last = 1
                 and t.Type = 100
                 and t.Height is not null
@@ -134,8 +149,9 @@ namespace PocketDb
                 and f.Value match ?
         )sql";
 
+        // Ranked by reputation, then by shorter name - same order as SearchIndex::SearchUsers
         if (request.OrderByRank)
-            sql += " order by rank, t.Id ";
+            sql += " order by ifnull(r.Value, 0) desc, length(cast(f.Value as blob)), t.Id ";
 
         sql += " limit ? ";
         sql += " offset ? ";
@@ -164,65 +180,44 @@ namespace PocketDb
         return result;
     }
 
-    vector<int64_t> SearchRepository::SearchUsers(const string& keyword)
+    vector<int64_t> SearchRepository::SearchUsersByField(const string& func, ContentFieldType fieldType, const string& keyword, int count)
     {
-        auto func = __func__;
         vector<int64_t> result;
 
         string _keyword = "\"" + keyword + "\"" + " OR " + keyword + "*";
 
         string sql = R"sql(
-            select names.* from (
-                select
-                      fm.ContentId
-                    , ROW_NUMBER() OVER ( ORDER BY RANK, length(f.Value) ) as ROWNUMBER
-                    , RANK as RNK
-                    , r.Value as Rating
-                from web.Content f
-                join web.ContentMap fm on fm.ROWID = f.ROWID
-                left join Ratings r on r.Id = fm.ContentId and r.Last = 1 and r.Type = 0
-                where fm.FieldType in (?)
-                    and f.Value match ?
-                limit ?
-            ) names
-
-            union
-
-            select about.* from (
-                select
-                      fm.ContentId
-                    , ROW_NUMBER() OVER ( ORDER BY r.Value DESC) as ROWNUMBER
-                    , RANK as RNK
-                    , r.Value as Rating
-                from web.Content f
-                join web.ContentMap fm on fm.ROWID = f.ROWID
-                left join Ratings r on r.Id = fm.ContentId and r.Last = 1 and r.Type = 0
-                where fm.FieldType in (?)
-                    and f.Value match ?
-                limit ?
-            ) about
-
-            order by ROWNUMBER, RNK, Rating desc
+            select fm.ContentId
+            from web.Content f
+            join web.ContentMap fm on fm.ROWID = f.ROWID
+            cross join Transactions u indexed by Transactions_Last_Id_Height
+                on u.Id = fm.ContentId
+                and u.Last = 1
+                and u.Type = 100
+                and u.Height is not null
+            left join Ratings r indexed by Ratings_Type_Id_Last_Value
+                on r.Type = 0
+                and r.Id = fm.ContentId
+                and r.Last = 1
+            where fm.FieldType = ?
+                and f.Value match ?
+            order by ifnull(r.Value, 0) desc, length(cast(f.Value as blob)), fm.ContentId
+            limit ?
         )sql";
 
-        TryTransactionStep(__func__, [&]()
+        TryTransactionStep(func, [&]()
         {
             int i = 1;
             auto stmt = SetupSqlStatement(sql);
 
-            TryBindStatementInt(stmt, i++, (int)ContentFieldType::ContentFieldType_AccountUserName);
+            TryBindStatementInt(stmt, i++, (int) fieldType);
             TryBindStatementText(stmt, i++, _keyword);
-            TryBindStatementInt(stmt, i++, 10);
-
-            TryBindStatementInt(stmt, i++, (int)ContentFieldType::ContentFieldType_AccountUserAbout);
-            TryBindStatementText(stmt, i++, _keyword);
-            TryBindStatementInt(stmt, i++, 10);
+            TryBindStatementInt(stmt, i++, count);
 
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
                 if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
-                    if (find(result.begin(), result.end(), value) == result.end())
-                        result.push_back(value);
+                    result.push_back(value);
             }
 
             FinalizeSqlStatement(*stmt);
@@ -231,6 +226,16 @@ namespace PocketDb
         return result;
     }
 
+    vector<int64_t> SearchRepository::SearchUsersNames(const string& keyword, int count)
+    {
+        return SearchUsersByField(__func__, ContentFieldType::ContentFieldType_AccountUserName, keyword, count);
+    }
+
+    vector<int64_t> SearchRepository::SearchUsersAbout(const string& keyword, int count)
+    {
+        return SearchUsersByField(__func__, ContentFieldType::ContentFieldType_AccountUserAbout, keyword, count);
+    }
+
     vector<string> SearchRepository::GetRecommendedAccountByAddressSubscriptions(const string& address, string& addressExclude, const vector<int>& contentTypes, const string& lang, int cntOut, int nHeight, int depth)
     {
         auto func = __func__;
@@ -32,12 +32,19 @@ namespace PocketDb
         vector<int64_t> SearchIds(const SearchRequest& request);
 
         vector<int64_t> SearchUsersOld(const SearchRequest& request);
-        vector<int64_t> SearchUsers(const string& keyword);
+        // Actual accounts by name ranked by reputation - same order as SearchIndex::SearchUsers
+        vector<int64_t> SearchUsersNames(const string& keyword, int count);
+        // Actual accounts by about field ranked by reputation
+        vector<int64_t> SearchUsersAbout(const string& keyword, int count);
 
         vector<string> GetRecommendedAccountByAddressSubscriptions(const string& address, string& addressExclude, const vector<int>& contentTypes, const string& lang, int cntOut, int nHeight, int depth = 129600 /* about 3 month */);
         vector<int64_t> GetRecommendedContentByAddressSubscriptions(const string& contentAddress, string& address, const vector<int>& contentTypes, const string& lang, int cntOut, int nHeight, int depth = 129600 /* about 3 month */);
         vector<int64_t> GetRandomContentByAddress(const string& contentAddress, const vector<int>& contentTypes, const string& lang, int cntOut);
         vector<int64_t> GetContentFromAddressSubscriptions(const string& address, const vector<int>& contentTypes, const string& lang, int cntOut, bool rest = false);
+
+    private:
+        // Actual accounts with matched field - deleted accounts are skipped
+        vector<int64_t> SearchUsersByField(const string& func, ContentFieldType fieldType, const string& keyword, int count);
     };
 
     typedef shared_ptr<SearchRepository> SearchRepositoryRef;
@@ -0,0 +1,140 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/repositories/web/WebContentCache.h"
+
+namespace PocketDb
+{
+    static const int64_t DEFAULT_CONTENT_CACHE_SIZE = 64;
+
+    void WebContentCache::Init()
+    {
+        LOCK(m_mutex);
+        m_maxBytes = (size_t) std::max((int64_t) 0, gArgs.GetArg("-contentcachesize", DEFAULT_CONTENT_CACHE_SIZE)) << 20;
+    }
+
+    string WebContentCache::ContentKey(int64_t id)
+    {
+        return "#" + to_string(id);
+    }
+
+    size_t WebContentCache::EntrySize(const string& key, const WebContentCacheEntry& value)
+    {
+        // Approximate overhead of map node, lru node and shared value
+        return key.size() * 2 + value.Address.size() + value.Json.size() + 128;
+    }
+
+    unordered_map<int64_t, WebContentCacheEntryRef> WebContentCache::GetContents(const vector<int64_t>& ids)
+    {
+        unordered_map<int64_t, WebContentCacheEntryRef> result;
+
+        LOCK(m_mutex);
+        for (int64_t id : ids)
+        {
+            if (auto value = Find(ContentKey(id)))
+                result.emplace(id, value);
+        }
+
+        return result;
+    }
+
+    void WebContentCache::PutContent(int64_t id, WebContentCacheEntryRef value, uint64_t generation)
+    {
+        LOCK(m_mutex);
+        Put(ContentKey(id), std::move(value), generation);
+    }
+
+    unordered_map<string, WebContentCacheEntryRef> WebContentCache::GetProfiles(const vector<string>& addresses)
+    {
+        unordered_map<string, WebContentCacheEntryRef> result;
+
+        LOCK(m_mutex);
+        for (const auto& address : addresses)
+        {
+            if (auto value = Find(address))
+                result.emplace(address, value);
+        }
+
+        return result;
+    }
+
+    void WebContentCache::PutProfile(const string& address, WebContentCacheEntryRef value, uint64_t generation)
+    {
+        LOCK(m_mutex);
+        Put(address, std::move(value), generation);
+    }
+
+    void WebContentCache::Invalidate(const vector<int64_t>& contentIds, const vector<string>& addresses)
+    {
+        LOCK(m_mutex);
+
+        // Increment before erase - loads started earlier must not return dropped values to cache
+        m_generation++;
+
+        for (int64_t id : contentIds)
+        {
+            auto it = m_entries.find(ContentKey(id));
+            if (it != m_entries.end())
+                Erase(it);
+        }
+
+        for (const auto& address : addresses)
+        {
+            auto it = m_entries.find(address);
+            if (it != m_entries.end())
+                Erase(it);
+        }
+    }
+
+    void WebContentCache::Clear()
+    {
+        LOCK(m_mutex);
+
+        m_generation++;
+        m_entries.clear();
+        m_lru.clear();
+        m_bytes = 0;
+    }
+
+    size_t WebContentCache::Size()
+    {
+        LOCK(m_mutex);
+        return m_entries.size();
+    }
+
+    WebContentCacheEntryRef WebContentCache::Find(const string& key)
+    {
+        auto it = m_entries.find(key);
+        if (it == m_entries.end())
+            return nullptr;
+
+        m_lru.splice(m_lru.begin(), m_lru, it->second.LruIt);
+        return it->second.Value;
+    }
+
+    void WebContentCache::Put(const string& key, WebContentCacheEntryRef value, uint64_t generation)
+    {
+        auto size = EntrySize(key, *value);
+        if (generation != m_generation.load() || size > m_maxBytes)
+            return;
+
+        auto it = m_entries.find(key);
+        if (it != m_entries.end())
+            Erase(it);
+
+        while (!m_lru.empty() && m_bytes + size > m_maxBytes)
+            Erase(m_entries.find(m_lru.back()));
+
+        m_lru.push_front(key);
+        m_entries.emplace(key, CacheEntry{ std::move(value), m_lru.begin() });
+        m_bytes += size;
+    }
+
+    void WebContentCache::Erase(unordered_map<string, CacheEntry>::iterator it)
+    {
+        m_bytes -= EntrySize(it->first, *it->second.Value);
+        m_lru.erase(it->second.LruIt);
+        m_entries.erase(it);
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_WEBCONTENTCACHE_H
+#define POCKETDB_WEBCONTENTCACHE_H
+
+#include <sync.h>
+#include <util/system.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace PocketDb
+{
+    using namespace std;
+
+    // Serialized part of web response that is the same for all users
+    struct WebContentCacheEntry
+    {
+        // Author of content, empty for profiles
+        string Address;
+        // Members of content object without counters and personal values, or whole short profile object
+        string Json;
+    };
+
+    using WebContentCacheEntryRef = shared_ptr<const WebContentCacheEntry>;
+
+    // Node-wide LRU cache of content bodies and authors short profiles for contents hydration,
+    // bounded with total size of serialized values.
+    // Entries changed by a new block are dropped after block indexing, all entries on rollback.
+    // Values loaded from db while a block was indexing are not stored, same as in AccountStateCache.
+    class WebContentCache
+    {
+    public:
+        void Init();
+
+        // Generation must be taken before loading values from db and passed to Put
+        uint64_t Generation() const { return m_generation.load(); }
+
+        unordered_map<int64_t, WebContentCacheEntryRef> GetContents(const vector<int64_t>& ids);
+        void PutContent(int64_t id, WebContentCacheEntryRef value, uint64_t generation);
+
+        unordered_map<string, WebContentCacheEntryRef> GetProfiles(const vector<string>& addresses);
+        void PutProfile(const string& address, WebContentCacheEntryRef value, uint64_t generation);
+
+        // Drop contents and profiles changed at height
+        void Invalidate(const vector<int64_t>& contentIds, const vector<string>& addresses);
+
+        void Clear();
+
+        size_t Size();
+
+    private:
+        struct CacheEntry
+        {
+            WebContentCacheEntryRef Value;
+            list<string>::iterator LruIt;
+        };
+
+        Mutex m_mutex;
+        unordered_map<string, CacheEntry> m_entries;
+        list<string> m_lru;
+        size_t m_maxBytes = 0;
+        size_t m_bytes = 0;
+        atomic<uint64_t> m_generation{0};
+
+        static string ContentKey(int64_t id);
+        static size_t EntrySize(const string& key, const WebContentCacheEntry& value);
+
+        WebContentCacheEntryRef Find(const string& key);
+        void Put(const string& key, WebContentCacheEntryRef value, uint64_t generation);
+        void Erase(unordered_map<string, CacheEntry>::iterator it);
+    };
+
+    extern WebContentCache WebContentCacheInst;
+} // namespace PocketDb
+
+#endif // POCKETDB_WEBCONTENTCACHE_H
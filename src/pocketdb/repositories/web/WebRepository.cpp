@@ -10,24 +10,26 @@ namespace PocketDb
 
     void WebRepository::Destroy() {}
 
-    vector<WebTag> WebRepository::GetContentTags(const string& blockHash)
+    vector<WebTag> WebRepository::GetContentTags(int heightMin, int heightMax)
     {
         vector<WebTag> result;
 
         string sql = R"sql(
             select distinct p.Id, pp.String1, json_each.value
-            from Transactions p indexed by Transactions_BlockHash
+            from Transactions p indexed by Transactions_Type_Last_Height_Id
             join Payload pp on pp.TxHash = p.Hash
             join json_each(pp.String4)
             where p.Type in (200, 201, 202, 209, 210)
               and p.Last = 1
-              and p.BlockHash = ?
+              and p.Height between ? and ?
+            order by p.Id
         )sql";
 
         TryTransactionStep(__func__, [&]()
         {
             auto stmt = SetupSqlStatement(sql);
-            TryBindStatementText(stmt, 1, blockHash);
+            TryBindStatementInt(stmt, 1, heightMin);
+            TryBindStatementInt(stmt, 2, heightMax);
 
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
@@ -103,7 +105,7 @@ namespace PocketDb
         });
     }
 
-    vector<WebContent> WebRepository::GetContent(const string& blockHash)
+    vector<WebContent> WebRepository::GetContent(int heightMin, int heightMax)
     {
         vector<WebContent> result;
 
@@ -118,16 +120,18 @@ namespace PocketDb
                 p.String5,
                 p.String6,
                 p.String7
-            from Transactions t indexed by Transactions_BlockHash
+            from Transactions t indexed by Transactions_Type_Last_Height_Id
             join Payload p on p.TxHash = t.Hash
-            where t.BlockHash = ?
-              and t.Type in (100, 200, 201, 202, 209, 210, 204, 205)
+            where t.Type in (100, 200, 201, 202, 209, 210, 204, 205)
+              and t.Last = 1
+              and t.Height between ? and ?
        )sql";
        
        TryTransactionStep(__func__, [&]()
        {
            auto stmt = SetupSqlStatement(sql);
-           TryBindStatementText(stmt, 1, blockHash);
+           TryBindStatementInt(stmt, 1, heightMin);
+           TryBindStatementInt(stmt, 2, heightMax);
 
            while (sqlite3_step(*stmt) == SQLITE_ROW)
            {
@@ -245,35 +249,59 @@ namespace PocketDb
             // ---------------------------------------------------------
             int64_t nTime3 = GetTimeMicros();
 
+            // Stage new values in connection-local temp table with one prepared statement
+            auto stmtStage = SetupSqlStatement(R"sql(
+                create temp table if not exists ContentStage
+                (
+                    ContentId int not null,
+                    FieldType int not null,
+                    Value     text not null
+                )
+            )sql");
+            TryStepStatement(stmtStage);
+
+            auto stmtStageClear = SetupSqlStatement(R"sql(
+                delete from temp.ContentStage
+            )sql");
+            TryStepStatement(stmtStageClear);
+
+            auto stmtStageInsert = SetupSqlStatement(R"sql(
+                insert into temp.ContentStage (ContentId, FieldType, Value) values (?,?,?)
+            )sql");
             for (const auto& contentItm : contentList)
             {
-                SetLastInsertRowId(0);
-
-                auto stmtMap = SetupSqlStatement(R"sql(
-                    insert or ignore into ContentMap (ContentId, FieldType) values (?,?)
-                )sql");
-                TryBindStatementInt64(stmtMap, 1, contentItm.ContentId);
-                TryBindStatementInt(stmtMap, 2, (int)contentItm.FieldType);
-                TryStepStatement(stmtMap);
+                TryBindStatementInt64(stmtStageInsert, 1, contentItm.ContentId);
+                TryBindStatementInt(stmtStageInsert, 2, (int)contentItm.FieldType);
+                TryBindStatementText(stmtStageInsert, 3, contentItm.Value);
+                TryStepStatementReuse(stmtStageInsert);
+            }
+            FinalizeSqlStatement(*stmtStageInsert);
 
-                // ---------------------------------------------------------
+            auto stmtMap = SetupSqlStatement(R"sql(
+                insert or ignore into web.ContentMap (ContentId, FieldType)
+                select s.ContentId, s.FieldType
+                from temp.ContentStage s
+                order by s.ROWID
+            )sql");
+            TryStepStatement(stmtMap);
+
+            // Index all values in one pass - first value wins for duplicated content field
+            auto stmtContent = SetupSqlStatement(R"sql(
+                replace into web.Content (ROWID, Value)
+                select cm.ROWID, s.Value
+                from (
+                    select ContentId, FieldType, Value, min(ROWID)
+                    from temp.ContentStage
+                    group by ContentId, FieldType
+                ) s
+                join web.ContentMap cm on cm.ContentId = s.ContentId and cm.FieldType = s.FieldType
+            )sql");
+            TryStepStatement(stmtContent);
 
-                auto lastRowId = GetLastInsertRowId();
-                if (lastRowId > 0)
-                {
-                    auto stmtContent = SetupSqlStatement(R"sql(
-                        replace into web.Content (ROWID, Value) values (?,?)
-                    )sql");
-                    TryBindStatementInt64(stmtContent, 1, lastRowId);
-                    TryBindStatementText(stmtContent, 2, contentItm.Value);
-                    TryStepStatement(stmtContent);
-                }
-                else
-                {
-                    LogPrintf("Warning: content (%d) field (%d) not indexed in search db\n",
-                        contentItm.ContentId, (int)contentItm.FieldType);
-                }
-            }
+            auto stmtStageEnd = SetupSqlStatement(R"sql(
+                delete from temp.ContentStage
+            )sql");
+            TryStepStatement(stmtStageEnd);
 
             // ---------------------------------------------------------
             int64_t nTime4 = GetTimeMicros();
@@ -288,6 +316,46 @@ namespace PocketDb
         });
     }
 
+    void WebRepository::ConfigureContentIndex()
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            // Less merge work while inserting blocks - segments merged by MergeContentIndex
+            auto stmtAutomerge = SetupSqlStatement(R"sql(
+                insert into web.Content (Content, rank) values ('automerge', 8)
+            )sql");
+            TryStepStatement(stmtAutomerge);
+
+            auto stmtCrisismerge = SetupSqlStatement(R"sql(
+                insert into web.Content (Content, rank) values ('crisismerge', 32)
+            )sql");
+            TryStepStatement(stmtCrisismerge);
+        });
+    }
+
+    void WebRepository::MergeContentIndex(int pages)
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                insert into web.Content (Content, rank) values ('merge', ?)
+            )sql");
+            TryBindStatementInt(stmt, 1, pages);
+            TryStepStatement(stmt);
+        });
+    }
+
+    void WebRepository::OptimizeContentIndex()
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                insert into web.Content (Content) values ('optimize')
+            )sql");
+            TryStepStatement(stmt);
+        });
+    }
+
     void WebRepository::CalculateSharkAccounts(BadgeSharkConditions& cond)
     {
         TryTransactionStep(__func__, [&]()
@@ -323,6 +391,97 @@ namespace PocketDb
         });
     }
 
+    void WebRepository::UpdateSharkAccounts(BadgeSharkConditions& cond, int prevHeight)
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmtStage = SetupSqlStatement(R"sql(
+                create temp table if not exists BadgesStage
+                (
+                    AccountId int not null primary key
+                )
+            )sql");
+            TryStepStatement(stmtStage);
+
+            auto stmtStageClear = SetupSqlStatement(R"sql(
+                delete from temp.BadgesStage
+            )sql");
+            TryStepStatement(stmtStageClear);
+
+            // Accounts that can change badge since previous pass:
+            // new liker ratings, account changes and deletes, registration depth reached
+            auto stmtCandidates = SetupSqlStatement(R"sql(
+                insert or ignore into temp.BadgesStage (AccountId)
+
+                select r.Id
+                from Ratings r indexed by Ratings_Height_Last
+                where r.Height > ?
+                  and r.Height <= ?
+                  and r.Type in (111,112,113)
+
+                union
+
+                select t.Id
+                from Transactions t indexed by Transactions_Height_Type
+                where t.Height > ?
+                  and t.Height <= ?
+                  and t.Type in (100,170)
+
+                union
+
+                select t.Id
+                from Transactions t indexed by Transactions_Height_Type
+                where t.Height >= ?
+                  and t.Height < ?
+                  and t.Type in (100)
+            )sql");
+            int i = 1;
+            TryBindStatementInt(stmtCandidates, i++, prevHeight);
+            TryBindStatementInt(stmtCandidates, i++, cond.Height);
+            TryBindStatementInt(stmtCandidates, i++, prevHeight);
+            TryBindStatementInt(stmtCandidates, i++, cond.Height);
+            TryBindStatementInt64(stmtCandidates, i++, prevHeight - cond.RegistrationDepth);
+            TryBindStatementInt64(stmtCandidates, i++, cond.Height - cond.RegistrationDepth);
+            TryStepStatement(stmtCandidates);
+
+            auto stmtDelete = SetupSqlStatement(R"sql(
+                delete from web.Badges
+                where Badge = 1
+                  and AccountId in (select s.AccountId from temp.BadgesStage s)
+            )sql");
+            TryStepStatement(stmtDelete);
+
+            // Same conditions as CalculateSharkAccounts for candidates only
+            auto stmtInsert = SetupSqlStatement(R"sql(
+                insert into web.Badges (AccountId, Badge)
+                select u.Id, 1
+                from temp.BadgesStage s
+                cross join Transactions u indexed by Transactions_Id_Last
+                  on u.Id = s.AccountId and u.Last = 1
+                where u.Type in (100)
+                  and u.Height is not null
+                  and ifnull((select sum(r.Value) from Ratings r where r.Type in (111,112,113) and r.Last = 1 and r.Id = u.Id),0) >= ?
+                  and ifnull((select r.Value from Ratings r where r.Type = 111 and r.Last = 1 and r.Id = u.Id),0) >= ?
+                  and ifnull((select r.Value from Ratings r where r.Type = 112 and r.Last = 1 and r.Id = u.Id),0) >= ?
+                  and ifnull((select r.Value from Ratings r where r.Type = 113 and r.Last = 1 and r.Id = u.Id),0) >= ?
+                  and ? - (select min(reg1.Height) from Transactions reg1 indexed by Transactions_Id where reg1.Id = u.Id) > ?
+            )sql");
+            i = 1;
+            TryBindStatementInt(stmtInsert, i++, cond.LikersAll);
+            TryBindStatementInt64(stmtInsert, i++, cond.LikersContent);
+            TryBindStatementInt64(stmtInsert, i++, cond.LikersComment);
+            TryBindStatementInt64(stmtInsert, i++, cond.LikersAnswer);
+            TryBindStatementInt64(stmtInsert, i++, cond.Height);
+            TryBindStatementInt64(stmtInsert, i++, cond.RegistrationDepth);
+            TryStepStatement(stmtInsert);
+
+            auto stmtStageClearEnd = SetupSqlStatement(R"sql(
+                delete from temp.BadgesStage
+            )sql");
+            TryStepStatement(stmtStageClearEnd);
+        });
+    }
+
     void WebRepository::CalculateValidAuthors(int blockHeight)
     {
         TryTransactionStep(__func__, [&]()
@@ -373,4 +532,381 @@ namespace PocketDb
             TryStepStatement(stmtInsert);
         });
     }
-}
\ No newline at end of file
+
+    void WebRepository::IndexEventsInbox(int heightMin, int heightMax)
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            // Remove events of rolled back blocks
+            auto stmtClear = SetupSqlStatement(R"sql(
+                delete from web.EventsInbox
+                where Height >= ?
+            )sql");
+            TryBindStatementInt(stmtClear, 1, heightMin);
+            TryStepStatement(stmtClear);
+
+            // Addresses notified by transactions of blocks - same events as in GetNotificationsSummary
+            auto stmtInsert = SetupSqlStatement(R"sql(
+                insert into web.EventsInbox (AddressHash, ActorHash, Height, BlockNum, Type, TxHash)
+
+                -- Referals
+                select t.String2, t.String1, t.Height, t.BlockNum, ?, t.Hash
+                from Transactions t indexed by Transactions_Height_Type
+                where t.Type = 100
+                  and t.Height between ? and ?
+                  and t.String2 is not null
+                  and t.ROWID = (select min(tt.ROWID) from Transactions tt indexed by Transactions_Id where tt.Id = t.Id)
+
+                union all
+
+                -- Comments for my content
+                select p.String1, c.String1, c.Height, c.BlockNum, ?, c.Hash
+                from Transactions c indexed by Transactions_Height_Type
+                join Transactions p indexed by Transactions_Type_Last_String2_Height
+                    on p.Type in (200,201,202,209,210)
+                    and p.Last = 1
+                    and p.String2 = c.String3
+                    and p.Height > 0
+                    and p.String1 != c.String1
+                where c.Type = 204
+                  and c.Height between ? and ?
+                  and c.String4 is null
+                  and c.String5 is null
+
+                union all
+
+                -- Subscribers
+                select subs.String2, subs.String1, subs.Height, subs.BlockNum, ?, subs.Hash
+                from Transactions subs indexed by Transactions_Height_Type
+                where subs.Type in (302, 303)
+                  and subs.Height between ? and ?
+
+                union all
+
+                -- Comment scores
+                select c.String1, s.String1, s.Height, s.BlockNum, ?, s.Hash
+                from Transactions s indexed by Transactions_Height_Type
+                join Transactions c indexed by Transactions_Type_Last_String2_Height
+                    on c.Type in (204,205)
+                    and c.Last = 1
+                    and c.String2 = s.String2
+                    and c.Height > 0
+                where s.Type = 301
+                  and s.Last = 0
+                  and s.Height between ? and ?
+
+                union all
+
+                -- Content scores
+                select c.String1, s.String1, s.Height, s.BlockNum, ?, s.Hash
+                from Transactions s indexed by Transactions_Height_Type
+                join Transactions c indexed by Transactions_Type_Last_String2_Height
+                    on c.Type in (200,201,202,209,210)
+                    and c.Last = 1
+                    and c.String2 = s.String2
+                    and c.Height > 0
+                where s.Type = 300
+                  and s.Last = 0
+                  and s.Height between ? and ?
+
+                union all
+
+                -- Reposts
+                select p.String1, r.String1, r.Height, r.BlockNum, ?, r.Hash
+                from Transactions r indexed by Transactions_Height_Type
+                join Transactions p indexed by Transactions_Type_Last_String2_Height
+                    on p.Type = 200
+                    and p.Last = 1
+                    and p.String2 = r.String3
+                where r.Type = 200
+                  and r.Height between ? and ?
+                  and r.Hash = r.String2
+                  and r.String3 is not null
+            )sql");
+
+            int i = 1;
+            for (auto type : {
+                ShortTxType::Referal,
+                ShortTxType::Comment,
+                ShortTxType::Subscriber,
+                ShortTxType::CommentScore,
+                ShortTxType::ContentScore,
+                ShortTxType::Repost })
+            {
+                TryBindStatementInt(stmtInsert, i++, (int) type);
+                TryBindStatementInt(stmtInsert, i++, heightMin);
+                TryBindStatementInt(stmtInsert, i++, heightMax);
+            }
+            TryStepStatement(stmtInsert);
+        });
+    }
+
+    void WebRepository::RefreshEventsInbox(int windowMin, int heightMin, int heightMax)
+    {
+        if (windowMin >= heightMin)
+            return;
+
+        // Contents and comments edited or deleted in blocks - events already indexed for them
+        // were calculated with previous version and are recalculated with the last one
+        static const string changedRoots = R"sql(
+            select ch.String2
+            from Transactions ch indexed by Transactions_Height_Type
+            where ch.Type in (200,201,202,204,205,206,207,209,210)
+              and ch.Height between ? and ?
+              and ch.Hash != ch.String2
+        )sql";
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmtClear = SetupSqlStatement(R"sql(
+                delete from web.EventsInbox
+                where Height between ? and ?
+                  and Type in (?,?,?,?)
+                  and TxHash in (
+                    select ev.Hash
+                    from Transactions ev
+                    where ev.Type in (200,204)
+                      and ev.String3 in ( )sql" + changedRoots + R"sql( )
+                    union
+                    select ev.Hash
+                    from Transactions ev
+                    where ev.Type in (300,301)
+                      and ev.String2 in ( )sql" + changedRoots + R"sql( )
+                  )
+            )sql");
+
+            int i = 1;
+            TryBindStatementInt(stmtClear, i++, windowMin);
+            TryBindStatementInt(stmtClear, i++, heightMin - 1);
+            TryBindStatementInt(stmtClear, i++, (int) ShortTxType::Comment);
+            TryBindStatementInt(stmtClear, i++, (int) ShortTxType::CommentScore);
+            TryBindStatementInt(stmtClear, i++, (int) ShortTxType::ContentScore);
+            TryBindStatementInt(stmtClear, i++, (int) ShortTxType::Repost);
+            for (int r = 0; r < 2; r++)
+            {
+                TryBindStatementInt(stmtClear, i++, heightMin);
+                TryBindStatementInt(stmtClear, i++, heightMax);
+            }
+            TryStepStatement(stmtClear);
+
+            // Same events as in IndexEventsInbox restricted to changed contents and comments
+            auto stmtInsert = SetupSqlStatement(R"sql(
+                insert into web.EventsInbox (AddressHash, ActorHash, Height, BlockNum, Type, TxHash)
+
+                -- Comments for my content
+                select p.String1, c.String1, c.Height, c.BlockNum, ?, c.Hash
+                from Transactions c indexed by Transactions_Height_Type
+                join Transactions p indexed by Transactions_Type_Last_String2_Height
+                    on p.Type in (200,201,202,209,210)
+                    and p.Last = 1
+                    and p.String2 = c.String3
+                    and p.Height > 0
+                    and p.String1 != c.String1
+                where c.Type = 204
+                  and c.Height between ? and ?
+                  and c.String4 is null
+                  and c.String5 is null
+                  and c.String3 in ( )sql" + changedRoots + R"sql( )
+
+                union all
+
+                -- Comment scores
+                select c.String1, s.String1, s.Height, s.BlockNum, ?, s.Hash
+                from Transactions s indexed by Transactions_Height_Type
+                join Transactions c indexed by Transactions_Type_Last_String2_Height
+                    on c.Type in (204,205)
+                    and c.Last = 1
+                    and c.String2 = s.String2
+                    and c.Height > 0
+                where s.Type = 301
+                  and s.Last = 0
+                  and s.Height between ? and ?
+                  and s.String2 in ( )sql" + changedRoots + R"sql( )
+
+                union all
+
+                -- Content scores
+                select c.String1, s.String1, s.Height, s.BlockNum, ?, s.Hash
+                from Transactions s indexed by Transactions_Height_Type
+                join Transactions c indexed by Transactions_Type_Last_String2_Height
+                    on c.Type in (200,201,202,209,210)
+                    and c.Last = 1
+                    and c.String2 = s.String2
+                    and c.Height > 0
+                where s.Type = 300
+                  and s.Last = 0
+                  and s.Height between ? and ?
+                  and s.String2 in ( )sql" + changedRoots + R"sql( )
+
+                union all
+
+                -- Reposts
+                select p.String1, r.String1, r.Height, r.BlockNum, ?, r.Hash
+                from Transactions r indexed by Transactions_Height_Type
+                join Transactions p indexed by Transactions_Type_Last_String2_Height
+                    on p.Type = 200
+                    and p.Last = 1
+                    and p.String2 = r.String3
+                where r.Type = 200
+                  and r.Height between ? and ?
+                  and r.Hash = r.String2
+                  and r.String3 in ( )sql" + changedRoots + R"sql( )
+            )sql");
+
+            i = 1;
+            for (auto type : {
+                ShortTxType::Comment,
+                ShortTxType::CommentScore,
+                ShortTxType::ContentScore,
+                ShortTxType::Repost })
+            {
+                TryBindStatementInt(stmtInsert, i++, (int) type);
+                TryBindStatementInt(stmtInsert, i++, windowMin);
+                TryBindStatementInt(stmtInsert, i++, heightMin - 1);
+                TryBindStatementInt(stmtInsert, i++, heightMin);
+                TryBindStatementInt(stmtInsert, i++, heightMax);
+            }
+            TryStepStatement(stmtInsert);
+        });
+    }
+
+    void WebRepository::TrimEventsInbox(int heightMin)
+    {
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                delete from web.EventsInbox
+                where Height < ?
+            )sql");
+            TryBindStatementInt(stmt, 1, heightMin);
+            TryStepStatement(stmt);
+        });
+    }
+
+    vector<pair<string, string>> WebRepository::GetSearchIndexTags()
+    {
+        vector<pair<string, string>> result;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select Value, Lang
+                from web.Tags
+            )sql");
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okValue, value] = TryGetColumnString(*stmt, 0);
+                auto[okLang, lang] = TryGetColumnString(*stmt, 1);
+                if (okValue && okLang)
+                    result.emplace_back(value, lang);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    vector<tuple<int64_t, string, int>> WebRepository::GetSearchIndexUsers()
+    {
+        vector<tuple<int64_t, string, int>> result;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select
+                    u.Id,
+                    p.String2,
+                    ifnull(r.Value, 0)
+                from Transactions u indexed by Transactions_Type_Last_Height_Id
+                join Payload p on p.TxHash = u.Hash
+                left join Ratings r indexed by Ratings_Type_Id_Last_Value
+                    on r.Type = 0 and r.Id = u.Id and r.Last = 1
+                where u.Type = 100
+                  and u.Last = 1
+                  and u.Height is not null
+            )sql");
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okId, id] = TryGetColumnInt64(*stmt, 0);
+                auto[okName, name] = TryGetColumnString(*stmt, 1);
+                auto[okRep, reputation] = TryGetColumnInt(*stmt, 2);
+                if (okId && okName)
+                    result.emplace_back(id, name, okRep ? reputation : 0);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    vector<tuple<int64_t, string, int>> WebRepository::GetSearchIndexUsers(int heightMin, int heightMax)
+    {
+        vector<tuple<int64_t, string, int>> result;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select
+                    u.Id,
+                    (case when u.Type = 100 then p.String2 else null end),
+                    ifnull(r.Value, 0)
+                from Transactions u indexed by Transactions_Type_Last_Height_Id
+                left join Payload p on p.TxHash = u.Hash
+                left join Ratings r indexed by Ratings_Type_Id_Last_Value
+                    on r.Type = 0 and r.Id = u.Id and r.Last = 1
+                where u.Type in (100, 170)
+                  and u.Last = 1
+                  and u.Height between ? and ?
+            )sql");
+            TryBindStatementInt(stmt, 1, heightMin);
+            TryBindStatementInt(stmt, 2, heightMax);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okId, id] = TryGetColumnInt64(*stmt, 0);
+                auto[okName, name] = TryGetColumnString(*stmt, 1);
+                auto[okRep, reputation] = TryGetColumnInt(*stmt, 2);
+                if (okId)
+                    result.emplace_back(id, okName ? name : "", okRep ? reputation : 0);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    vector<tuple<int64_t, int>> WebRepository::GetChangedReputations(int heightMin, int heightMax)
+    {
+        vector<tuple<int64_t, int>> result;
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(R"sql(
+                select r.Id, r.Value
+                from Ratings r indexed by Ratings_Height_Last
+                where r.Height between ? and ?
+                  and r.Last = 1
+                  and r.Type = 0
+            )sql");
+            TryBindStatementInt(stmt, 1, heightMin);
+            TryBindStatementInt(stmt, 2, heightMax);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okId, id] = TryGetColumnInt64(*stmt, 0);
+                auto[okValue, value] = TryGetColumnInt(*stmt, 1);
+                if (okId && okValue)
+                    result.emplace_back(id, value);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+}
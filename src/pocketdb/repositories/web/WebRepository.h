@@ -14,6 +14,7 @@
 #include "pocketdb/repositories/ConsensusRepository.h"
 #include "pocketdb/models/web/WebTag.h"
 #include "pocketdb/models/web/WebContent.h"
+#include "pocketdb/models/shortform/ShortTxType.h"
 
 namespace PocketDb
 {
@@ -30,15 +31,40 @@ namespace PocketDb
         void Init() override;
         void Destroy() override;
 
-        vector<WebTag> GetContentTags(const string& blockHash);
+        // Tags and search fields of actual content versions in heights range
+        vector<WebTag> GetContentTags(int heightMin, int heightMax);
         void UpsertContentTags(const vector<WebTag>& contentTags);
 
-        vector<WebContent> GetContent(const string& blockHash);
+        vector<WebContent> GetContent(int heightMin, int heightMax);
         void UpsertContent(const vector<WebContent>& contentList);
 
+        // FTS5 segments maintenance for web.Content
+        void ConfigureContentIndex();
+        void MergeContentIndex(int pages);
+        void OptimizeContentIndex();
+
         void CalculateSharkAccounts(BadgeSharkConditions& cond);
+        // Re-evaluate shark badge only for accounts changed after prevHeight
+        void UpdateSharkAccounts(BadgeSharkConditions& cond, int prevHeight);
         void CalculateValidAuthors(int blockHeight);
 
+        // Replace inbox events of blocks in heights range with events calculated from chain
+        void IndexEventsInbox(int heightMin, int heightMax);
+        // Recalculate inbox events in [windowMin, heightMin) for contents and comments
+        // edited or deleted in blocks of [heightMin, heightMax]
+        void RefreshEventsInbox(int windowMin, int heightMin, int heightMax);
+        // Remove inbox events older than height
+        void TrimEventsInbox(int heightMin);
+
+        // Source data for in-memory search index: all tags as (Value, Lang)
+        vector<pair<string, string>> GetSearchIndexTags();
+        // Actual accounts as (Id, Name, Reputation)
+        vector<tuple<int64_t, string, int>> GetSearchIndexUsers();
+        // Accounts changed in heights range, deleted accounts have empty name
+        vector<tuple<int64_t, string, int>> GetSearchIndexUsers(int heightMin, int heightMax);
+        // Accounts reputations changed in heights range as (Id, Reputation)
+        vector<tuple<int64_t, int>> GetChangedReputations(int heightMin, int heightMax);
+
         // TODO (aok): расчитать авторов согласно комментариев от акул на их посты
     };
 
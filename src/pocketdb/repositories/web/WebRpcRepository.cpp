@@ -5,6 +5,7 @@
 #include "pocketdb/repositories/web/WebRpcRepository.h"
 
 #include "pocketdb/helpers/ShortFormRepositoryHelper.h"
+#include "pocketdb/helpers/JsonWriter.h"
 
 #include <functional>
 
@@ -673,13 +674,11 @@ namespace PocketDb
 
     map<string, UniValue> WebRpcRepository::GetAccountProfiles(const vector<string>& addresses, bool shortForm, int firstFlagsDepth)
     {
-        map<string, UniValue> result{};
-
-        auto _result = GetAccountProfiles(addresses, {}, shortForm, firstFlagsDepth);
-        for (const auto[address, id, record] : _result)
-            result.insert_or_assign(address, record);
-
-        return result;
+        // Concurrent requests of profiles are merged into one query
+        return AccountProfileLoaderInst.Load(addresses, shortForm, firstFlagsDepth, [&](const vector<string>& batch)
+        {
+            return GetAccountProfiles(batch, {}, shortForm, firstFlagsDepth);
+        });
     }
 
     map<int64_t, UniValue> WebRpcRepository::GetAccountProfiles(const vector<int64_t>& ids, bool shortForm, int firstFlagsDepth)
@@ -2154,10 +2153,9 @@ namespace PocketDb
     UniValue WebRpcRepository::GetContentsForAddress(const string& address)
     {
         auto func = __func__;
-        UniValue result(UniValue::VARR);
 
         if (address.empty())
-            return result;
+            return UniValue(UniValue::VARR);
 
         string sql = R"sql(
             select
@@ -2188,6 +2186,9 @@ namespace PocketDb
             limit 50
         )sql";
 
+        JsonWriter result(16384);
+        result.BeginArray();
+
         TryTransactionStep(func, [&]()
         {
             auto stmt = SetupSqlStatement(sql);
@@ -2195,8 +2196,6 @@ namespace PocketDb
 
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
-                UniValue record(UniValue::VOBJ);
-
                 auto[ok0, id] = TryGetColumnInt64(*stmt, 0);
                 auto[ok1, hash] = TryGetColumnString(*stmt, 1);
                 auto[ok2, time] = TryGetColumnString(*stmt, 2);
@@ -2206,24 +2205,27 @@ namespace PocketDb
                 auto[ok6, reputation] = TryGetColumnString(*stmt, 6);
                 auto[ok7, scoreCnt] = TryGetColumnString(*stmt, 7);
                 auto[ok8, scoreSum] = TryGetColumnString(*stmt, 8);
-                
-                if (ok3) record.pushKV("content", HtmlUtils::UrlDecode(caption));
-                else record.pushKV("content", HtmlUtils::UrlDecode(message).substr(0, 100));
 
-                record.pushKV("txid", hash);
-                record.pushKV("time", time);
-                record.pushKV("reputation", reputation);
-                record.pushKV("settings", settings);
-                record.pushKV("scoreSum", scoreSum);
-                record.pushKV("scoreCnt", scoreCnt);
+                result.BeginObject();
 
-                result.push_back(record);
+                if (ok3) result.Key("content").String(HtmlUtils::UrlDecode(caption));
+                else result.Key("content").String(HtmlUtils::UrlDecode(message).substr(0, 100));
+
+                result.Key("txid").String(hash);
+                result.Key("time").String(time);
+                result.Key("reputation").String(reputation);
+                result.Key("settings").String(settings);
+                result.Key("scoreSum").String(scoreSum);
+                result.Key("scoreCnt").String(scoreCnt);
+
+                result.EndObject();
             }
 
             FinalizeSqlStatement(*stmt);
         });
 
-        return result;
+        result.EndArray();
+        return result.ToUniValue();
     }
 
     vector<UniValue> WebRpcRepository::GetMissedRelayedContent(const string& address, int height)
@@ -2802,6 +2804,119 @@ namespace PocketDb
         return result;
     }
 
+    UniValue WebRpcRepository::CheckContentStats(const vector<int64_t>& ids, int count)
+    {
+        UniValue result(UniValue::VOBJ);
+        UniValue mismatches(UniValue::VARR);
+
+        string filter = ids.empty()
+            ? "order by t.Id desc limit ?"
+            : "and t.Id in ( " + join(vector<string>(ids.size(), "?"), ",") + " )";
+
+        string sql = R"sql(
+            select
+                t.Id,
+                t.String2,
+
+                cs.ScoresCount,
+                cs.ScoresSum,
+                cs.Reposted,
+                cs.CommentsCount,
+
+                (select count() from Transactions scr indexed by Transactions_Type_Last_String2_Height
+                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2),
+
+                ifnull((select sum(scr.Int1) from Transactions scr indexed by Transactions_Type_Last_String2_Height
+                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2),0),
+
+                (select count() from Transactions rep indexed by Transactions_Type_Last_String3_Height
+                    where rep.Type in (200,201,202,209,210) and rep.Last = 1 and rep.Height is not null and rep.String3 = t.String2),
+
+                (
+                    select count()
+                    from Transactions s indexed by Transactions_Type_Last_String3_Height
+                    where s.Type in (204, 205)
+                      and s.Height is not null
+                      and s.String3 = t.String2
+                      and s.Last = 1
+                      and not exists (
+                        select 1
+                        from BlockingLists bl
+                        join Transactions us on us.Id = bl.IdSource and us.Type = 100 and us.Last = 1
+                        join Transactions ut on ut.Id = bl.IdTarget and ut.Type = 100 and ut.Last = 1
+                        where us.String1 = t.String1 and ut.String1 = s.String1
+                      )
+                )
+
+            from Transactions t indexed by Transactions_Last_Id_Height
+            left join ContentStats cs on cs.ContentId = t.Id
+            where t.Last = 1
+              and t.Height is not null
+              and t.Type in (200, 201, 202, 209, 210, 207)
+              )sql" + filter + R"sql(
+        )sql";
+
+        int checked = 0;
+        int missing = 0;
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+            int i = 1;
+
+            if (ids.empty())
+                TryBindStatementInt(stmt, i++, count);
+
+            for (int64_t id : ids)
+                TryBindStatementInt64(stmt, i++, id);
+
+            static const vector<string> names = { "scoreCnt", "scoreSum", "reposted", "comments" };
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                checked += 1;
+
+                auto[okId, id] = TryGetColumnInt64(*stmt, 0);
+                auto[okHash, hash] = TryGetColumnString(*stmt, 1);
+
+                UniValue stored(UniValue::VOBJ);
+                UniValue actual(UniValue::VOBJ);
+                bool exists = true;
+                bool equals = true;
+                for (size_t n = 0; n < names.size(); n++)
+                {
+                    auto[okStored, storedValue] = TryGetColumnInt64(*stmt, 2 + (int) n);
+                    auto[okActual, actualValue] = TryGetColumnInt64(*stmt, 6 + (int) n);
+
+                    exists = exists && okStored;
+                    equals = equals && okStored && storedValue == actualValue;
+
+                    if (okStored) stored.pushKV(names[n], storedValue);
+                    actual.pushKV(names[n], actualValue);
+                }
+
+                if (!exists)
+                    missing += 1;
+
+                if (equals)
+                    continue;
+
+                UniValue record(UniValue::VOBJ);
+                record.pushKV("id", id);
+                record.pushKV("txid", hash);
+                record.pushKV("stored", exists ? stored : NullUniValue);
+                record.pushKV("actual", actual);
+                mismatches.push_back(record);
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        result.pushKV("checked", checked);
+        result.pushKV("missing", missing);
+        result.pushKV("mismatches", mismatches);
+        return result;
+    }
+
     // ------------------------------------------------------
     // Feeds
 
@@ -2874,12 +2989,18 @@ namespace PocketDb
         return result;
     }
 
-    vector<UniValue> WebRpcRepository::GetContentsData(const vector<int64_t>& ids, const string& address)
+    unordered_map<int64_t, WebContentCacheEntryRef> WebRpcRepository::GetContentBodies(const vector<int64_t>& ids)
     {
-        auto func = __func__;
-        vector<UniValue> result{};
+        auto result = WebContentCacheInst.GetContents(ids);
 
-        if (ids.empty())
+        vector<int64_t> missedIds;
+        for (int64_t id : ids)
+        {
+            if (result.find(id) == result.end())
+                missedIds.push_back(id);
+        }
+
+        if (missedIds.empty())
             return result;
 
         string sql = R"sql(
@@ -2897,18 +3018,152 @@ namespace PocketDb
                 p.String7 as Url,
                 p.String4 as Tags,
                 p.String5 as Images,
-                p.String6 as Settings,
+                p.String6 as Settings
 
-                (select count() from Transactions scr indexed by Transactions_Type_Last_String2_Height
-                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2) as ScoresCount,
+            from Transactions t indexed by Transactions_Last_Id_Height
+            cross join Transactions ua indexed by Transactions_Type_Last_String1_Height_Id
+                on ua.String1 = t.String1 and ua.Type = 100 and ua.Last = 1 and ua.Height is not null
+            left join Payload p on t.Hash = p.TxHash
+            where t.Height is not null
+              and t.Last = 1
+              and t.Id in ( )sql" + join(vector<string>(missedIds.size(), "?"), ",") + R"sql( )
+        )sql";
 
-                ifnull((select sum(scr.Int1) from Transactions scr indexed by Transactions_Type_Last_String2_Height
-                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2),0) as ScoresSum,
+        // Loaded while block indexing values are returned but not cached
+        auto generation = WebContentCacheInst.Generation();
 
-                (select count() from Transactions rep indexed by Transactions_Type_Last_String3_Height
-                    where rep.Type in (200,201,202,209,210) and rep.Last = 1 and rep.Height is not null and rep.String3 = t.String2) as Reposted,
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+            int i = 1;
 
-                (
+            for (int64_t id : missedIds)
+                TryBindStatementInt64(stmt, i++, id);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okHash, txHash] = TryGetColumnString(*stmt, 0);
+                auto[okId, txId] = TryGetColumnInt64(*stmt, 1);
+
+                auto body = make_shared<WebContentCacheEntry>();
+
+                JsonWriter record(2048);
+                record.BeginObject();
+                record.Key("txid").String(txHash);
+                record.Key("id").Int(txId);
+
+                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) record.Key("edit").String(value);
+                if (auto[ok, value] = TryGetColumnString(*stmt, 3); ok) record.Key("repost").String(value);
+                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok)
+                {
+                    body->Address = value;
+                    record.Key("address").String(value);
+                }
+                if (auto[ok, value] = TryGetColumnString(*stmt, 5); ok) record.Key("time").String(value);
+                if (auto[ok, value] = TryGetColumnString(*stmt, 6); ok) record.Key("l").String(value); // lang
+                if (auto[ok, value] = TryGetColumnString(*stmt, 8); ok) record.Key("c").String(value); // caption
+                if (auto[ok, value] = TryGetColumnString(*stmt, 9); ok) record.Key("m").String(value); // message
+                if (auto[ok, value] = TryGetColumnString(*stmt, 10); ok) record.Key("u").String(value); // url
+                
+                if (auto[ok, value] = TryGetColumnInt(*stmt, 7); ok)
+                {
+                    record.Key("type").String(TransactionHelper::TxStringType((TxType) value));
+                    if ((TxType)value == CONTENT_DELETE)
+                        record.Key("deleted").String("true");
+                }
+
+                if (auto[ok, value] = TryGetColumnString(*stmt, 11); ok) record.Key("t").Json(value); // tags
+                if (auto[ok, value] = TryGetColumnString(*stmt, 12); ok) record.Key("i").Json(value); // images
+                if (auto[ok, value] = TryGetColumnString(*stmt, 13); ok) record.Key("s").Json(value); // settings
+                record.EndObject();
+
+                // Members without braces - counters and personal values are appended for every request
+                const auto& buffer = record.Buffer();
+                body->Json = buffer.substr(1, buffer.size() - 2);
+
+                WebContentCacheInst.PutContent(txId, body, generation);
+                result.emplace(txId, std::move(body));
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    unordered_map<string, WebContentCacheEntryRef> WebRpcRepository::GetShortProfiles(const vector<string>& addresses)
+    {
+        auto result = WebContentCacheInst.GetProfiles(addresses);
+
+        vector<string> missedAddresses;
+        for (const auto& address : addresses)
+        {
+            if (result.find(address) == result.end())
+                missedAddresses.push_back(address);
+        }
+
+        if (missedAddresses.empty())
+            return result;
+
+        auto generation = WebContentCacheInst.Generation();
+
+        for (const auto& [address, profile] : GetAccountProfiles(missedAddresses))
+        {
+            auto entry = make_shared<WebContentCacheEntry>();
+            entry->Json = profile.write();
+
+            WebContentCacheInst.PutProfile(address, entry, generation);
+            result.emplace(address, std::move(entry));
+        }
+
+        return result;
+    }
+
+    vector<UniValue> WebRpcRepository::GetContentsData(const vector<int64_t>& ids, const string& address)
+    {
+        auto func = __func__;
+        vector<UniValue> result{};
+
+        if (ids.empty())
+            return result;
+
+        // Bodies of contents change only with new version of content and shared by all requests.
+        // Only counters and personal values are selected for every request.
+        auto bodies = GetContentBodies(ids);
+
+        vector<int64_t> foundIds;
+        vector<string> authors;
+        for (int64_t id : ids)
+        {
+            auto it = bodies.find(id);
+            if (it == bodies.end())
+                continue;
+
+            foundIds.push_back(id);
+            authors.push_back(it->second->Address);
+        }
+
+        if (foundIds.empty())
+        {
+            result.resize(ids.size(), NullUniValue);
+            return result;
+        }
+
+        string sql = R"sql(
+            select
+                t.Id,
+
+                -- Counters are maintained by chain indexing, contents without ContentStats row are calculated on the fly
+                ifnull(cs.ScoresCount, (select count() from Transactions scr indexed by Transactions_Type_Last_String2_Height
+                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2)) as ScoresCount,
+
+                ifnull(cs.ScoresSum, ifnull((select sum(scr.Int1) from Transactions scr indexed by Transactions_Type_Last_String2_Height
+                    where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String2 = t.String2),0)) as ScoresSum,
+
+                ifnull(cs.Reposted, (select count() from Transactions rep indexed by Transactions_Type_Last_String3_Height
+                    where rep.Type in (200,201,202,209,210) and rep.Last = 1 and rep.Height is not null and rep.String3 = t.String2)) as Reposted,
+
+                ifnull(cs.CommentsCount, (
                     select count()
                     from Transactions s indexed by Transactions_Type_Last_String3_Height
                     where s.Type in (204, 205)
@@ -2923,23 +3178,21 @@ namespace PocketDb
                         join Transactions ut on ut.Id = bl.IdTarget and ut.Type = 100 and ut.Last = 1
                         where us.String1 = t.String1 and ut.String1 = s.String1
                       )
-                ) AS CommentsCount,
+                )) AS CommentsCount,
                 
                 ifnull((select scr.Int1 from Transactions scr indexed by Transactions_Type_Last_String1_String2_Height
                     where scr.Type = 300 and scr.Last in (0,1) and scr.Height is not null and scr.String1 = ? and scr.String2 = t.String2),0) as MyScore
 
             from Transactions t indexed by Transactions_Last_Id_Height
-            cross join Transactions ua indexed by Transactions_Type_Last_String1_Height_Id
-                on ua.String1 = t.String1 and ua.Type = 100 and ua.Last = 1 and ua.Height is not null
-            left join Payload p on t.Hash = p.TxHash
+            left join ContentStats cs on cs.ContentId = t.Id
             where t.Height is not null
               and t.Last = 1
-              and t.Id in ( )sql" + join(vector<string>(ids.size(), "?"), ",") + R"sql( )
+              and t.Id in ( )sql" + join(vector<string>(foundIds.size(), "?"), ",") + R"sql( )
         )sql";
 
-        // Get posts
-        unordered_map<int64_t, UniValue> tmpResult{};
-        vector<string> authors;
+        // Records are written as JSON directly, cached bodies are spliced as is.
+        // Objects stay open until last comments and profiles are appended.
+        unordered_map<int64_t, JsonWriter> tmpResult{};
         TryTransactionStep(func, [&]()
         {
             auto stmt = SetupSqlStatement(sql);
@@ -2947,93 +3200,63 @@ namespace PocketDb
 
             TryBindStatementText(stmt, i++, address);
 
-            for (int64_t id : ids)
+            for (int64_t id : foundIds)
                 TryBindStatementInt64(stmt, i++, id);
 
             // ---------------------------
             while (sqlite3_step(*stmt) == SQLITE_ROW)
             {
-                UniValue record(UniValue::VOBJ);
-
-                auto[okHash, txHash] = TryGetColumnString(*stmt, 0);
-                auto[okId, txId] = TryGetColumnInt64(*stmt, 1);
-                record.pushKV("txid", txHash);
-                record.pushKV("id", txId);
-
-                if (auto[ok, value] = TryGetColumnString(*stmt, 2); ok) record.pushKV("edit", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 3); ok) record.pushKV("repost", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 4); ok)
-                {
-                    authors.emplace_back(value);
-                    record.pushKV("address", value);
-                }
-                if (auto[ok, value] = TryGetColumnString(*stmt, 5); ok) record.pushKV("time", value);
-                if (auto[ok, value] = TryGetColumnString(*stmt, 6); ok) record.pushKV("l", value); // lang
-                if (auto[ok, value] = TryGetColumnString(*stmt, 8); ok) record.pushKV("c", value); // caption
-                if (auto[ok, value] = TryGetColumnString(*stmt, 9); ok) record.pushKV("m", value); // message
-                if (auto[ok, value] = TryGetColumnString(*stmt, 10); ok) record.pushKV("u", value); // url
-                
-                if (auto[ok, value] = TryGetColumnInt(*stmt, 7); ok)
-                {
-                    record.pushKV("type", TransactionHelper::TxStringType((TxType) value));
-                    if ((TxType)value == CONTENT_DELETE)
-                        record.pushKV("deleted", "true");
-                }
+                auto[okId, txId] = TryGetColumnInt64(*stmt, 0);
 
-                if (auto[ok, value] = TryGetColumnString(*stmt, 11); ok)
-                {
-                    UniValue t(UniValue::VARR);
-                    t.read(value);
-                    record.pushKV("t", t);
-                }
-
-                if (auto[ok, value] = TryGetColumnString(*stmt, 12); ok)
-                {
-                    UniValue ii(UniValue::VARR);
-                    ii.read(value);
-                    record.pushKV("i", ii);
-                }
+                auto body = bodies.find(txId);
+                if (body == bodies.end())
+                    continue;
 
-                if (auto[ok, value] = TryGetColumnString(*stmt, 13); ok)
-                {
-                    UniValue s(UniValue::VOBJ);
-                    s.read(value);
-                    record.pushKV("s", s);
-                }
+                auto& record = tmpResult[txId];
+                record = JsonWriter(body->second->Json.size() + 1024);
+                record.BeginObject();
+                record.Members(body->second->Json);
 
-                if (auto [ok, value] = TryGetColumnString(*stmt, 14); ok) record.pushKV("scoreCnt", value);
-                if (auto [ok, value] = TryGetColumnString(*stmt, 15); ok) record.pushKV("scoreSum", value);
-                if (auto [ok, value] = TryGetColumnInt(*stmt, 16); ok && value > 0) record.pushKV("reposted", value);
-                if (auto [ok, value] = TryGetColumnInt(*stmt, 17); ok) record.pushKV("comments", value);
+                if (auto [ok, value] = TryGetColumnString(*stmt, 1); ok) record.Key("scoreCnt").String(value);
+                if (auto [ok, value] = TryGetColumnString(*stmt, 2); ok) record.Key("scoreSum").String(value);
+                if (auto [ok, value] = TryGetColumnInt(*stmt, 3); ok && value > 0) record.Key("reposted").Int(value);
+                if (auto [ok, value] = TryGetColumnInt(*stmt, 4); ok) record.Key("comments").Int(value);
 
                 if (!address.empty())
                 {
-                    if (auto [ok, value] = TryGetColumnString(*stmt, 18); ok)
-                        record.pushKV("myVal", value);
+                    if (auto [ok, value] = TryGetColumnString(*stmt, 5); ok)
+                        record.Key("myVal").String(value);
                 }
-
-                tmpResult[txId] = record;                
             }
 
             FinalizeSqlStatement(*stmt);
         });
 
         // ---------------------------------------------
-        // Get last comments for all posts
-        auto lastComments = GetLastComments(ids, address);
-        for (auto& record : tmpResult)
-            record.second.pushKV("lastComment", lastComments[record.first]);
+        // Get last comments and profiles for posts
+        auto lastComments = GetLastComments(foundIds, address);
+        auto profiles = GetShortProfiles(authors);
 
-        // ---------------------------------------------
-        // Get profiles for posts
-        auto profiles = GetAccountProfiles(authors);
-        for (auto& record : tmpResult)
-            record.second.pushKV("userprofile", profiles[record.second["address"].get_str()]);
+        for (auto& [id, record] : tmpResult)
+        {
+            record.Key("lastComment").Value(lastComments[id]);
+
+            auto profile = profiles.find(bodies[id]->Address);
+            if (profile != profiles.end())
+                record.Key("userprofile").Raw(profile->second->Json);
+            else
+                record.Key("userprofile").Null();
+
+            record.EndObject();
+        }
 
         // ---------------------------------------------
         // Place in result data with source sorting
         for (auto& id : ids)
-            result.push_back(tmpResult[id]);
+        {
+            auto it = tmpResult.find(id);
+            result.push_back(it != tmpResult.end() ? it->second.ToUniValue() : NullUniValue);
+        }
 
         return result;
     }
@@ -5212,13 +5435,11 @@ namespace PocketDb
         }},
         };
 
-        static const auto footer = R"sql(
+        static const std::string footer = R"sql(
 
             -- Global order and limit for pagination
             order by Height desc, BlockNum desc
-            limit 10
-
-        )sql";
+            limit )sql" + std::to_string(ShortFormsPageSize);
 
         auto [elem1, elem2] = _constructSelectsBasedOnFilters(filters, selects, footer);
         auto& sql = elem1;
@@ -5246,6 +5467,12 @@ namespace PocketDb
     }
 
     UniValue WebRpcRepository::GetNotifications(int64_t height, const std::set<ShortTxType>& filters)
+    {
+        auto records = GetNotificationRecords(height, filters);
+        return NotificationsReconstructor::BuildResult(records, _choosePredicate(filters)).Serialize();
+    }
+
+    NotificationRecords WebRpcRepository::GetNotificationRecords(int64_t height, const std::set<ShortTxType>& filters)
     {
         struct QueryParams {
             // Handling all by reference
@@ -6162,8 +6389,7 @@ namespace PocketDb
                 });
             }
         }
-        auto notificationResult = reconstructor.GetResult();
-        return notificationResult.Serialize();
+        return reconstructor.GetRecords();
     }
 
     std::vector<ShortForm> WebRpcRepository::GetEventsForAddresses(const std::string& address, int64_t heightMax, int64_t heightMin, int64_t blockNumMax, const std::set<ShortTxType>& filters)
@@ -7103,13 +7329,11 @@ namespace PocketDb
             }
         }}};
 
-        static const auto footer = R"sql(
+        static const std::string footer = R"sql(
 
             -- Global order and limit for pagination
             order by Height desc, BlockNum desc
-            limit 10
-
-        )sql";
+            limit )sql" + std::to_string(ShortFormsPageSize);
         
         auto [elem1, elem2] = _constructSelectsBasedOnFilters(filters, selects, footer);
         // A bit dirty hack because structure bindings can't be captured by lambda function.
@@ -7341,4 +7565,96 @@ namespace PocketDb
         });
         return reconstructor.GetResult();
     }
-}
\ No newline at end of file
+
+    std::map<std::string, std::map<ShortTxType, int>> WebRpcRepository::GetNotificationsSummaryInbox(int64_t heightMax, int64_t heightMin, const std::set<std::string>& addresses, const std::set<ShortTxType>& filters)
+    {
+        std::map<std::string, std::map<ShortTxType, int>> result;
+
+        string sql = R"sql(
+            select e.AddressHash, e.Type, count()
+            from web.EventsInbox e indexed by EventsInbox_AddressHash_Height_Type
+            where e.AddressHash in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
+              and e.Height between ? and ?
+            group by e.AddressHash, e.Type
+        )sql";
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+
+            int i = 1;
+            for (const auto& address: addresses)
+                TryBindStatementText(stmt, i++, address);
+            TryBindStatementInt64(stmt, i++, heightMin);
+            TryBindStatementInt64(stmt, i++, heightMax);
+
+            while (sqlite3_step(*stmt) == SQLITE_ROW)
+            {
+                auto[okAddress, address] = TryGetColumnString(*stmt, 0);
+                auto[okType, type] = TryGetColumnInt(*stmt, 1);
+                auto[okCount, count] = TryGetColumnInt(*stmt, 2);
+                if (!okAddress || !okType || !okCount)
+                    continue;
+
+                auto shortType = (ShortTxType) type;
+                if (!filters.empty() && filters.find(shortType) == filters.end())
+                    continue;
+
+                result[address][shortType] = count;
+            }
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+
+    std::optional<int64_t> WebRpcRepository::GetEventsInboxBoundary(const std::string& address, bool byActor, int64_t heightMax, int64_t heightMin, int64_t blockNumMax, const std::set<ShortTxType>& types)
+    {
+        std::optional<int64_t> result;
+        if (types.empty())
+            return result;
+
+        // Same window and pagination conditions as short forms selects
+        string sql = byActor ? R"sql(
+            select e.Height
+            from web.EventsInbox e indexed by EventsInbox_ActorHash_Height_Type
+            where e.ActorHash = ?
+        )sql" : R"sql(
+            select e.Height
+            from web.EventsInbox e indexed by EventsInbox_AddressHash_Height_Type
+            where e.AddressHash = ?
+        )sql";
+
+        sql += R"sql(
+              and e.Type in ( )sql" + join(vector<string>(types.size(), "?"), ",") + R"sql( )
+              and e.Height > ?
+              and (e.Height < ? or (e.Height = ? and e.BlockNum < ?))
+            order by e.Height desc, e.BlockNum desc
+            limit 1 offset ?
+        )sql";
+
+        TryTransactionStep(__func__, [&]()
+        {
+            auto stmt = SetupSqlStatement(sql);
+
+            int i = 1;
+            TryBindStatementText(stmt, i++, address);
+            for (const auto& type : types)
+                TryBindStatementInt(stmt, i++, (int) type);
+            TryBindStatementInt64(stmt, i++, heightMin);
+            TryBindStatementInt64(stmt, i++, heightMax);
+            TryBindStatementInt64(stmt, i++, heightMax);
+            TryBindStatementInt64(stmt, i++, blockNumMax);
+            TryBindStatementInt(stmt, i++, ShortFormsPageSize - 1);
+
+            if (sqlite3_step(*stmt) == SQLITE_ROW)
+                if (auto[ok, value] = TryGetColumnInt64(*stmt, 0); ok)
+                    result = value;
+
+            FinalizeSqlStatement(*stmt);
+        });
+
+        return result;
+    }
+}
@@ -8,6 +8,8 @@
 #include "pocketdb/helpers/PocketnetHelper.h"
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/repositories/BaseRepository.h"
+#include "pocketdb/repositories/web/WebContentCache.h"
+#include "pocketdb/repositories/web/AccountProfileLoader.h"
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
@@ -15,6 +17,7 @@
 #include "core_io.h"
 #include "util/html.h"
 #include "pocketdb/models/shortform/ShortForm.h"
+#include "pocketdb/helpers/ShortFormRepositoryHelper.h"
 
 namespace PocketDb
 {
@@ -155,6 +158,9 @@ namespace PocketDb
 
         UniValue GetContentsStatistic(const vector<string>& addresses, const vector<int>& contentTypes);
 
+        // Compare ContentStats counters with calculated on the fly for contents with ids or for last count contents
+        UniValue CheckContentStats(const vector<int64_t>& ids, int count);
+
         vector<int64_t> GetRandomContentIds(const string& lang, int count, int height);
 
         UniValue GetContentActions(const string& postTxHash);
@@ -171,6 +177,8 @@ namespace PocketDb
          * @param filters
          */
         UniValue GetNotifications(int64_t height, const std::set<ShortTxType>& filters);
+        // Parsed notification rows of block - used for result building and notifications precalculation
+        NotificationRecords GetNotificationRecords(int64_t height, const std::set<ShortTxType>& filters);
 
         /**
          * Get all activities (posts, comments, etc) created by address
@@ -186,6 +194,20 @@ namespace PocketDb
 
         // TODO (losty): convert return type to class of smth. + docs
         std::map<std::string, std::map<ShortTxType, int>> GetNotificationsSummary(int64_t heightMax, int64_t heightMin, const std::set<std::string>& addresses, const std::set<ShortTxType>& filters);
+        // Same summary read from web.EventsInbox - inbox must cover heights range
+        std::map<std::string, std::map<ShortTxType, int>> GetNotificationsSummaryInbox(int64_t heightMax, int64_t heightMin, const std::set<std::string>& addresses, const std::set<ShortTxType>& filters);
+
+        // Page size of GetEventsForAddresses and GetActivities
+        static constexpr int ShortFormsPageSize = 10;
+
+        /**
+         * Height of the last event on the first page of inbox events received (byActor = false)
+         * or made (byActor = true) by address. Inbox keeps events of the same types as
+         * GetEventsForAddresses and GetActivities, but without their account joins, so the page
+         * of these selects is not lower than returned height only if narrowed select returns
+         * a full page. Inbox must cover range from returned height to heightMax.
+         */
+        std::optional<int64_t> GetEventsInboxBoundary(const std::string& address, bool byActor, int64_t heightMax, int64_t heightMin, int64_t blockNumMax, const std::set<ShortTxType>& types);
 
     private:
         int cntBlocksForResult = 300;
@@ -196,6 +218,10 @@ namespace PocketDb
         double dekayContent =  0.96;
 
         vector<tuple<string, int64_t, UniValue>> GetAccountProfiles(const vector<string>& addresses, const vector<int64_t>& ids, bool shortForm, int firstFlagsDepth);
+
+        // Parts of contents response shared by all users - read through WebContentCache
+        unordered_map<int64_t, WebContentCacheEntryRef> GetContentBodies(const vector<int64_t>& ids);
+        unordered_map<string, WebContentCacheEntryRef> GetShortProfiles(const vector<string>& addresses);
     };
 
     typedef shared_ptr<WebRpcRepository> WebRpcRepositoryRef;
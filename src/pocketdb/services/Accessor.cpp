@@ -53,8 +53,12 @@ namespace PocketServices
     {
         if (!PocketHelpers::TransactionHelper::IsPocketSupportedTransaction(tx))
             return true;
-            
-        pocketTx = PocketDb::TransRepoInst.Get(tx.GetHash().GetHex(), true);
+
+        // Mempool transactions are relayed most often
+        pocketTx = PocketDb::MempoolPayloadsInst.Get(tx.GetHash().GetHex());
+        if (!pocketTx)
+            pocketTx = PocketDb::TransRepoInst.Get(tx.GetHash().GetHex(), true);
+
         return pocketTx != nullptr;
     }
 
@@ -15,11 +15,33 @@ namespace PocketServices
 
         IndexChain(block.GetHash().GetHex(), height, txs);
 
+        // Balances and accounts of this block must be visible to ratings calculation
+        PocketDb::AccountStateCacheInst.Invalidate(PocketDb::ConsensusRepoInst.GetChangedAccounts(height));
+
         int64_t nTime2 = GetTimeMicros();
         LogPrint(BCLog::BENCH, "    - IndexChain: %.2fms _ %d\n", 0.001 * (double)(nTime2 - nTime1), height);
 
         IndexRatings(height, txs);
 
+        // New reputations and likers counts
+        PocketDb::AccountStateCacheInst.Invalidate(PocketDb::ConsensusRepoInst.GetChangedAccounts(height));
+
+        // Edited contents and changed authors profiles for web hydration and precalculated notifications.
+        // Profiles loader goes first - request taking new content cache generation must not get old profile from the loader
+        auto[contentIds, addresses, accountsDeleted] = PocketDb::ConsensusRepoInst.GetChangedWebContents(height);
+        if (accountsDeleted)
+        {
+            PocketDb::AccountProfileLoaderInst.Clear();
+            PocketDb::WebContentCacheInst.Clear();
+            PocketServices::WebPostProcessorInst.ClearNotifications();
+        }
+        else
+        {
+            PocketDb::AccountProfileLoaderInst.Invalidate(addresses);
+            PocketDb::WebContentCacheInst.Invalidate(contentIds, addresses);
+            PocketServices::WebPostProcessorInst.InvalidateNotifications(addresses);
+        }
+
         int64_t nTime3 = GetTimeMicros();
         LogPrint(BCLog::BENCH, "    - IndexRatings: %.2fms _ %d\n", 0.001 * (double)(nTime3 - nTime2), height);
     }
@@ -27,7 +49,16 @@ namespace PocketServices
     bool ChainPostProcessing::Rollback(int height)
     {
         LogPrint(BCLog::SYNC, "Rollback current block to prev at height %d\n", height - 1);
-        return PocketDb::ChainRepoInst.Rollback(height);
+        auto result = PocketDb::ChainRepoInst.Rollback(height);
+
+        // Likers index and account states can hold rolled back values
+        PocketDb::RatingsRepoInst.ResetLikers();
+        PocketDb::AccountStateCacheInst.Clear();
+        PocketDb::AccountProfileLoaderInst.Clear();
+        PocketDb::WebContentCacheInst.Clear();
+        PocketServices::WebPostProcessorInst.ClearNotifications();
+
+        return result;
     }
 
     void ChainPostProcessing::PrepareTransactions(const CBlock& block, vector<TransactionIndexingInfo>& txs)
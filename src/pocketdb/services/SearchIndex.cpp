@@ -0,0 +1,374 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/SearchIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace PocketServices
+{
+    static char FoldChar(char c)
+    {
+        return 'A' <= c && c <= 'Z' ? c ^ 32 : c;
+    }
+
+    static uint32_t Trigram(const string& value, size_t pos)
+    {
+        return ((uint32_t) (unsigned char) value[pos] << 16) | ((uint32_t) (unsigned char) value[pos + 1] << 8) | (unsigned char) value[pos + 2];
+    }
+
+    // Lower case of latin-1 and cyrillic capitals, other code points are kept
+    static uint32_t FoldCodePoint(uint32_t cp)
+    {
+        if ('A' <= cp && cp <= 'Z')
+            return cp + 0x20;
+        if (0xC0 <= cp && cp <= 0xDE && cp != 0xD7)
+            return cp + 0x20;
+        if (0x410 <= cp && cp <= 0x42F)
+            return cp + 0x20;
+        if (0x400 <= cp && cp <= 0x40F)
+            return cp + 0x50;
+        return cp;
+    }
+
+    static void AppendUtf8(string& out, uint32_t cp)
+    {
+        if (cp < 0x80)
+        {
+            out += (char) cp;
+        }
+        else if (cp < 0x800)
+        {
+            out += (char) (0xC0 | (cp >> 6));
+            out += (char) (0x80 | (cp & 0x3F));
+        }
+        else if (cp < 0x10000)
+        {
+            out += (char) (0xE0 | (cp >> 12));
+            out += (char) (0x80 | ((cp >> 6) & 0x3F));
+            out += (char) (0x80 | (cp & 0x3F));
+        }
+        else
+        {
+            out += (char) (0xF0 | (cp >> 18));
+            out += (char) (0x80 | ((cp >> 12) & 0x3F));
+            out += (char) (0x80 | ((cp >> 6) & 0x3F));
+            out += (char) (0x80 | (cp & 0x3F));
+        }
+    }
+
+    string SearchIndex::FoldCase(const string& value)
+    {
+        string result = value;
+        transform(result.begin(), result.end(), result.begin(), FoldChar);
+        return result;
+    }
+
+    vector<string> SearchIndex::Tokenize(const string& value)
+    {
+        vector<string> words;
+        string word;
+
+        size_t i = 0;
+        while (i < value.size())
+        {
+            auto c = (unsigned char) value[i];
+
+            // ASCII separators end word
+            if (c < 0x80)
+            {
+                i++;
+                if (('0' <= c && c <= '9') || ('A' <= c && c <= 'Z') || ('a' <= c && c <= 'z'))
+                {
+                    word += FoldChar((char) c);
+                    continue;
+                }
+
+                if (!word.empty())
+                    words.push_back(move(word));
+                word.clear();
+                continue;
+            }
+
+            // Decode multibyte sequence, malformed bytes are kept as is
+            size_t len = c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : c >= 0xC0 ? 2 : 1;
+            uint32_t cp = len == 4 ? c & 0x07 : len == 3 ? c & 0x0F : c & 0x1F;
+            bool valid = len > 1 && i + len <= value.size();
+            for (size_t j = 1; valid && j < len; j++)
+            {
+                auto next = (unsigned char) value[i + j];
+                valid = (next & 0xC0) == 0x80;
+                cp = (cp << 6) | (next & 0x3F);
+            }
+
+            if (valid)
+            {
+                AppendUtf8(word, FoldCodePoint(cp));
+                i += len;
+            }
+            else
+            {
+                word += (char) c;
+                i++;
+            }
+        }
+
+        if (!word.empty())
+            words.push_back(move(word));
+
+        return words;
+    }
+
+    void SearchIndex::IndexTag(const pair<string, string>& tag)
+    {
+        auto value = FoldCase(tag.first);
+        if (value.size() < 3)
+            return;
+
+        set<uint32_t> trigrams;
+        for (size_t i = 0; i + 3 <= value.size(); i++)
+            trigrams.insert(Trigram(value, i));
+
+        for (auto trigram : trigrams)
+            m_trigrams[trigram].push_back(&tag);
+    }
+
+    void SearchIndex::LoadTags(const vector<pair<string, string>>& tags)
+    {
+        LOCK(m_tags_mutex);
+
+        m_trigrams.clear();
+        m_tags.clear();
+        for (const auto& tag : tags)
+        {
+            auto[it, inserted] = m_tags.insert(tag);
+            if (inserted)
+                IndexTag(*it);
+        }
+
+        m_tags_ready = true;
+    }
+
+    void SearchIndex::ClearTags()
+    {
+        LOCK(m_tags_mutex);
+
+        m_tags_ready = false;
+        m_trigrams.clear();
+        m_tags.clear();
+    }
+
+    bool SearchIndex::IsTagsReady()
+    {
+        LOCK(m_tags_mutex);
+        return m_tags_ready;
+    }
+
+    void SearchIndex::AddTags(const vector<pair<string, string>>& tags)
+    {
+        LOCK(m_tags_mutex);
+
+        if (!m_tags_ready)
+            return;
+
+        for (const auto& tag : tags)
+        {
+            auto[it, inserted] = m_tags.insert(tag);
+            if (inserted)
+                IndexTag(*it);
+        }
+    }
+
+    vector<string> SearchIndex::SearchTags(const string& keyword, int start, int count)
+    {
+        vector<string> result;
+
+        if (count <= 0)
+            return result;
+
+        start = std::max(0, start);
+        string key = FoldCase(keyword);
+        auto match = [](char a, char b) { return FoldChar(a) == b; };
+        auto contains = [&](const string& value) { return search(value.begin(), value.end(), key.begin(), key.end(), match) != value.end(); };
+
+        LOCK(m_tags_mutex);
+
+        // Short keywords match most of tags - first page is found at the beginning of ordered tags
+        if (key.size() < 3)
+        {
+            int skipped = 0;
+            for (auto it = m_tags.begin(); it != m_tags.end() && (int) result.size() < count; ++it)
+            {
+                if (!contains(it->first) || skipped++ < start)
+                    continue;
+
+                result.push_back(it->first);
+            }
+
+            return result;
+        }
+
+        // Candidates from the shortest list of keyword trigrams, every candidate is checked for whole keyword
+        const vector<const pair<string, string>*>* candidates = nullptr;
+        for (size_t i = 0; i + 3 <= key.size(); i++)
+        {
+            auto it = m_trigrams.find(Trigram(key, i));
+            if (it == m_trigrams.end())
+                return result;
+
+            if (!candidates || it->second.size() < candidates->size())
+                candidates = &it->second;
+        }
+
+        vector<const pair<string, string>*> found;
+        for (auto tag : *candidates)
+            if (contains(tag->first))
+                found.push_back(tag);
+
+        if ((size_t) start >= found.size())
+            return result;
+
+        auto end = found.begin() + std::min(found.size(), (size_t) start + count);
+        auto less = [](const pair<string, string>* a, const pair<string, string>* b) { return *a < *b; };
+        partial_sort(found.begin(), end, found.end(), less);
+
+        for (auto it = found.begin() + start; it != end; ++it)
+            result.push_back((*it)->first);
+
+        return result;
+    }
+
+    void SearchIndex::RemoveUser(int64_t id)
+    {
+        auto it = m_users.find(id);
+        if (it == m_users.end())
+            return;
+
+        for (const auto& word : it->second.Words)
+            m_words.erase({word, id});
+
+        m_users.erase(it);
+    }
+
+    void SearchIndex::LoadUsers(const vector<tuple<int64_t, string, int>>& users)
+    {
+        LOCK(m_users_mutex);
+
+        m_users.clear();
+        m_words.clear();
+        m_users_ready = true;
+
+        for (const auto& [id, name, reputation] : users)
+        {
+            auto words = Tokenize(name);
+            if (words.empty())
+                continue;
+
+            for (const auto& word : words)
+                m_words.emplace(word, id);
+
+            m_users[id] = User{move(words), name.size(), reputation};
+        }
+    }
+
+    void SearchIndex::ClearUsers()
+    {
+        LOCK(m_users_mutex);
+
+        m_users_ready = false;
+        m_users.clear();
+        m_words.clear();
+    }
+
+    bool SearchIndex::IsUsersReady()
+    {
+        LOCK(m_users_mutex);
+        return m_users_ready;
+    }
+
+    void SearchIndex::SetUser(int64_t id, const string& name, int reputation)
+    {
+        LOCK(m_users_mutex);
+
+        if (!m_users_ready)
+            return;
+
+        RemoveUser(id);
+
+        auto words = Tokenize(name);
+        if (words.empty())
+            return;
+
+        for (const auto& word : words)
+            m_words.emplace(word, id);
+
+        m_users[id] = User{move(words), name.size(), reputation};
+    }
+
+    void SearchIndex::SetReputation(int64_t id, int reputation)
+    {
+        LOCK(m_users_mutex);
+
+        if (auto it = m_users.find(id); it != m_users.end())
+            it->second.Reputation = reputation;
+    }
+
+    vector<int64_t> SearchIndex::SearchUsers(const string& keyword, int start, int count)
+    {
+        vector<int64_t> result;
+
+        start = std::max(0, start);
+        auto words = Tokenize(keyword);
+        if (count <= 0 || words.empty())
+            return result;
+
+        const auto& prefix = words.back();
+
+        LOCK(m_users_mutex);
+
+        // Accounts with any name word starting from the last keyword word,
+        // account with several such words is met several times
+        vector<int64_t> ids;
+        for (auto it = m_words.lower_bound({prefix, numeric_limits<int64_t>::min()});
+             it != m_words.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it)
+            ids.push_back(it->second);
+
+        sort(ids.begin(), ids.end());
+        ids.erase(unique(ids.begin(), ids.end()), ids.end());
+
+        // Other keyword words match whole name words
+        vector<pair<int64_t, const User*>> found;
+        for (auto id : ids)
+        {
+            const auto& user = m_users.at(id);
+
+            bool matched = true;
+            for (size_t i = 0; matched && i + 1 < words.size(); i++)
+                matched = find(user.Words.begin(), user.Words.end(), words[i]) != user.Words.end();
+
+            if (matched)
+                found.emplace_back(id, &user);
+        }
+
+        if ((size_t) start >= found.size())
+            return result;
+
+        auto end = found.begin() + std::min(found.size(), (size_t) start + count);
+        partial_sort(found.begin(), end, found.end(), [](const pair<int64_t, const User*>& a, const pair<int64_t, const User*>& b)
+        {
+            if (a.second->Reputation != b.second->Reputation)
+                return a.second->Reputation > b.second->Reputation;
+            if (a.second->NameSize != b.second->NameSize)
+                return a.second->NameSize < b.second->NameSize;
+            return a.first < b.first;
+        });
+
+        for (auto it = found.begin() + start; it != end; ++it)
+            result.push_back(it->first);
+
+        return result;
+    }
+
+} // PocketServices
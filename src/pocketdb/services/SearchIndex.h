@@ -0,0 +1,87 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_SEARCH_INDEX_H
+#define POCKETDB_SEARCH_INDEX_H
+
+#include "sync.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace PocketServices
+{
+    using namespace std;
+
+    // In-memory indexes for tags and account names autocomplete.
+    // Tags are a copy of web.Tags filled by tags worker, account names and reputations
+    // are filled by search worker. Both parts are updated with every processed block
+    // and requests fall back to sql search while their part is not loaded.
+    class SearchIndex
+    {
+    public:
+        // Replace all tags with (Value, Lang) rows of web.Tags
+        void LoadTags(const vector<pair<string, string>>& tags);
+        void ClearTags();
+        bool IsTagsReady();
+
+        // Same as "insert or ignore into web.Tags (Lang, Value)"
+        void AddTags(const vector<pair<string, string>>& tags);
+
+        // Tags containing keyword in (Value, Lang) order - same rows as SearchRepository::SearchTags
+        vector<string> SearchTags(const string& keyword, int start, int count);
+
+        // Replace all accounts with (Id, Name, Reputation) of actual account versions
+        void LoadUsers(const vector<tuple<int64_t, string, int>>& users);
+        void ClearUsers();
+        bool IsUsersReady();
+
+        // Actual name of account, empty name removes account - deleted accounts are not searched
+        void SetUser(int64_t id, const string& name, int reputation);
+        void SetReputation(int64_t id, int reputation);
+
+        // Accounts having every word of keyword in name, the last one as prefix - matching of
+        // "\"keyword\" OR keyword*" fts query on names. Ranked by reputation, then by shorter name.
+        vector<int64_t> SearchUsers(const string& keyword, int start, int count);
+
+        // ASCII case folding of sqlite LIKE
+        static string FoldCase(const string& value);
+
+        // Words of name folded to lower case, close to fts5 unicode61 tokenizer:
+        // ASCII letters and digits and all non-ASCII characters are parts of words
+        static vector<string> Tokenize(const string& value);
+
+    private:
+        struct User
+        {
+            vector<string> Words;
+            size_t NameSize = 0;
+            int Reputation = 0;
+        };
+
+        Mutex m_tags_mutex;
+        bool m_tags_ready = false;
+        // Value and Lang ordered as sql search result
+        set<pair<string, string>> m_tags;
+        // Tags by trigrams of folded value - set nodes are never removed
+        unordered_map<uint32_t, vector<const pair<string, string>*>> m_trigrams;
+
+        Mutex m_users_mutex;
+        bool m_users_ready = false;
+        map<int64_t, User> m_users;
+        // Name words of accounts in sorted order for prefix lookup
+        set<pair<string, int64_t>> m_words;
+
+        void IndexTag(const pair<string, string>& tag);
+        void RemoveUser(int64_t id);
+    };
+
+} // PocketServices
+
+#endif // POCKETDB_SEARCH_INDEX_H
@@ -4,120 +4,324 @@
 
 #include "pocketdb/services/WebPostProcessing.h"
 #include "pocketdb/consensus/Reputation.h"
+#include "validation.h"
 
 namespace PocketServices
 {
-    WebPostProcessor::WebPostProcessor() = default;
+    static const int64_t DEFAULT_WEB_BATCH_BLOCKS = 100;
+    static const int WEB_BUSY_TIMEOUT_MS = 60 * 1000;
+    // Tags per upsert statement - keeps binds count under sqlite variables limit
+    static const size_t WEB_TAGS_UPSERT_CHUNK = 400;
+
+    // Accounts of tx author, related content author and multiple addresses - fields serialized with their profiles
+    static void CollectNotificationAccounts(const UniValue& data, set<string>& accounts)
+    {
+        if (const auto& address = data["address"]; address.isStr())
+            accounts.insert(address.get_str());
+
+        if (const auto& multiple = data["multipleAddresses"]; multiple.isObject())
+            for (const auto& address : multiple.getKeys())
+                accounts.insert(address);
+
+        if (const auto& related = data["relatedContent"]; related.isObject())
+            CollectNotificationAccounts(related, accounts);
+    }
+
+    WebPostProcessor::WebPostProcessor()
+    {
+        _stages[WebStageTags].Name = "tags";
+        _stages[WebStageSearch].Name = "search";
+        _stages[WebStageNotifications].Name = "notifications";
+        _stages[WebStageBadges].Name = "badges";
+    }
 
     void WebPostProcessor::Start(boost::thread_group& threadGroup)
     {
+        LOCK(_queue_mutex);
+
         shutdown = false;
-        threadGroup.create_thread([this] { Worker(); });
+        for (size_t i = 0; i < _stages.size(); i++)
+        {
+            _stages[i].Running = true;
+            threadGroup.create_thread([this, i] { Worker((WebStageType) i); });
+        }
     }
 
     void WebPostProcessor::Stop()
     {
-        // Signal for complete all tasks
-        {
-            LOCK(_queue_mutex);
+        WAIT_LOCK(_queue_mutex, lock);
 
-            shutdown = true;
-            _queue_cond.notify_all();
-        }
+        // Signal for complete all tasks
+        shutdown = true;
+        _queue_cond.notify_all();
 
         // Wait all tasks completed
-        LOCK(_running_mutex);
+        while (any_of(_stages.begin(), _stages.end(), [](const WebStage& stage) { return stage.Running; }))
+            _queue_cond.wait(lock);
     }
 
-    void WebPostProcessor::Worker()
+    void WebPostProcessor::OpenStage(WebStage& stage)
     {
-        LogPrintf("WebPostProcessor: starting thread worker\n");
+        if (stage.SqliteDb)
+            return;
 
-        LOCK(_running_mutex);
-
-        // Run database
         auto dbBasePath = (GetDataDir() / "pocketdb").string();
 
-        sqliteDbInst = make_shared<SQLiteDatabase>(false);
-        sqliteDbInst->Init(dbBasePath, "main");
-        sqliteDbInst->AttachDatabase("web");
+        stage.SqliteDb = make_shared<SQLiteDatabase>(false);
+        stage.SqliteDb->Init(dbBasePath, "main");
+        stage.SqliteDb->AttachDatabase("web");
+
+        // Other stages can hold web db write lock for a while
+        sqlite3_busy_timeout(stage.SqliteDb->m_db, WEB_BUSY_TIMEOUT_MS);
+
+        stage.WebRepo = make_shared<WebRepository>(*stage.SqliteDb);
+        stage.WebRpcRepo = make_shared<WebRpcRepository>(*stage.SqliteDb);
+    }
+
+    void WebPostProcessor::CloseStage(WebStage& stage)
+    {
+        if (!stage.SqliteDb)
+            return;
 
-        webRepoInst = make_shared<WebRepository>(*sqliteDbInst);
+        stage.SqliteDb->m_connection_mutex.lock();
+
+        stage.WebRepo->Destroy();
+        stage.WebRepo = nullptr;
+
+        stage.WebRpcRepo->Destroy();
+        stage.WebRpcRepo = nullptr;
+
+        stage.SqliteDb->DetachDatabase("web");
+        stage.SqliteDb->Close();
+
+        stage.SqliteDb->m_connection_mutex.unlock();
+        stage.SqliteDb = nullptr;
+    }
+
+    void WebPostProcessor::Worker(WebStageType type)
+    {
+        auto& stage = _stages[type];
+        LogPrintf("WebPostProcessor: starting %s thread worker\n", stage.Name);
+
+        {
+            LOCK(stage.ProcessMutex);
+            OpenStage(stage);
+
+            if (type == WebStageSearch)
+            {
+                try
+                {
+                    LOCK(_web_write_mutex);
+                    stage.WebRepo->ConfigureContentIndex();
+                }
+                catch (const std::exception& e)
+                {
+                    LogPrintf("Warning: WebPostProcessor::ConfigureContentIndex - %s\n", e.what());
+                }
+            }
+        }
+
+        // Index parts are loaded and updated by the same worker, so no processed blocks are missed
+        if (type == WebStageTags)
+            LoadTagsIndex();
+        if (type == WebStageSearch)
+            LoadUsersIndex();
+
+        auto batch = (int) std::max((int64_t) 1, gArgs.GetArg("-webbatchblocks", DEFAULT_WEB_BATCH_BLOCKS));
 
         // Start worker infinity loop
         while (true)
         {
-            QueueRecord queueRecord;
+            int heightMin;
+            int heightMax;
+            map<int, string> blocks;
+            bool reloadUsers = false;
 
             {
                 WAIT_LOCK(_queue_mutex, lock);
 
-                while (!shutdown && _queue_records.empty())
+                while (!shutdown && stage.PendingMax < 0)
                     _queue_cond.wait(lock);
 
                 if (shutdown) break;
 
-                queueRecord = std::move(_queue_records.front());
-                _queue_records.pop_front();
+                // Tags and search are incremental by blocks and processed in limited batches,
+                // notifications and badges need only actual state
+                heightMin = stage.PendingMin;
+                heightMax = stage.PendingMax;
+                if (type == WebStageTags || type == WebStageSearch)
+                    heightMax = std::min(heightMax, heightMin + batch - 1);
+
+                if (heightMax < stage.PendingMax)
+                {
+                    stage.PendingMin = heightMax + 1;
+                }
+                else
+                {
+                    stage.PendingMin = -1;
+                    stage.PendingMax = -1;
+                }
+
+                if (type == WebStageNotifications)
+                    blocks.insert(_notifications_blocks.lower_bound(heightMin), _notifications_blocks.upper_bound(heightMax));
+
+                if (type == WebStageBadges && _badges_reset)
+                {
+                    _badges_cond = nullopt;
+                    _badges_reset = false;
+                }
+
+                if (type == WebStageSearch && _users_reload)
+                {
+                    reloadUsers = true;
+                    _users_reload = false;
+                }
             }
 
-            switch (queueRecord.Type)
+            switch (type)
             {
-                case QueueRecordType::BlockHash:
+                case WebStageTags:
+                {
+                    ProcessTags(heightMin, heightMax);
+                    break;
+                }
+                case WebStageSearch:
+                {
+                    if (reloadUsers)
+                        LoadUsersIndex();
+
+                    ProcessSearchContent(heightMin, heightMax);
+
+                    // Merge search index segments every 100 blocks after sync
+                    if (heightMax / 100 > (heightMin - 1) / 100 && !::ChainstateActive().IsInitialBlockDownload())
+                        OptimizeSearchContent(false);
+
+                    break;
+                }
+                case WebStageNotifications:
                 {
-                    ProcessTags(queueRecord.BlockHash);
-                    ProcessSearchContent(queueRecord.BlockHash);
+                    for (const auto& [height, hash] : blocks)
+                        ProcessNotifications(hash, height);
+
+                    if (!blocks.empty())
+                        ProcessEventsInbox(blocks.rbegin()->second, blocks.rbegin()->first);
+
                     break;
                 }
-                case QueueRecordType::BlockHeight:
+                case WebStageBadges:
                 {
-                    ProcessBadges(queueRecord.BlockHeight);
+                    ProcessBadges(heightMax);
                     // TODO (aok): implement this
-                    // ProcessAuthors(queueRecord.BlockHeight);
+                    // ProcessAuthors(heightMax);
+                    break;
                 }
                 default:
                     break;
             }
+
+            LOCK(_queue_mutex);
+            stage.ProcessedHeight = heightMax;
         }
 
         // Shutdown DB
-        sqliteDbInst->m_connection_mutex.lock();
+        if (type == WebStageTags)
+            _search_index.ClearTags();
+        if (type == WebStageSearch)
+            _search_index.ClearUsers();
 
-        webRepoInst->Destroy();
-        webRepoInst = nullptr;
-
-        sqliteDbInst->DetachDatabase("web");
-        sqliteDbInst->Close();
+        {
+            LOCK(stage.ProcessMutex);
+            CloseStage(stage);
+        }
 
-        sqliteDbInst->m_connection_mutex.unlock();
-        sqliteDbInst = nullptr;
+        {
+            LOCK(_queue_mutex);
+            stage.Running = false;
+            _queue_cond.notify_all();
+        }
 
-        LogPrintf("WebPostProcessor: thread worker exit\n");
+        LogPrintf("WebPostProcessor: %s thread worker exit\n", stage.Name);
     }
 
-    void WebPostProcessor::Enqueue(const string& blockHash)
+    void WebPostProcessor::Enqueue(const string& blockHash, int blockHeight)
     {
-        QueueRecord rcrd = { QueueRecordType::BlockHash, blockHash, -1 };
         LOCK(_queue_mutex);
-        _queue_records.emplace_back(rcrd);
-        _queue_cond.notify_one();
+
+        _tip_height = blockHeight;
+
+        for (auto type : { WebStageTags, WebStageSearch, WebStageNotifications })
+        {
+            auto& stage = _stages[type];
+            stage.PendingMin = stage.PendingMax < 0 ? blockHeight : std::min(stage.PendingMin, blockHeight);
+            stage.PendingMax = std::max(stage.PendingMax, blockHeight);
+        }
+
+        // Keep hashes only for blocks in notifications window, reorganized blocks are replaced
+        auto depth = std::max((int64_t) 1, gArgs.GetArg("-notificationsdepth", 100));
+        _notifications_blocks.erase(_notifications_blocks.lower_bound(blockHeight), _notifications_blocks.end());
+        _notifications_blocks.erase(_notifications_blocks.begin(), _notifications_blocks.lower_bound(blockHeight - depth + 1));
+        _notifications_blocks.emplace(blockHeight, blockHash);
+
+        // Block connected again at processed height - chain was reorganized and badges need full pass
+        if (blockHeight <= _stages[WebStageBadges].ProcessedHeight)
+            _badges_reset = true;
+
+        // Same for account names index - disconnected account versions are not found by heights
+        if (blockHeight <= _stages[WebStageSearch].ProcessedHeight)
+            _users_reload = true;
+
+        _queue_cond.notify_all();
     }
 
     void WebPostProcessor::Enqueue(int blockHeight)
     {
-        QueueRecord rcrd = { QueueRecordType::BlockHeight, "", blockHeight };
         LOCK(_queue_mutex);
-        _queue_records.emplace_back(rcrd);
-        _queue_cond.notify_one();
+
+        _badges_height = blockHeight;
+
+        // Requests coalesce - only the last height is calculated
+        auto& stage = _stages[WebStageBadges];
+        stage.PendingMin = blockHeight;
+        stage.PendingMax = blockHeight;
+
+        _queue_cond.notify_all();
+    }
+
+    void WebPostProcessor::SetProcessed(WebStageType type, int height)
+    {
+        LOCK(_queue_mutex);
+
+        // Worker could process connected blocks above this range already
+        auto& stage = _stages[type];
+        stage.ProcessedHeight = std::max(stage.ProcessedHeight, height);
     }
 
-    void WebPostProcessor::ProcessTags(const string& blockHash)
+    vector<tuple<string, int>> WebPostProcessor::GetLag()
+    {
+        vector<tuple<string, int>> result;
+
+        LOCK(_queue_mutex);
+        for (size_t type = 0; type < _stages.size(); type++)
+        {
+            // Badges are calculated only every 100 blocks and are actual up to the next scheduled height
+            int height = type == WebStageBadges ? _badges_height : _tip_height;
+            result.emplace_back(_stages[type].Name, std::max(0, height - _stages[type].ProcessedHeight));
+        }
+
+        return result;
+    }
+
+    void WebPostProcessor::ProcessTags(int heightMin, int heightMax)
     {
         try
         {
+            auto& stage = _stages[WebStageTags];
+            LOCK(stage.ProcessMutex);
+            OpenStage(stage);
+
             int64_t nTime1 = GetTimeMicros();
 
-            vector<WebTag> contentTags = webRepoInst->GetContentTags(blockHash);
+            vector<WebTag> contentTags = stage.WebRepo->GetContentTags(heightMin, heightMax);
             if (contentTags.empty())
                 return;
 
@@ -134,8 +338,27 @@ namespace PocketServices
             int64_t nTime3 = GetTimeMicros();
             LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessTags (Prepare): %.2fms\n", 0.001 * (double)(nTime3 - nTime2));
 
-            // Insert content tags
-            webRepoInst->UpsertContentTags(contentTags);
+            // Insert content tags in chunks - all tags of one content go to the same chunk
+            // because upsert replaces content mappings
+            {
+                LOCK(_web_write_mutex);
+
+                auto begin = contentTags.begin();
+                while (begin != contentTags.end())
+                {
+                    auto end = begin + std::min(WEB_TAGS_UPSERT_CHUNK, (size_t) (contentTags.end() - begin));
+                    while (end != contentTags.end() && end->ContentId == (end - 1)->ContentId)
+                        ++end;
+
+                    stage.WebRepo->UpsertContentTags(vector<WebTag>(begin, end));
+                    begin = end;
+                }
+            }
+
+            vector<pair<string, string>> tags;
+            for (const auto& contentTag : contentTags)
+                tags.emplace_back(contentTag.Value, contentTag.Lang);
+            _search_index.AddTags(tags);
 
             int64_t nTime4 = GetTimeMicros();
             LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessTags (Upsert): %.2fms\n", 0.001 * (double)(nTime4 - nTime3));
@@ -146,13 +369,30 @@ namespace PocketServices
         }
     }
 
-    void WebPostProcessor::ProcessSearchContent(const string& blockHash)
+    void WebPostProcessor::ProcessSearchContent(int heightMin, int heightMax)
     {
         try
         {
+            auto& stage = _stages[WebStageSearch];
+            LOCK(stage.ProcessMutex);
+            OpenStage(stage);
+
+            int64_t nTime0 = GetTimeMicros();
+
+            // Account names and reputations of search index follow processed heights
+            if (_search_index.IsUsersReady())
+            {
+                for (const auto& [id, name, reputation] : stage.WebRepo->GetSearchIndexUsers(heightMin, heightMax))
+                    _search_index.SetUser(id, HtmlUtils::UrlDecode(name), reputation);
+
+                for (const auto& [id, reputation] : stage.WebRepo->GetChangedReputations(heightMin, heightMax))
+                    _search_index.SetReputation(id, reputation);
+            }
+
             int64_t nTime1 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSearchContent (Index): %.2fms\n", 0.001 * (double)(nTime1 - nTime0));
 
-            vector<WebContent> contentList = webRepoInst->GetContent(blockHash);
+            vector<WebContent> contentList = stage.WebRepo->GetContent(heightMin, heightMax);
             if (contentList.empty())
                 return;
 
@@ -188,7 +428,10 @@ namespace PocketServices
             LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSearchContent (Prepare): %.2fms\n", 0.001 * (double)(nTime3 - nTime2));
 
             // Insert content
-            webRepoInst->UpsertContent(contentList);
+            {
+                LOCK(_web_write_mutex);
+                stage.WebRepo->UpsertContent(contentList);
+            }
 
             int64_t nTime4 = GetTimeMicros();
             LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSearchContent (Upsert): %.2fms\n", 0.001 * (double)(nTime4 - nTime3));
@@ -199,6 +442,227 @@ namespace PocketServices
         }
     }
 
+    void WebPostProcessor::OptimizeSearchContent(bool full)
+    {
+        try
+        {
+            auto& stage = _stages[WebStageSearch];
+            LOCK(stage.ProcessMutex);
+            OpenStage(stage);
+
+            int64_t nTime1 = GetTimeMicros();
+
+            {
+                LOCK(_web_write_mutex);
+
+                if (full)
+                    stage.WebRepo->OptimizeContentIndex();
+                else
+                    stage.WebRepo->MergeContentIndex(gArgs.GetArg("-searchmergepages", 1000));
+            }
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::OptimizeSearchContent (%s): %.2fms\n", full ? "optimize" : "merge", 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: WebPostProcessor::OptimizeSearchContent - %s\n", e.what());
+        }
+    }
+
+    void WebPostProcessor::ProcessNotifications(const string& blockHash, int blockHeight)
+    {
+        // Nobody polls notifications of blocks during sync
+        if (blockHeight < 0 || ::ChainstateActive().IsInitialBlockDownload())
+            return;
+
+        try
+        {
+            int64_t nTime1 = GetTimeMicros();
+
+            uint64_t generation = WITH_LOCK(_notifications_mutex, return _notifications_generation);
+
+            auto records = make_shared<const NotificationRecords>(_stages[WebStageNotifications].WebRpcRepo->GetNotificationRecords(blockHeight, {}));
+
+            set<string> accounts;
+            for (const auto& [type, typeRecords] : *records)
+            {
+                for (const auto& record : typeRecords)
+                {
+                    for (const auto& [address, account] : record.notifiers)
+                        accounts.insert(address);
+
+                    CollectNotificationAccounts(*record.data, accounts);
+                }
+            }
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessNotifications (Select): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+
+            auto depth = std::max((int64_t) 1, gArgs.GetArg("-notificationsdepth", 100));
+
+            LOCK(_notifications_mutex);
+
+            // Drop blocks out of retention window and blocks replaced by reorganization
+            _notifications.erase(_notifications.begin(), _notifications.lower_bound(blockHeight - depth + 1));
+            _notifications.erase(_notifications.lower_bound(blockHeight), _notifications.end());
+
+            // Next block changed accounts while rows were selected - block is served by sql
+            if (generation != _notifications_generation)
+                return;
+
+            _notifications.emplace(blockHeight, make_tuple(blockHash, records, move(accounts)));
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: WebPostProcessor::ProcessNotifications - %s\n", e.what());
+        }
+    }
+
+    shared_ptr<const NotificationRecords> WebPostProcessor::GetNotifications(int blockHeight, const string& blockHash)
+    {
+        LOCK(_notifications_mutex);
+
+        auto it = _notifications.find(blockHeight);
+        if (it == _notifications.end() || get<0>(it->second) != blockHash)
+            return nullptr;
+
+        return get<1>(it->second);
+    }
+
+    void WebPostProcessor::InvalidateNotifications(const vector<string>& addresses)
+    {
+        if (addresses.empty())
+            return;
+
+        LOCK(_notifications_mutex);
+
+        _notifications_generation++;
+
+        for (auto it = _notifications.begin(); it != _notifications.end();)
+        {
+            const auto& accounts = get<2>(it->second);
+            bool changed = any_of(addresses.begin(), addresses.end(), [&](const string& address) { return accounts.count(address) > 0; });
+            it = changed ? _notifications.erase(it) : next(it);
+        }
+    }
+
+    void WebPostProcessor::ClearNotifications()
+    {
+        LOCK(_notifications_mutex);
+
+        _notifications_generation++;
+        _notifications.clear();
+    }
+
+    void WebPostProcessor::ProcessEventsInbox(const string& blockHash, int blockHeight)
+    {
+        if (blockHeight < 0)
+            return;
+
+        // Inbox is not maintained during sync - window will be rebuilt with first block after it
+        if (::ChainstateActive().IsInitialBlockDownload())
+        {
+            LOCK(_inbox_mutex);
+            _inbox_ready = false;
+            return;
+        }
+
+        try
+        {
+            int64_t nTime1 = GetTimeMicros();
+
+            auto depth = (int) std::max((int64_t) 1, gArgs.GetArg("-eventsinboxdepth", 1440));
+            int minHeight = std::max(0, blockHeight - depth + 1);
+
+            // Index new block with missed or reorganized blocks, whole window after restart or sync
+            int fromHeight = minHeight;
+            {
+                LOCK(_inbox_mutex);
+                if (_inbox_ready)
+                    fromHeight = std::max(minHeight, std::min(blockHeight, _inbox_max_height + 1));
+            }
+
+            {
+                LOCK(_web_write_mutex);
+                _stages[WebStageNotifications].WebRepo->IndexEventsInbox(fromHeight, blockHeight);
+                _stages[WebStageNotifications].WebRepo->RefreshEventsInbox(minHeight, fromHeight, blockHeight);
+                _stages[WebStageNotifications].WebRepo->TrimEventsInbox(minHeight);
+            }
+
+            {
+                LOCK(_inbox_mutex);
+                _inbox_ready = true;
+                _inbox_min_height = minHeight;
+                _inbox_max_height = blockHeight;
+                _inbox_max_hash = blockHash;
+            }
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessEventsInbox (%d blocks): %.2fms\n", blockHeight - fromHeight + 1, 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            LOCK(_inbox_mutex);
+            _inbox_ready = false;
+            LogPrintf("Warning: WebPostProcessor::ProcessEventsInbox - %s\n", e.what());
+        }
+    }
+
+    bool WebPostProcessor::EventsInboxCovers(int heightMin, int heightMax, const string& heightMaxHash)
+    {
+        LOCK(_inbox_mutex);
+
+        if (!_inbox_ready || heightMin < _inbox_min_height || heightMax > _inbox_max_height)
+            return false;
+
+        return heightMax < _inbox_max_height || heightMaxHash == _inbox_max_hash;
+    }
+
+    void WebPostProcessor::LoadTagsIndex()
+    {
+        try
+        {
+            int64_t nTime1 = GetTimeMicros();
+
+            auto& stage = _stages[WebStageTags];
+            LOCK(stage.ProcessMutex);
+
+            auto tags = stage.WebRepo->GetSearchIndexTags();
+            _search_index.LoadTags(tags);
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrintf("WebPostProcessor: search index loaded with %d tags in %.2fms\n", tags.size(), 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: WebPostProcessor::LoadTagsIndex - %s\n", e.what());
+        }
+    }
+
+    void WebPostProcessor::LoadUsersIndex()
+    {
+        try
+        {
+            int64_t nTime1 = GetTimeMicros();
+
+            auto& stage = _stages[WebStageSearch];
+            LOCK(stage.ProcessMutex);
+
+            auto users = stage.WebRepo->GetSearchIndexUsers();
+            for (auto& user : users)
+                get<1>(user) = HtmlUtils::UrlDecode(get<1>(user));
+            _search_index.LoadUsers(users);
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrintf("WebPostProcessor: search index loaded with %d accounts in %.2fms\n", users.size(), 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: WebPostProcessor::LoadUsersIndex - %s\n", e.what());
+        }
+    }
+
     void WebPostProcessor::ProcessBadges(int blockHeight)
     {
         try
@@ -212,14 +676,32 @@ namespace PocketServices
             int64_t nTime2 = GetTimeMicros();
             LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessBadges (Reputation Consensus instance): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
 
-            // Clear and calculate all shark accounts
-            webRepoInst->CalculateSharkAccounts(sharkCond);
+            // Full calculation after start, rollback or change of conditions - delta for touched accounts otherwise
+            bool full = !_badges_cond
+                || _badges_cond->Height >= sharkCond.Height
+                || _badges_cond->LikersAll != sharkCond.LikersAll
+                || _badges_cond->LikersContent != sharkCond.LikersContent
+                || _badges_cond->LikersComment != sharkCond.LikersComment
+                || _badges_cond->LikersAnswer != sharkCond.LikersAnswer
+                || _badges_cond->RegistrationDepth != sharkCond.RegistrationDepth;
+
+            {
+                LOCK(_web_write_mutex);
+
+                if (full)
+                    _stages[WebStageBadges].WebRepo->CalculateSharkAccounts(sharkCond);
+                else
+                    _stages[WebStageBadges].WebRepo->UpdateSharkAccounts(sharkCond, _badges_cond->Height);
+            }
+
+            _badges_cond = sharkCond;
 
             int64_t nTime3 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessBadges (Clear & Insert new values): %.2fms\n", 0.001 * (double)(nTime3 - nTime2));
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessBadges (%s): %.2fms\n", full ? "Clear & Insert new values" : "Update changed accounts", 0.001 * (double)(nTime3 - nTime2));
         }
         catch (const std::exception& e)
         {
+            _badges_cond = nullopt;
             LogPrintf("Warning: WebPostProcessor::ProcessBadges - %s\n", e.what());
         }
     }
@@ -231,7 +713,10 @@ namespace PocketServices
             int64_t nTime1 = GetTimeMicros();
 
             // Clear and calculate new valid authors
-            webRepoInst->CalculateValidAuthors(blockHeight);
+            {
+                LOCK(_web_write_mutex);
+                _stages[WebStageBadges].WebRepo->CalculateValidAuthors(blockHeight);
+            }
 
             int64_t nTime2 = GetTimeMicros();
             LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessAuthors (Clear & Insert new values): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
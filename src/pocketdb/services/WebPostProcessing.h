@@ -12,25 +12,41 @@
 
 #include "pocketdb/SQLiteDatabase.h"
 #include "pocketdb/repositories/web/WebRepository.h"
+#include "pocketdb/repositories/web/WebRpcRepository.h"
 #include "pocketdb/models/web/WebTag.h"
 #include "pocketdb/models/web/WebContent.h"
+#include "pocketdb/services/SearchIndex.h"
 
 namespace PocketServices
 {
     using namespace PocketDb;
     using namespace PocketDbWeb;
 
-    enum QueueRecordType
+    enum WebStageType
     {
-        BlockHash = 0,
-        BlockHeight = 1,
+        WebStageTags = 0,
+        WebStageSearch = 1,
+        WebStageNotifications = 2,
+        WebStageBadges = 3,
     };
 
-    struct QueueRecord
+    // Independent part of web post-processing with own thread and db connection.
+    // Connected blocks coalesce into one pending heights range - lagging stage
+    // does not grow any queue and processes many blocks at once.
+    struct WebStage
     {
-        QueueRecordType Type;
-        string BlockHash;
-        int BlockHeight;
+        string Name;
+        int PendingMin = -1;
+        int PendingMax = -1;
+        int ProcessedHeight = -1;
+        bool Running = false;
+
+        // Guards connection and repositories - reindex in ThreadImport runs
+        // tags and search processing of stages beside their workers
+        Mutex ProcessMutex;
+        SQLiteDatabaseRef SqliteDb;
+        WebRepositoryRef WebRepo;
+        WebRpcRepositoryRef WebRpcRepo;
     };
 
     class WebPostProcessor
@@ -40,31 +56,82 @@ namespace PocketServices
         void Start(boost::thread_group& threadGroup);
         void Stop();
 
-        void Enqueue(const string& blockHash);
+        // Block connected to active chain
+        void Enqueue(const string& blockHash, int blockHeight);
+        // Periodic badges calculation
         void Enqueue(int blockHeight);
-                
-        void ProcessTags(const string& blockHash);
-        void ProcessSearchContent(const string& blockHash);
 
-        void ProcessBadges(int blockHeight);
-        void ProcessAuthors(int blockHeight);
+        void ProcessTags(int heightMin, int heightMax);
+        void ProcessSearchContent(int heightMin, int heightMax);
+        // Merge search index segments off the block processing path
+        void OptimizeSearchContent(bool full);
 
-    private:
-        SQLiteDatabaseRef sqliteDbInst;
-        WebRepositoryRef webRepoInst;
+        // Precalculated notifications of block or nullptr if block not processed yet
+        shared_ptr<const NotificationRecords> GetNotifications(int blockHeight, const string& blockHash);
+        // Drop precalculated blocks holding profile or reputation of accounts changed by new block
+        void InvalidateNotifications(const vector<string>& addresses);
+        void ClearNotifications();
+
+        // Events inbox contains all blocks in range and block at heightMax is from active chain
+        bool EventsInboxCovers(int heightMin, int heightMax, const string& heightMaxHash);
+
+        // Index for tags and account names autocomplete - check readiness of part before use
+        SearchIndex& GetSearchIndex() { return _search_index; }
+
+        // Blocks processed outside of stage worker - web db building of -reindex=5
+        void SetProcessed(WebStageType type, int height);
 
-        uint32_t sleep = 5 * 1000;
+        // Count of blocks not processed yet by every stage - badges count from last scheduled height
+        vector<tuple<string, int>> GetLag();
+
+    private:
         bool shutdown = false;
 
-        Mutex _running_mutex;
         Mutex _queue_mutex;
         std::condition_variable _queue_cond;
-        deque<QueueRecord> _queue_records;
-
-        void Worker();
-
+        array<WebStage, 4> _stages;
+        int _tip_height = -1;
+        // Last height of periodic badges calculation
+        int _badges_height = -1;
+        // Hashes of recent blocks for notifications stage, limited with notifications depth
+        map<int, string> _notifications_blocks;
+        bool _badges_reset = false;
+        bool _users_reload = false;
+
+        // Web db accepts one writer - stages read chain data in parallel and write in turn
+        Mutex _web_write_mutex;
+
+        Mutex _notifications_mutex;
+        // Block hash, rows and accounts whose profile fields are copied into rows
+        map<int, tuple<string, shared_ptr<const NotificationRecords>, set<string>>> _notifications;
+        // Incremented on every invalidation - rows selected before it are not stored
+        uint64_t _notifications_generation = 0;
+
+        Mutex _inbox_mutex;
+        bool _inbox_ready = false;
+        int _inbox_min_height = 0;
+        int _inbox_max_height = -1;
+        string _inbox_max_hash;
+
+        SearchIndex _search_index;
+
+        // Conditions of last badges pass, web.Badges is actual for its height
+        optional<BadgeSharkConditions> _badges_cond;
+
+        void Worker(WebStageType type);
+        void OpenStage(WebStage& stage);
+        void CloseStage(WebStage& stage);
+
+        // Load tags part of search index from web db
+        void LoadTagsIndex();
+        // Load account names part of search index from actual accounts
+        void LoadUsersIndex();
+        void ProcessNotifications(const string& blockHash, int blockHeight);
+        void ProcessEventsInbox(const string& blockHash, int blockHeight);
+        void ProcessBadges(int blockHeight);
+        void ProcessAuthors(int blockHeight);
     };
 
 } // PocketServices
 
-#endif // POCKETDB_WEB_POST_PROCESSING_H
\ No newline at end of file
+#endif // POCKETDB_WEB_POST_PROCESSING_H
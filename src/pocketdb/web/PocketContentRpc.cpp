@@ -1142,6 +1142,67 @@ namespace PocketWeb::PocketWebRpc
         };
     }
 
+    RPCHelpMan CheckContentStats()
+    {
+        return RPCHelpMan{"checkcontentstats",
+                "\nCompare precalculated content counters with calculated from transactions.\n",
+                {
+                    {"txids", RPCArg::Type::ARR, RPCArg::Optional::OMITTED_NAMED_ARG, "Contents for check. Default is last contents",
+                        {
+                            {"txid", RPCArg::Type::STR, RPCArg::Optional::NO, ""}
+                        }
+                    },
+                    {"count", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "Count of last contents for check if txids not set. Default is 1000, maximum 10000"}
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "checked", "Count of checked contents"},
+                        {RPCResult::Type::NUM, "missing", "Count of contents without precalculated counters"},
+                        {RPCResult::Type::ARR, "mismatches", "Contents with stored counters different from actual", {{RPCResult::Type::ELISION, "", ""}}},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("checkcontentstats", "") +
+                    HelpExampleCli("checkcontentstats", "[] 5000") +
+                    HelpExampleRpc("checkcontentstats", "[\"txid\"]")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+    {
+        vector<string> hashes;
+        if (request.params.size() > 0 && request.params[0].isArray())
+        {
+            UniValue txids = request.params[0].get_array();
+            for (unsigned int idx = 0; idx < txids.size(); idx++)
+            {
+                string txidEx = boost::trim_copy(txids[idx].get_str());
+                if (!txidEx.empty())
+                    hashes.push_back(txidEx);
+            }
+        }
+
+        int count = 1000;
+        if (request.params.size() > 1 && request.params[1].isNum())
+            count = std::clamp(request.params[1].get_int(), 1, 10000);
+
+        // Private socket workers have no own db connection
+        auto dbConnection = request.DbConnection();
+        if (!dbConnection)
+            dbConnection = std::make_shared<PocketDb::SQLiteConnection>();
+
+        vector<int64_t> ids;
+        if (!hashes.empty())
+        {
+            ids = dbConnection->WebRpcRepoInst->GetContentIds(hashes);
+            if (ids.empty())
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Contents not found");
+        }
+
+        return dbConnection->WebRpcRepoInst->CheckContentStats(ids, count);
+    },
+        };
+    }
+
     RPCHelpMan GetRandomContents()
     {
         return RPCHelpMan{"GetRandomPost",
@@ -1226,6 +1287,35 @@ namespace PocketWeb::PocketWebRpc
         };
     }
 
+    // Hash of active chain block or empty string for heights out of chain
+    static std::string ActiveBlockHash(int64_t height)
+    {
+        LOCK(cs_main);
+        if (auto pindex = ChainActive()[height]; pindex)
+            return pindex->GetBlockHash().GetHex();
+
+        return "";
+    }
+
+    // Short forms selects scan whole three months window for their first page. When inbox has a full page
+    // of events the window starts at height of its last one. Inbox may keep events the selects drop (e.g. of
+    // deleted accounts), so caller reads the whole window again if narrowed one returns less than a page.
+    static int64_t NarrowEventsWindow(const JSONRPCRequest& request, const std::string& address, bool byActor,
+        int64_t heightMax, int64_t heightMin, int64_t blockNum, const std::set<ShortTxType>& filters, const std::set<ShortTxType>& inboxTypes)
+    {
+        std::set<ShortTxType> types;
+        for (auto type : inboxTypes)
+            if (filters.empty() || filters.find(type) != filters.end())
+                types.insert(type);
+
+        auto boundary = request.DbConnection()->WebRpcRepoInst->GetEventsInboxBoundary(address, byActor, heightMax, heightMin, blockNum, types);
+        if (!boundary || !PocketServices::WebPostProcessorInst.EventsInboxCovers(*boundary, heightMax, ActiveBlockHash(heightMax)))
+            return heightMin;
+
+        // Window lower bound is excluding - all events of boundary block are kept
+        return std::max(heightMin, *boundary - 1);
+    }
+
     RPCHelpMan GetEvents()
     {
         return RPCHelpMan{"GetEvents",
@@ -1294,7 +1384,17 @@ namespace PocketWeb::PocketWebRpc
             }
         }
 
-        auto shortTxs = request.DbConnection()->WebRpcRepoInst->GetEventsForAddresses(address, heightMax, heightMin, blockNum, filters);
+        auto narrowedMin = NarrowEventsWindow(request, address, false, heightMax, heightMin, blockNum, filters, {
+            ShortTxType::Referal,
+            ShortTxType::Comment,
+            ShortTxType::Subscriber,
+            ShortTxType::CommentScore,
+            ShortTxType::ContentScore,
+            ShortTxType::Repost });
+
+        auto shortTxs = request.DbConnection()->WebRpcRepoInst->GetEventsForAddresses(address, heightMax, narrowedMin, blockNum, filters);
+        if (narrowedMin != heightMin && shortTxs.size() < PocketDb::WebRpcRepository::ShortFormsPageSize)
+            shortTxs = request.DbConnection()->WebRpcRepoInst->GetEventsForAddresses(address, heightMax, heightMin, blockNum, filters);
         UniValue res(UniValue::VARR);
         for (const auto& tx: shortTxs) {
             res.push_back(tx.Serialize());
@@ -1357,6 +1457,21 @@ namespace PocketWeb::PocketWebRpc
             }
         }
 
+        // Notifications of recent blocks are precalculated once by WebPostProcessor
+        std::string blockHash;
+        {
+            LOCK(cs_main);
+            if (auto pindex = ChainActive()[height]; pindex)
+                blockHash = pindex->GetBlockHash().GetHex();
+        }
+
+        if (auto records = PocketServices::WebPostProcessorInst.GetNotifications(height, blockHash); records)
+        {
+            return NotificationsReconstructor::BuildResult(*records, [&filters](const ShortTxType& type) {
+                return filters.empty() || filters.find(type) != filters.end();
+            }).Serialize();
+        }
+
         return request.DbConnection()->WebRpcRepoInst->GetNotifications(height, filters);
     },
        };
@@ -1427,7 +1542,15 @@ namespace PocketWeb::PocketWebRpc
             }
         }
 
-        auto shortTxs = request.DbConnection()->WebRpcRepoInst->GetActivities(address, heightMax, heightMin, blockNum, filters);
+        auto narrowedMin = NarrowEventsWindow(request, address, true, heightMax, heightMin, blockNum, filters, {
+            ShortTxType::Comment,
+            ShortTxType::Subscriber,
+            ShortTxType::CommentScore,
+            ShortTxType::ContentScore });
+
+        auto shortTxs = request.DbConnection()->WebRpcRepoInst->GetActivities(address, heightMax, narrowedMin, blockNum, filters);
+        if (narrowedMin != heightMin && shortTxs.size() < PocketDb::WebRpcRepository::ShortFormsPageSize)
+            shortTxs = request.DbConnection()->WebRpcRepoInst->GetActivities(address, heightMax, heightMin, blockNum, filters);
         UniValue res(UniValue::VARR);
         for (const auto& tx: shortTxs) {
             res.push_back(tx.Serialize());
@@ -1491,7 +1614,10 @@ namespace PocketWeb::PocketWebRpc
             }
         }
 
-        auto res = request.DbConnection()->WebRpcRepoInst->GetNotificationsSummary(heightMax, heightMin, addresses, filters);
+        // Read prepared events when inbox covers requested window
+        auto res = PocketServices::WebPostProcessorInst.EventsInboxCovers(heightMin, heightMax, ActiveBlockHash(heightMax)) ?
+            request.DbConnection()->WebRpcRepoInst->GetNotificationsSummaryInbox(heightMax, heightMin, addresses, filters) :
+            request.DbConnection()->WebRpcRepoInst->GetNotificationsSummary(heightMax, heightMin, addresses, filters);
         UniValue response(UniValue::VOBJ);
 
         for (const auto& addressEntry: res) {
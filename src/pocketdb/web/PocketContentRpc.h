@@ -27,6 +27,7 @@ namespace PocketWeb::PocketWebRpc
     RPCHelpMan GetProfileFeed();
     RPCHelpMan GetSubscribesFeed();
     RPCHelpMan GetContentsStatistic();
+    RPCHelpMan CheckContentStats();
     RPCHelpMan GetRandomContents();
     RPCHelpMan GetContentActions();
     RPCHelpMan GetEvents(); // TODO (losty): probably move to another place
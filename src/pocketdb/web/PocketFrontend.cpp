@@ -5,38 +5,71 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/web/PocketFrontend.h"
+#include "crypto/sha256.h"
+#include "util/strencodings.h"
+#include "boost/algorithm/string/trim.hpp"
 #include "fs.h"
 
 namespace PocketWeb
 {
     using namespace std;
 
-    tuple<bool, string> PocketFrontend::ReadFileFromDisk(const string& path)
+    static const int64_t DEFAULT_STATIC_CACHE_SIZE = 128;
+    static const int64_t DEFAULT_STATIC_CHECK_INTERVAL = 5;
+    static const int64_t DEFAULT_STATIC_MAX_AGE = 3600;
+
+    // Precompressed variants in order of preference
+    static const vector<pair<string, string>> Encodings{
+        {"br", ".br"},
+        {"gzip", ".gz"},
+    };
+
+    size_t StaticFile::Size() const
+    {
+        size_t size = Path.size() + Content.size();
+        for (const auto& variant : Variants)
+            size += variant->Size();
+
+        return size;
+    }
+
+    tuple<bool, string, time_t> PocketFrontend::ReadFileFromDisk(const string& path)
     {
         try
         {
-            string _path = (_rootPath / path).string();
+            auto _path = _rootPath / path;
 
             if (fs::exists(_path) && !fs::is_directory(_path))
             {
-                ifstream file(_path);
-                string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-                return {true, content};
+                auto lastWriteTime = fs::last_write_time(_path);
+
+                fsbridge::ifstream file(_path, std::ios::in | std::ios::binary);
+                string content;
+                content.reserve(fs::file_size(_path));
+                content.assign((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+                return {true, content, lastWriteTime};
             }
 
-            return {false, ""};
+            return {false, "", 0};
         }
         catch (const std::exception& e)
         {
             LogPrintf("Warning: failed read file %s with error %s\n", path, e.what());
-            return {false, ""};
+            return {false, "", 0};
         }
     }
 
+    time_t PocketFrontend::GetLastWriteTime(const string& path)
+    {
+        boost::system::error_code ec;
+        auto lastWriteTime = fs::last_write_time(_rootPath / path, ec);
+        return ec ? 0 : lastWriteTime;
+    }
+
     tuple<bool, shared_ptr<StaticFile>> PocketFrontend::ReadFile(const string& path)
     {
         // Try read file from disk
-        auto[readOk, content] = ReadFileFromDisk(path);
+        auto[readOk, content, lastWriteTime] = ReadFileFromDisk(path);
         if (!readOk)
             return {false, nullptr};
 
@@ -48,12 +81,32 @@ namespace PocketWeb
             _name = pathParts.back();
 
         // Build file struct
-        auto file = shared_ptr<StaticFile>(new StaticFile{
-            path,
-            _name,
-            DetectContentType(_name),
-            content
-        });
+        auto file = make_shared<StaticFile>();
+        file->Path = path;
+        file->Name = _name;
+        file->ContentType = DetectContentType(_name);
+        file->ETag = BuildETag(content);
+        file->Content = std::move(content);
+        file->LastWriteTime = lastWriteTime;
+
+        // Precompressed variants are prepared by frontend build and placed near original file
+        for (const auto&[encoding, extension] : Encodings)
+        {
+            auto[variantOk, variantContent, variantWriteTime] = ReadFileFromDisk(path + extension);
+            if (!variantOk || variantWriteTime < lastWriteTime)
+                continue;
+
+            auto variant = make_shared<StaticFile>();
+            variant->Path = path + extension;
+            variant->Name = _name;
+            variant->ContentType = file->ContentType;
+            variant->ContentEncoding = encoding;
+            variant->ETag = BuildETag(variantContent);
+            variant->Content = std::move(variantContent);
+            variant->LastWriteTime = variantWriteTime;
+
+            file->Variants.push_back(variant);
+        }
 
         return {true, file};
     }
@@ -73,11 +126,107 @@ namespace PocketWeb
         return MimeTypes["default"];
     }
 
+    string PocketFrontend::BuildETag(const string& content)
+    {
+        unsigned char hash[CSHA256::OUTPUT_SIZE];
+        CSHA256().Write((const unsigned char*) content.data(), content.size()).Finalize(hash);
+        return "\"" + HexStr(Span<const unsigned char>(hash, 16)) + "\"";
+    }
+
+    shared_ptr<StaticFile> PocketFrontend::SelectVariant(const shared_ptr<StaticFile>& file, const string& acceptEncoding)
+    {
+        if (!file || acceptEncoding.empty())
+            return file;
+
+        // Quality of every listed coding - "br;q=0, gzip;q=0.8, *"
+        map<string, double> accepted;
+        vector<string> codings;
+        boost::split(codings, acceptEncoding, boost::is_any_of(","));
+        for (const auto& coding : codings)
+        {
+            vector<string> params;
+            boost::split(params, coding, boost::is_any_of(";"));
+
+            auto name = params.front();
+            boost::trim(name);
+            if (name.empty())
+                continue;
+
+            double quality = 1;
+            for (size_t i = 1; i < params.size(); i++)
+            {
+                auto param = params[i];
+                boost::trim(param);
+                if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=')
+                {
+                    try { quality = std::stod(param.substr(2)); }
+                    catch (const std::exception&) { quality = 0; }
+                }
+            }
+
+            accepted[name] = quality;
+        }
+
+        auto any = accepted.find("*");
+
+        // Highest quality wins, equal qualities are resolved by server preference order of variants
+        shared_ptr<StaticFile> selected = file;
+        double selectedQuality = 0;
+        for (const auto& variant : file->Variants)
+        {
+            auto it = accepted.find(variant->ContentEncoding);
+            double quality = it != accepted.end() ? it->second : (any != accepted.end() ? any->second : 0);
+            if (quality > selectedQuality)
+            {
+                selected = variant;
+                selectedQuality = quality;
+            }
+        }
+
+        return selected;
+    }
+
+    bool PocketFrontend::MatchETag(const string& ifNoneMatch, const string& etag)
+    {
+        // Weak comparison as required for If-None-Match - "W/" prefix is ignored on both sides
+        auto opaque = [](string tag) {
+            boost::trim(tag);
+            if (tag.rfind("W/", 0) == 0)
+                tag = tag.substr(2);
+            return tag;
+        };
+
+        auto _etag = opaque(etag);
+
+        vector<string> tags;
+        boost::split(tags, ifNoneMatch, boost::is_any_of(","));
+        for (const auto& tag : tags)
+        {
+            auto _tag = opaque(tag);
+            if (_tag == "*" || (!_tag.empty() && _tag == _etag))
+                return true;
+        }
+
+        return false;
+    }
+
+    string PocketFrontend::CacheControl(const StaticFile& file) const
+    {
+        // Html entry points are always revalidated by ETag, so new frontend releases are picked up immediately
+        if (file.ContentType == MimeTypes.at("html"))
+            return "no-cache";
+
+        return strprintf("public, max-age=%d", gArgs.GetArg("-staticmaxage", DEFAULT_STATIC_MAX_AGE));
+    }
+
     void PocketFrontend::Init()
     {
         string _argPath = gArgs.GetArg("-staticpath", "wwwroot");
         _rootPath = (_argPath == "wwwroot") ? GetDataDir() / "wwwroot" : _argPath;
 
+        CacheMaxSize = (size_t) std::max((int64_t) 0, gArgs.GetArg("-staticcachesize", DEFAULT_STATIC_CACHE_SIZE)) * 1024 * 1024;
+        CacheCheckInterval = gArgs.GetArg("-staticcheckinterval", DEFAULT_STATIC_CHECK_INTERVAL);
+
         // Create directory structure
         try
         {
@@ -90,24 +239,21 @@ namespace PocketWeb
                 throw;
         }
 
-        auto testContent = shared_ptr<StaticFile>(new StaticFile{
-            "/404.html",
-            "404.html",
-            "",
-            "<html><body>Not Found</body></html>"
-        });
+        auto testContent = make_shared<StaticFile>();
+        testContent->Path = "/404.html";
+        testContent->Name = "404.html";
+        testContent->Content = "<html><body>Not Found</body></html>";
+        testContent->ETag = BuildETag(testContent->Content);
 
-        LOCK(CacheMutex);
-        Cache.emplace(
-            "/404.html",
-            testContent
-        );
+        CacheEmplace("/404.html", testContent);
     }
 
     void PocketFrontend::ClearCache()
     {
         LOCK(CacheMutex);
         Cache.clear();
+        CacheLru.clear();
+        CacheSize = 0;
 
         LogPrint(BCLog::RESTFRONTEND, "Cache cleared\n");
     }
@@ -115,23 +261,85 @@ namespace PocketWeb
     void PocketFrontend::CacheEmplace(const string& path, shared_ptr <StaticFile>& content)
     {
         LOCK(CacheMutex);
-        if (Cache.find(path) == Cache.end())
+
+        auto size = content->Size();
+        if (size > CacheMaxSize)
+            return;
+
+        if (auto it = Cache.find(path); it != Cache.end())
         {
-            LogPrint(BCLog::RESTFRONTEND, "File '%s' emplaced in cache\n", path);
-            Cache.emplace(path, content);
+            CacheSize -= it->second.File->Size();
+            CacheLru.erase(it->second.LruIt);
+            Cache.erase(it);
         }
+
+        // Evict least recently used files
+        while (CacheSize + size > CacheMaxSize && !CacheLru.empty())
+        {
+            auto it = Cache.find(CacheLru.back());
+            CacheSize -= it->second.File->Size();
+            Cache.erase(it);
+            CacheLru.pop_back();
+        }
+
+        CacheLru.push_front(path);
+        Cache.emplace(path, CacheEntry{content, CacheLru.begin(), GetTime()});
+        CacheSize += size;
+
+        LogPrint(BCLog::RESTFRONTEND, "File '%s' emplaced in cache\n", path);
     }
 
-    tuple<bool, shared_ptr<StaticFile>> PocketFrontend::CacheGet(const string& path)
+    void PocketFrontend::CacheErase(const string& path)
     {
         LOCK(CacheMutex);
-        if (Cache.find(path) != Cache.end())
+
+        if (auto it = Cache.find(path); it != Cache.end())
         {
-            LogPrint(BCLog::RESTFRONTEND, "File '%s' found in cache\n", path);
-            return {true, Cache.at(path)};
+            CacheSize -= it->second.File->Size();
+            CacheLru.erase(it->second.LruIt);
+            Cache.erase(it);
         }
+    }
 
-        return {false, nullptr};
+    tuple<bool, shared_ptr<StaticFile>> PocketFrontend::CacheGet(const string& path)
+    {
+        shared_ptr<StaticFile> file;
+        bool check = false;
+
+        {
+            LOCK(CacheMutex);
+
+            auto it = Cache.find(path);
+            if (it == Cache.end())
+                return {false, nullptr};
+
+            CacheLru.splice(CacheLru.begin(), CacheLru, it->second.LruIt);
+            file = it->second.File;
+
+            // Files on disk are checked for changes not more often than once per interval
+            auto now = GetTime();
+            if (CacheCheckInterval >= 0 && now - it->second.CheckedTime >= CacheCheckInterval && file->LastWriteTime != 0)
+            {
+                it->second.CheckedTime = now;
+                check = true;
+            }
+        }
+
+        if (check && GetLastWriteTime(path) != file->LastWriteTime)
+        {
+            LogPrint(BCLog::RESTFRONTEND, "File '%s' changed on disk\n", path);
+            CacheErase(path);
+            return {false, nullptr};
+        }
+
+        LogPrint(BCLog::RESTFRONTEND, "File '%s' found in cache\n", path);
+        return {true, file};
+    }
+
+    tuple<int64_t, int64_t> PocketFrontend::Statistic()
+    {
+        LOCK(CacheMutex);
+        return { (int64_t) Cache.size(), (int64_t) CacheSize };
     }
 
     tuple <HTTPStatusCode, shared_ptr<StaticFile>> PocketFrontend::NotFound()
@@ -15,6 +15,9 @@
 #include "boost/algorithm/string/split.hpp"
 #include "boost/algorithm/string/classification.hpp"
 
+#include <list>
+#include <unordered_map>
+
 namespace PocketWeb
 {
     using namespace std;
@@ -25,6 +28,21 @@ namespace PocketWeb
         string Name;
         string ContentType;
         string Content;
+
+        // Empty for identity, "gzip" or "br" for precompressed variants
+        string ContentEncoding;
+
+        // Strong validator - hash of content
+        string ETag;
+
+        // Last write time of file on disk, used for change detection
+        time_t LastWriteTime = 0;
+
+        // Precompressed variants found on disk near the file (file.js.br, file.js.gz)
+        vector<shared_ptr<StaticFile>> Variants;
+
+        // Memory used by file with all variants
+        size_t Size() const;
     };
 
     class PocketFrontend
@@ -33,8 +51,20 @@ namespace PocketWeb
 
         boost::filesystem::path _rootPath;
 
+        struct CacheEntry
+        {
+            shared_ptr<StaticFile> File;
+            list<string>::iterator LruIt;
+            int64_t CheckedTime;
+        };
+
         Mutex CacheMutex;
-        map<string, shared_ptr<StaticFile>> Cache;
+        unordered_map<string, CacheEntry> Cache;
+        // Most recently used paths at front
+        list<string> CacheLru;
+        size_t CacheSize = 0;
+        size_t CacheMaxSize = 0;
+        int64_t CacheCheckInterval = 0;
 
         map<string, string> MimeTypes{
             {"default", "application/octet-stream"},
@@ -48,12 +78,18 @@ namespace PocketWeb
             {"jpg",     "image/jpeg"},
         };
 
-        tuple<bool, string> ReadFileFromDisk(const string& path);
+        tuple<bool, string, time_t> ReadFileFromDisk(const string& path);
+
+        time_t GetLastWriteTime(const string& path);
 
         tuple<bool, shared_ptr<StaticFile>> ReadFile(const string& path);
 
         string DetectContentType(string fileName);
 
+        static string BuildETag(const string& content);
+
+        void CacheErase(const string& path);
+
         tuple <HTTPStatusCode, shared_ptr<StaticFile>> NotFound();
 
     public:
@@ -70,6 +106,18 @@ namespace PocketWeb
 
         tuple<HTTPStatusCode, shared_ptr<StaticFile>> GetFile(const string& path, bool stopRecurse = false);
 
+        // Select precompressed variant accepted by client or file itself
+        static shared_ptr<StaticFile> SelectVariant(const shared_ptr<StaticFile>& file, const string& acceptEncoding);
+
+        // If-None-Match value matches ETag: list of tags, weak tags or "*"
+        static bool MatchETag(const string& ifNoneMatch, const string& etag);
+
+        // Cache-Control header value for file
+        string CacheControl(const StaticFile& file) const;
+
+        // Cached files count and memory used
+        tuple<int64_t, int64_t> Statistic();
+
     };
 
 } // namespace PocketWeb
@@ -122,6 +122,7 @@ static const CRPCCommand commands[] =
     {"system",         "getnodeinfo",                      &GetNodeInfo,                    {}},
     {"system",         "gettime",                          &GetTime,                        {}},
     {"system",         "getcoininfo",                      &GetCoinInfo,                    {"height"}},
+    {"system",         "getrequeststatistic",              &GetRequestStatistic,            {}},
 
     // Transactions
     {"transaction",    "getrawtransaction",                &GetTransaction,                 {"transactions"}},
@@ -138,6 +139,13 @@ static const CRPCCommand commands_post[] =
 };
 // @formatter:on
 
+// @formatter:off
+static const CRPCCommand commands_private[] =
+{
+    {"contents",       "checkcontentstats",                &CheckContentStats,              {"txids", "count"}},
+};
+// @formatter:on
+
 void RegisterPocketnetWebRPCCommands(CRPCTable &tableRPC, CRPCTable &tablePostRPC)
 {
     for (const auto& command : commands)
@@ -146,3 +154,9 @@ void RegisterPocketnetWebRPCCommands(CRPCTable &tableRPC, CRPCTable &tablePostRP
     for (const auto& command : commands_post)
         tablePostRPC.appendCommand(command.name, &command);
 }
+
+void RegisterPocketnetPrivateRPCCommands(CRPCTable &tableRPC)
+{
+    for (const auto& command : commands_private)
+        tableRPC.appendCommand(command.name, &command);
+}
@@ -5,6 +5,9 @@
 #include "pocketdb/web/PocketSystemRpc.h"
 #include "rpc/blockchain.h"
 #include "rpc/util.h"
+#include "pocketdb/pocketnet.h"
+#include "init.h"
+#include "httpserver.h"
 
 namespace PocketWeb::PocketWebRpc
 {
@@ -153,6 +156,80 @@ namespace PocketWeb::PocketWebRpc
                                 {RPCResult::Type::NUM, "http", ""},
                                 {RPCResult::Type::NUM, "https", ""},
                             }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "weblag", "Blocks not processed yet by web db workers",
+                            {
+                                {RPCResult::Type::NUM, "tags", ""},
+                                {RPCResult::Type::NUM, "search", ""},
+                                {RPCResult::Type::NUM, "notifications", ""},
+                                {RPCResult::Type::NUM, "badges", ""},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "profileloader", "Batching of account profile requests",
+                            {
+                                {RPCResult::Type::NUM, "requests", ""},
+                                {RPCResult::Type::NUM, "addresses", ""},
+                                {RPCResult::Type::NUM, "cachehits", ""},
+                                {RPCResult::Type::NUM, "queries", ""},
+                                {RPCResult::Type::NUM, "queriedaddresses", ""},
+                                {RPCResult::Type::NUM, "avgbatchsize", "Requests served by one query"},
+                                {RPCResult::Type::NUM, "sqlreduction", "Part of sql queries saved by batching"},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "staticcache", "Static frontend files cache",
+                            {
+                                {RPCResult::Type::NUM, "files", "Cached files"},
+                                {RPCResult::Type::NUM, "size", "Memory used by cached files with variants, bytes"},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "workqueues", "Public API work queues",
+                            {
+                                {
+                                    RPCResult::Type::OBJ, "get", "",
+                                    {
+                                        {RPCResult::Type::NUM, "depth", "Queued requests"},
+                                        {RPCResult::Type::NUM, "cheap", "Queued requests of cheap lane"},
+                                        {RPCResult::Type::NUM, "heavy", "Queued requests of heavy lane"},
+                                        {RPCResult::Type::NUM, "sources", "Client addresses with queued requests"},
+                                        {RPCResult::Type::NUM, "cheaptotal", ""},
+                                        {RPCResult::Type::NUM, "heavytotal", ""},
+                                        {RPCResult::Type::NUM, "rejected", "Requests rejected with full queue"},
+                                        {RPCResult::Type::NUM, "displaced", "Requests displaced by requests of other clients"},
+                                        {RPCResult::Type::NUM, "expired", "Requests shed after queue deadline"},
+                                    }
+                                },
+                                {
+                                    RPCResult::Type::OBJ, "post", "",
+                                    {
+                                        {RPCResult::Type::ELISION, "", "Same fields as get"},
+                                    }
+                                },
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "workerpool", "Threads shared by public sockets",
+                            {
+                                {RPCResult::Type::NUM, "threads", ""},
+                                {
+                                    RPCResult::Type::OBJ_DYN, "queues", "",
+                                    {
+                                        {
+                                            RPCResult::Type::OBJ, "name", "public, post, static or rest",
+                                            {
+                                                {RPCResult::Type::NUM, "homethreads", "Threads taking requests of queue first"},
+                                                {RPCResult::Type::NUM, "depth", "Queued requests"},
+                                                {RPCResult::Type::NUM, "executed", ""},
+                                                {RPCResult::Type::NUM, "stolen", "Requests executed by threads of other queues"},
+                                                {RPCResult::Type::NUM, "utilization", "Part of pool time spent on queue since start"},
+                                            }
+                                        },
+                                    }
+                                },
+                            }
                         }
                     },
                 },
@@ -217,11 +294,76 @@ namespace PocketWeb::PocketWebRpc
         ports.pushKV("https", staticPort);
         entry.pushKV("ports", ports);
 
+        UniValue webLag(UniValue::VOBJ);
+        for (const auto& [stage, lag] : PocketServices::WebPostProcessorInst.GetLag())
+            webLag.pushKV(stage, lag);
+        entry.pushKV("weblag", webLag);
+
+        entry.pushKV("profileloader", PocketDb::AccountProfileLoaderInst.GetStatistic());
+
+        auto[staticFiles, staticSize] = PocketWeb::PocketFrontendInst.Statistic();
+        UniValue staticCache(UniValue::VOBJ);
+        staticCache.pushKV("files", staticFiles);
+        staticCache.pushKV("size", staticSize);
+        entry.pushKV("staticcache", staticCache);
+
+        if (g_webSocket && g_webSocket->m_workQueue && g_webSocket->m_workPostQueue)
+        {
+            UniValue workQueues(UniValue::VOBJ);
+            workQueues.pushKV("get", g_webSocket->m_workQueue->GetStatistic());
+            workQueues.pushKV("post", g_webSocket->m_workPostQueue->GetStatistic());
+            entry.pushKV("workqueues", workQueues);
+        }
+
+        entry.pushKV("workerpool", GetHTTPWorkerPoolStatistic());
+
         return entry;
     },
         };
     }
     
+    RPCHelpMan GetRequestStatistic()
+    {
+        return RPCHelpMan{"getrequeststatistic",
+                "\nReturns percentiles of queue wait and execution time in milliseconds and reply size in bytes\n"
+                "for every RPC method over the last one or two statistic periods (-statdepth).\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "Statistic by method name",
+                    {
+                        {RPCResult::Type::OBJ, "method", "",
+                        {
+                            {RPCResult::Type::NUM, "count", ""},
+                            {RPCResult::Type::NUM, "failed", ""},
+                            {RPCResult::Type::OBJ, "queuewait", "", {
+                                {RPCResult::Type::NUM, "p50", ""},
+                                {RPCResult::Type::NUM, "p95", ""},
+                                {RPCResult::Type::NUM, "p99", ""},
+                            }},
+                            {RPCResult::Type::OBJ, "execution", "", {
+                                {RPCResult::Type::NUM, "p50", ""},
+                                {RPCResult::Type::NUM, "p95", ""},
+                                {RPCResult::Type::NUM, "p99", ""},
+                            }},
+                            {RPCResult::Type::OBJ, "outputsize", "", {
+                                {RPCResult::Type::NUM, "p50", ""},
+                                {RPCResult::Type::NUM, "p95", ""},
+                                {RPCResult::Type::NUM, "p99", ""},
+                            }},
+                        }},
+                    },
+                },
+                RPCExamples{
+                    HelpExampleCli("getrequeststatistic", "") +
+                    HelpExampleRpc("getrequeststatistic", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+    {
+        return gStatEngineInstance.CompileMethodStatsAsJson();
+    },
+        };
+    }
+
     RPCHelpMan GetCoinInfo()
     {
         return RPCHelpMan{"getcoininfo",
@@ -5,6 +5,7 @@
 #include "pocketdb/web/SearchRpc.h"
 #include "rpc/util.h"
 #include "validation.h"
+#include "pocketdb/pocketnet.h"
 
 namespace PocketWeb::PocketWebRpc
 {
@@ -88,7 +89,20 @@ namespace PocketWeb::PocketWebRpc
         // Search simple tags without join content data
         if (type == "tags")
         {
-            UniValue data = request.DbConnection()->SearchRepoInst->SearchTags(searchRequest);
+            UniValue data(UniValue::VARR);
+
+            // Substring search in memory copy of tags, in db while index not loaded
+            auto& searchIndex = PocketServices::WebPostProcessorInst.GetSearchIndex();
+            if (searchIndex.IsTagsReady())
+            {
+                for (const auto& tag : searchIndex.SearchTags(searchRequest.Keyword, searchRequest.PageStart, searchRequest.PageSize))
+                    data.push_back(tag);
+            }
+            else
+            {
+                data = request.DbConnection()->SearchRepoInst->SearchTags(searchRequest);
+            }
+
             result.pushKV("tags", UniValue(UniValue::VOBJ));
             result.At("tags").pushKV("data", data);
         }
@@ -151,8 +165,13 @@ namespace PocketWeb::PocketWebRpc
                 // ContentFieldType_AccountUserUrl
             };
 
-            // Search
-            auto ids = request.DbConnection()->SearchRepoInst->SearchUsersOld(searchRequest);
+            // Search actual names in memory, history search and search while index not loaded in db
+            vector<int64_t> ids;
+            auto& searchIndex = PocketServices::WebPostProcessorInst.GetSearchIndex();
+            if (searchRequest.TopBlock <= 0 && searchIndex.IsUsersReady())
+                ids = searchIndex.SearchUsers(searchRequest.Keyword, searchRequest.PageStart, searchRequest.PageSize);
+            else
+                ids = request.DbConnection()->SearchRepoInst->SearchUsersOld(searchRequest);
             
             // Get accounts data
             auto accounts = request.DbConnection()->WebRpcRepoInst->GetAccountProfiles(ids);
@@ -199,7 +218,25 @@ namespace PocketWeb::PocketWebRpc
         if (keyword.size() <= 1)
             return result;
 
-        auto ids = request.DbConnection()->SearchRepoInst->SearchUsers(keyword);
+        // Names autocomplete from memory while index is loaded, about field only in db
+        static const int count = 10;
+        auto& searchIndex = PocketServices::WebPostProcessorInst.GetSearchIndex();
+        auto names = searchIndex.IsUsersReady() ?
+            searchIndex.SearchUsers(keyword, 0, count) :
+            request.DbConnection()->SearchRepoInst->SearchUsersNames(keyword, count);
+        auto about = request.DbConnection()->SearchRepoInst->SearchUsersAbout(keyword, count);
+
+        // Names and about matches go in turn by their rank
+        vector<int64_t> ids;
+        for (size_t i = 0; i < std::max(names.size(), about.size()); i++)
+        {
+            for (const auto* list : { &names, &about })
+            {
+                if (i < list->size() && find(ids.begin(), ids.end(), (*list)[i]) == ids.end())
+                    ids.push_back((*list)[i]);
+            }
+        }
+
         auto usersProfiles = request.DbConnection()->WebRpcRepoInst->GetAccountProfiles(ids);
         
         for (auto& id : ids)
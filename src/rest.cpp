@@ -7,6 +7,7 @@
 #include <chainparams.h>
 #include <core_io.h>
 #include <httpserver.h>
+#include <init.h>
 #include <index/txindex.h>
 #include <node/context.h>
 #include <primitives/block.h>
@@ -822,6 +823,13 @@ static bool rest_emission(const util::Ref& context, HTTPRequest* req, const std:
     return true;
 }
 
+static bool rest_metrics(const util::Ref& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    req->WriteHeader("Content-Type", "text/plain; version=0.0.4");
+    req->WriteReply(HTTP_OK, gStatEngineInstance.CompileMetricsAsText());
+    return true;
+}
+
 static bool get_static_status(HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
@@ -908,6 +916,8 @@ static bool debug_index_block(const util::Ref& context, HTTPRequest* req, const
     {
         PocketDb::SQLiteDbInst.DropIndexes();
         PocketDb::ChainRepoInst.ClearDatabase();
+        PocketDb::RatingsRepoInst.ResetLikers();
+        PocketDb::AccountStateCacheInst.Clear();
         PocketDb::SQLiteDbInst.CreateStructure();
     }
 
@@ -1033,8 +1043,25 @@ static bool get_static_web(const util::Ref& context, HTTPRequest* req, const std
 
     if (auto[code, file] = PocketWeb::PocketFrontendInst.GetFile(strURIPart); code == HTTP_OK)
     {
-        req->WriteHeader("Content-Type", file->ContentType);
-        req->WriteReply(code, file->Content);
+        auto variant = PocketWeb::PocketFrontend::SelectVariant(file, req->GetHeader("Accept-Encoding").second);
+
+        if (!file->Variants.empty())
+            req->WriteHeader("Vary", "Accept-Encoding");
+        req->WriteHeader("ETag", variant->ETag);
+        req->WriteHeader("Cache-Control", PocketWeb::PocketFrontendInst.CacheControl(*variant));
+
+        if (auto[ok, etag] = req->GetHeader("If-None-Match"); ok && PocketWeb::PocketFrontend::MatchETag(etag, variant->ETag))
+        {
+            req->WriteReply(HTTP_NOT_MODIFIED);
+            return true;
+        }
+
+        req->WriteHeader("Content-Type", variant->ContentType);
+        if (!variant->ContentEncoding.empty())
+            req->WriteHeader("Content-Encoding", variant->ContentEncoding);
+
+        // Content is referenced from cache without copying
+        req->WriteReply(code, std::shared_ptr<const std::string>(variant, &variant->Content));
         return true;
     }
     else
@@ -1110,6 +1137,7 @@ static const struct
     {"/rest/blockhashbyheight/", rest_blockhash_by_height},
     {"/rest/blockhash",          rest_blockhash},
     {"/rest/emission",           rest_emission},
+    {"/rest/metrics",            rest_metrics},
 };
 
 void StartREST(const util::Ref& context)
@@ -44,6 +44,18 @@ const int& RPCCacheEntry::GetValidUntill() const
 {
     return m_validUntill;
 }
+const std::shared_ptr<const HTTPDeflateChunk>& RPCCacheEntry::GetCompressed() const
+{
+    return m_compressed;
+}
+void RPCCacheEntry::SetCompressed(std::shared_ptr<const HTTPDeflateChunk> compressed)
+{
+    m_compressed = std::move(compressed);
+}
+size_t RPCCacheEntry::GetCompressedSize() const
+{
+    return m_compressed ? m_compressed->data.size() : 0;
+}
 
 RPCCache::RPCCache() 
 {
@@ -74,7 +86,7 @@ void RPCCache::ClearOverdue(int height)
     for (auto itr = m_cache.begin(); itr != m_cache.end();) {
         if(itr->second.GetValidUntill() <= height) {
             // TODO: calculate size more accurate, probably move to RPCCache entry or smth.
-            m_cacheSize -= (itr->first.size() + itr->second.GetData().write().size()); // Decreasing cache size 
+            m_cacheSize -= (itr->first.size() + itr->second.GetData().write().size() + itr->second.GetCompressedSize()); // Decreasing cache size 
             itr = m_cache.erase(itr);
         } else {
             itr++;
@@ -102,7 +114,7 @@ void RPCCache::Put(const std::string& path, const UniValue& content, const int&
     if (auto entry = m_cache.find(path); entry != m_cache.end()) {
         LogPrint(BCLog::RPC, "RPC cache put update '%s'\n", path);
         // Adjust cache size, remove old element size, add new element size
-        m_cacheSize -= entry->second.GetData().size();
+        m_cacheSize -= entry->second.GetData().size() + entry->second.GetCompressedSize();
         m_cacheSize += content.write().size();
     } else {
         LogPrint(BCLog::RPC, "RPC cache put '%s', size %d\n", path, size);
@@ -143,6 +155,40 @@ void RPCCache::PutRpcCache(const JSONRPCRequest& req, const UniValue& content)
     }
 }
 
+std::shared_ptr<const HTTPDeflateChunk> RPCCache::GetCompressedRpcCache(const JSONRPCRequest& req)
+{
+    if (m_supportedMethods.find(req.strMethod) == m_supportedMethods.end())
+        return nullptr;
+
+    LOCK(CacheMutex);
+    if (auto entry = m_cache.find(MakeHashKey(req)); entry != m_cache.end())
+        return entry->second.GetCompressed();
+
+    return nullptr;
+}
+
+void RPCCache::PutCompressedRpcCache(const JSONRPCRequest& req, std::shared_ptr<const HTTPDeflateChunk> compressed)
+{
+    if (!compressed || m_supportedMethods.find(req.strMethod) == m_supportedMethods.end())
+        return;
+
+    LOCK(CacheMutex);
+
+    // Entry could be dropped or updated meanwhile - readers check that compressed data matches entry
+    auto entry = m_cache.find(MakeHashKey(req));
+    if (entry == m_cache.end())
+        return;
+
+    int size = (int) compressed->data.size() - (int) entry->second.GetCompressedSize();
+    if (m_maxCacheSize < size + m_cacheSize) {
+        LogPrint(BCLog::RPC, "RPC cache over size limit for compressed reply: current = %d, max = %d\n", size + m_cacheSize, m_maxCacheSize);
+        return;
+    }
+
+    m_cacheSize += size;
+    entry->second.SetCompressed(std::move(compressed));
+}
+
 std::tuple<int64_t, int64_t> RPCCache::Statistic()
 {
     LOCK(CacheMutex);
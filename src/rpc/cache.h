@@ -8,6 +8,9 @@
 #include <sync.h>
 #include <logging.h>
 #include <validation.h>
+#include <httpcompression.h>
+
+#include <memory>
 
 class JSONRPCRequest;
 
@@ -34,9 +37,14 @@ public:
     RPCCacheEntry(UniValue data, int validUntill);
     const UniValue& GetData() const;
     const int& GetValidUntill() const;
+    const std::shared_ptr<const HTTPDeflateChunk>& GetCompressed() const;
+    void SetCompressed(std::shared_ptr<const HTTPDeflateChunk> compressed);
+    size_t GetCompressedSize() const;
 private:
     int m_validUntill;
     UniValue m_data;
+    // Serialized and compressed data, shared by compressed replies of all hits
+    std::shared_ptr<const HTTPDeflateChunk> m_compressed;
 };
 
 class RPCCache
@@ -107,6 +115,12 @@ public:
 
     void PutRpcCache(const JSONRPCRequest& req, const UniValue& content);
 
+    // Compressed result kept with cached entry of request, nullptr if there is none
+    std::shared_ptr<const HTTPDeflateChunk> GetCompressedRpcCache(const JSONRPCRequest& req);
+
+    // Keep compressed result with cached entry of request until entry is dropped
+    void PutCompressedRpcCache(const JSONRPCRequest& req, std::shared_ptr<const HTTPDeflateChunk> compressed);
+
     std::tuple<int64_t, int64_t> Statistic();
 
 };
@@ -11,6 +11,7 @@
 #include <util/strencodings.h>
 #include <util/system.h>
 #include <init.h>
+#include "pocketdb/helpers/JsonWriter.h"
 
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -243,7 +244,7 @@ bool IsDeprecatedRPCEnabled(const std::string& method)
     return find(enabled_methods.begin(), enabled_methods.end(), method) != enabled_methods.end();
 }
 
-static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req, const CRPCTable& tableRPC)
+UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req, const CRPCTable& tableRPC)
 {
     UniValue rpc_result(UniValue::VOBJ);
 
@@ -272,7 +273,7 @@ std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, c
     for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
         ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx], tableRPC));
 
-    return ret.write() + "\n";
+    return PocketHelpers::JsonWriter::Write(ret) + "\n";
 }
 
 /**
@@ -355,6 +356,16 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     throw JSONRPCError(RPC_METHOD_NOT_FOUND, "Method not found");
 }
 
+std::shared_ptr<const HTTPDeflateChunk> CRPCTable::getCompressedCache(const JSONRPCRequest& request) const
+{
+    return cache->GetCompressedRpcCache(request);
+}
+
+void CRPCTable::putCompressedCache(const JSONRPCRequest& request, std::shared_ptr<const HTTPDeflateChunk> compressed) const
+{
+    cache->PutCompressedRpcCache(request, std::move(compressed));
+}
+
 static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler, RPCCache* cache)
 {
     auto start = gStatEngineInstance.GetCurrentSystemTime();
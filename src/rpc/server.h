@@ -161,6 +161,16 @@ public:
      */
     UniValue execute(const JSONRPCRequest &request) const;
 
+    /**
+     * Compressed result kept with cached reply of request, nullptr if there is none.
+     */
+    std::shared_ptr<const HTTPDeflateChunk> getCompressedCache(const JSONRPCRequest& request) const;
+
+    /**
+     * Keep compressed result with cached reply of request, ignored for not cached requests.
+     */
+    void putCompressedCache(const JSONRPCRequest& request, std::shared_ptr<const HTTPDeflateChunk> compressed) const;
+
     /**
     * Returns a list of registered commands
     * @returns List of registered commands.
@@ -189,6 +199,8 @@ bool IsDeprecatedRPCEnabled(const std::string& method);
 void StartRPC();
 void InterruptRPC();
 void StopRPC();
+/** Execute one element of batch, errors are returned as reply object */
+UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req, const CRPCTable& tableRPC);
 std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq, const CRPCTable& tableRPC);
 
 // Retrieves any serialization flags requested in command line argument
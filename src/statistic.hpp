@@ -10,12 +10,18 @@
 #include "util/ref.h"
 #include "clientversion.h"
 #include <boost/thread.hpp>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <ctime>
+#include <map>
+#include <memory>
 #include <net.h>
 #include <numeric>
 #include <set>
+#include <unordered_map>
 
 namespace Statistic
 {
@@ -37,89 +43,321 @@ namespace Statistic
         RequestPayloadSize OutputSize;
     };
 
+    // Log-linear histogram in HdrHistogram style: exact values below SubBuckets,
+    // then SubBuckets buckets for every power of two - relative error is below 1/8.
+    // Recording is lock-free with relaxed atomic counters.
+    class Histogram
+    {
+    public:
+        static constexpr int SubBits = 3;
+        static constexpr int SubBuckets = 1 << SubBits;
+        static constexpr int Size = (64 - SubBits + 1) << SubBits;
+
+        using Counts = std::array<uint64_t, Size>;
+
+        void Record(uint64_t value)
+        {
+            _buckets[Index(value)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void Reset()
+        {
+            for (auto& bucket : _buckets)
+                bucket.store(0, std::memory_order_relaxed);
+        }
+
+        // Add own counts to snapshot
+        void AddTo(Counts& counts) const
+        {
+            for (int i = 0; i < Size; i++)
+                counts[i] += _buckets[i].load(std::memory_order_relaxed);
+        }
+
+        static int Index(uint64_t value)
+        {
+            if (value < (uint64_t) SubBuckets)
+                return (int) value;
+
+            int power = 63 - __builtin_clzll(value);
+            int sub = (int) ((value >> (power - SubBits)) & (SubBuckets - 1));
+            return ((power - SubBits + 1) << SubBits) + sub;
+        }
+
+        // Middle of values range of bucket
+        static uint64_t Value(int index)
+        {
+            if (index < SubBuckets)
+                return (uint64_t) index;
+
+            int shift = (index >> SubBits) - 1;
+            uint64_t lower = (uint64_t) (SubBuckets + (index & (SubBuckets - 1))) << shift;
+            return lower + ((uint64_t(1) << shift) >> 1);
+        }
+
+        static uint64_t Total(const Counts& counts)
+        {
+            return std::accumulate(counts.begin(), counts.end(), (uint64_t) 0);
+        }
+
+        static uint64_t Percentile(const Counts& counts, double quantile)
+        {
+            uint64_t total = Total(counts);
+            if (total == 0)
+                return 0;
+
+            auto rank = std::max((uint64_t) 1, (uint64_t) std::ceil(quantile * (double) total));
+
+            uint64_t seen = 0;
+            for (int i = 0; i < Size; i++)
+            {
+                seen += counts[i];
+                if (seen >= rank)
+                    return Value(i);
+            }
+
+            return Value(Size - 1);
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, Size> _buckets{};
+    };
+
+    // Metrics of requests to one method during one statistic period
+    struct RequestWindow
+    {
+        Histogram QueueWait;
+        Histogram Execution;
+        Histogram OutputSize;
+        std::atomic<uint64_t> Count{0};
+        std::atomic<uint64_t> Failed{0};
+        std::atomic<uint64_t> QueueWaitSum{0};
+        std::atomic<uint64_t> ExecutionSum{0};
+
+        void Reset()
+        {
+            QueueWait.Reset();
+            Execution.Reset();
+            OutputSize.Reset();
+            Count.store(0, std::memory_order_relaxed);
+            Failed.store(0, std::memory_order_relaxed);
+            QueueWaitSum.store(0, std::memory_order_relaxed);
+            ExecutionSum.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct MethodStats
+    {
+        // Current and previous statistic periods - percentiles are calculated over both
+        std::array<RequestWindow, 2> Windows;
+
+        // Totals since start for counters export
+        std::atomic<uint64_t> Count{0};
+        std::atomic<uint64_t> Failed{0};
+        std::atomic<uint64_t> QueueWaitSum{0};
+        std::atomic<uint64_t> ExecutionSum{0};
+        std::atomic<uint64_t> OutputSizeSum{0};
+    };
+
     class RequestStatEngine
     {
     public:
         RequestStatEngine() = default;
 
+        // Requests with more different keys are counted as "other"
+        static constexpr std::size_t MaxMethods = 512;
+
         void AddSample(const RequestSample& sample)
         {
             if (sample.TimestampEnd < sample.TimestampBegin)
                 return;
 
-            LOCK(_samplesLock);
-            _samples.push_back(sample);
+            auto queueWait = (uint64_t) std::max((int64_t) 0, (int64_t) (sample.TimestampExec - sample.TimestampBegin).count());
+            auto execution = (uint64_t) std::max((int64_t) 0, (int64_t) (sample.TimestampEnd - std::max(sample.TimestampExec, sample.TimestampBegin)).count());
+
+            auto& stats = GetMethodStats(sample.Key);
+            auto& window = stats.Windows[_window.load(std::memory_order_relaxed)];
+
+            window.QueueWait.Record(queueWait);
+            window.Execution.Record(execution);
+            window.OutputSize.Record(sample.OutputSize);
+            window.Count.fetch_add(1, std::memory_order_relaxed);
+            window.QueueWaitSum.fetch_add(queueWait, std::memory_order_relaxed);
+            window.ExecutionSum.fetch_add(execution, std::memory_order_relaxed);
+
+            stats.Count.fetch_add(1, std::memory_order_relaxed);
+            stats.QueueWaitSum.fetch_add(queueWait, std::memory_order_relaxed);
+            stats.ExecutionSum.fetch_add(execution, std::memory_order_relaxed);
+            stats.OutputSizeSum.fetch_add(sample.OutputSize, std::memory_order_relaxed);
+
+            if (sample.Failed)
+            {
+                window.Failed.fetch_add(1, std::memory_order_relaxed);
+                stats.Failed.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            // Whole samples are needed only for detailed statistic with top requests and source IPs
+            if (LogInstance().WillLogCategory(BCLog::STATDETAIL))
+            {
+                LOCK(_samplesLock);
+                _samples.push_back(sample);
+            }
         }
 
-        std::size_t GetNumSamplesSince(RequestTime time)
+        // Requests count, failed count, average request and execution time in current statistic period
+        std::tuple<uint64_t, uint64_t, RequestTime, RequestTime> GetCurrentPeriodTotals()
         {
-            LOCK(_samplesLock);
-            return std::count_if(
-                _samples.begin(),
-                _samples.end(),
-                [=](const RequestSample& sample)
-                {
-                    return sample.TimestampEnd >= time && sample.TimestampEnd <= RequestTime::max();
-                });
+            uint64_t count = 0, failed = 0, queueWait = 0, execution = 0;
+            int current = _window.load(std::memory_order_relaxed);
+
+            LOCK(_methodsLock);
+            for (const auto& [key, stats] : _methods)
+            {
+                const auto& window = stats->Windows[current];
+
+                Histogram::Counts counts{};
+                window.Execution.AddTo(counts);
+
+                count += Histogram::Total(counts);
+                failed += window.Failed.load(std::memory_order_relaxed);
+                queueWait += window.QueueWaitSum.load(std::memory_order_relaxed);
+                execution += window.ExecutionSum.load(std::memory_order_relaxed);
+            }
+
+            if (count == 0)
+                return {0, failed, RequestTime{}, RequestTime{}};
+
+            return {count, failed, RequestTime((queueWait + execution) / count), RequestTime(execution / count)};
         }
 
-        std::size_t GetNumFailedSamplesSince(RequestTime time)
+        // Average execution time of method over current and previous periods, zero if method is not known yet
+        RequestTime GetAverageExecution(const RequestKey& key)
         {
-            LOCK(_samplesLock);
-            return std::count_if(
-                _samples.begin(),
-                _samples.end(),
-                [=](const RequestSample& sample)
-                {
-                    return sample.TimestampEnd >= time && sample.TimestampEnd <= RequestTime::max() && sample.Failed;
-                });
+            uint64_t count = 0, execution = 0;
+
+            LOCK(_methodsLock);
+            auto it = _methods.find(key);
+            if (it == _methods.end())
+                return RequestTime{};
+
+            for (const auto& window : it->second->Windows)
+            {
+                count += window.Count.load(std::memory_order_relaxed);
+                execution += window.ExecutionSum.load(std::memory_order_relaxed);
+            }
+
+            return count == 0 ? RequestTime{} : RequestTime(execution / count);
         }
 
-        RequestTime GetAvgRequestTimeSince(RequestTime since)
+        // Windowed percentiles for every method
+        UniValue CompileMethodStatsAsJson()
         {
-            LOCK(_samplesLock);
+            UniValue result(UniValue::VOBJ);
 
-            if (_samples.empty())
-                return {};
-
-            RequestTime sum{};
-            std::size_t count{};
+            const auto percentiles_to_json = [](const Histogram::Counts& counts)
+            {
+                UniValue value(UniValue::VOBJ);
+                value.pushKV("p50", (int64_t) Histogram::Percentile(counts, 0.50));
+                value.pushKV("p95", (int64_t) Histogram::Percentile(counts, 0.95));
+                value.pushKV("p99", (int64_t) Histogram::Percentile(counts, 0.99));
+                return value;
+            };
 
-            for (auto& sample : _samples)
+            LOCK(_methodsLock);
+            for (const auto& [key, stats] : _methods)
             {
-                if (sample.TimestampEnd.count() > 0 && sample.TimestampEnd >= since && sample.Key != "WorkQueue::Enqueue")
+                Histogram::Counts queueWait{}, execution{}, outputSize{};
+                uint64_t failed = 0;
+                for (const auto& window : stats->Windows)
                 {
-                    sum += sample.TimestampEnd - sample.TimestampBegin;
-                    count++;
+                    window.QueueWait.AddTo(queueWait);
+                    window.Execution.AddTo(execution);
+                    window.OutputSize.AddTo(outputSize);
+                    failed += window.Failed.load(std::memory_order_relaxed);
                 }
+
+                UniValue method(UniValue::VOBJ);
+                method.pushKV("count", (int64_t) Histogram::Total(execution));
+                method.pushKV("failed", (int64_t) failed);
+                method.pushKV("queuewait", percentiles_to_json(queueWait));
+                method.pushKV("execution", percentiles_to_json(execution));
+                method.pushKV("outputsize", percentiles_to_json(outputSize));
+                result.pushKV(key, method);
             }
 
-            if (count <= 0) return {};
-            return sum / count;
+            return result;
         }
 
-
-        RequestTime GetAvgExecutionTimeSince(RequestTime since)
+        // Prometheus text exposition format: windowed quantiles with totals since start
+        std::string CompileMetricsAsText()
         {
-            LOCK(_samplesLock);
+            std::string result;
 
-            if (_samples.empty())
-                return {};
+            const auto escape = [](const std::string& value)
+            {
+                std::string escaped;
+                for (char c : value)
+                {
+                    if (c == '\\' || c == '"') escaped += '\\';
+                    if (c == '\n') { escaped += "\\n"; continue; }
+                    escaped += c;
+                }
+                return escaped;
+            };
 
-            RequestTime sum{};
-            std::size_t count{};
+            struct Metric
+            {
+                std::string Name;
+                std::string Help;
+                Histogram RequestWindow::* Field;
+                std::atomic<uint64_t> MethodStats::* Sum;
+            };
 
-            for (auto& sample : _samples)
+            const std::vector<Metric> metrics = {
+                { "pocketnet_rpc_queue_wait_milliseconds", "Time between request accept and execution start", &RequestWindow::QueueWait, &MethodStats::QueueWaitSum },
+                { "pocketnet_rpc_execution_milliseconds", "Request execution time", &RequestWindow::Execution, &MethodStats::ExecutionSum },
+                { "pocketnet_rpc_output_size_bytes", "Reply payload size", &RequestWindow::OutputSize, &MethodStats::OutputSizeSum },
+            };
+
+            LOCK(_methodsLock);
+
+            for (const auto& metric : metrics)
             {
-                if (sample.TimestampEnd.count() > 0 && sample.TimestampEnd >= since && sample.Key != "WorkQueue::Enqueue")
+                result += "# HELP " + metric.Name + " " + metric.Help + "\n";
+                result += "# TYPE " + metric.Name + " summary\n";
+
+                for (const auto& [key, stats] : _methods)
                 {
-                    sum += sample.TimestampEnd - sample.TimestampExec;
-                    count++;
+                    Histogram::Counts counts{};
+                    for (const auto& window : stats->Windows)
+                        (window.*metric.Field).AddTo(counts);
+
+                    auto label = "method=\"" + escape(key) + "\"";
+                    for (const auto& [quantileLabel, quantile] : std::vector<std::pair<std::string, double>>{ {"0.5", 0.5}, {"0.95", 0.95}, {"0.99", 0.99} })
+                        result += strprintf("%s{%s,quantile=\"%s\"} %d\n", metric.Name, label, quantileLabel, Histogram::Percentile(counts, quantile));
+
+                    result += strprintf("%s_sum{%s} %d\n", metric.Name, label, ((*stats).*metric.Sum).load(std::memory_order_relaxed));
+                    result += strprintf("%s_count{%s} %d\n", metric.Name, label, stats->Count.load(std::memory_order_relaxed));
                 }
             }
 
-            if (count <= 0) return {};
-            return sum / count;
+            result += "# HELP pocketnet_rpc_failed_total Failed requests\n";
+            result += "# TYPE pocketnet_rpc_failed_total counter\n";
+            for (const auto& [key, stats] : _methods)
+                result += strprintf("pocketnet_rpc_failed_total{method=\"%s\"} %d\n", escape(key), stats->Failed.load(std::memory_order_relaxed));
+
+            return result;
+        }
+
+        // Start new statistic period - previous one is kept for percentiles
+        void RotateWindow()
+        {
+            int next = 1 - _window.load(std::memory_order_relaxed);
+
+            LOCK(_methodsLock);
+            for (auto& [key, stats] : _methods)
+                stats->Windows[next].Reset();
+
+            _window.store(next, std::memory_order_relaxed);
         }
 
         std::vector<RequestSample> GetTopHeavyTimeSamplesSince(std::size_t limit, RequestTime since)
@@ -226,14 +464,16 @@ namespace Statistic
             chainStat.pushKV("PeersOUT", (int) node.connman->GetNodeCount(CConnman::NumConnections::CONNECTIONS_OUT));
             result.pushKV("General", chainStat);
 
+            auto [requestsAll, requestsFailed, avgReqTime, avgExecTime] = GetCurrentPeriodTotals();
+
             UniValue rpcStat(UniValue::VOBJ);
-            rpcStat.pushKV("RequestsAll", (int) GetNumSamplesSince(since));
-            rpcStat.pushKV("RequestsFailed", (int) GetNumFailedSamplesSince(since));
-            rpcStat.pushKV("AvgReqTime", GetAvgRequestTimeSince(since).count());
-            rpcStat.pushKV("AvgExecTime", GetAvgExecutionTimeSince(since).count());
-            rpcStat.pushKV("UniqueIPs", (int) unique_ips_count);
+            rpcStat.pushKV("RequestsAll", (int64_t) requestsAll);
+            rpcStat.pushKV("RequestsFailed", (int64_t) requestsFailed);
+            rpcStat.pushKV("AvgReqTime", avgReqTime.count());
+            rpcStat.pushKV("AvgExecTime", avgExecTime.count());
             if (LogInstance().WillLogCategory(BCLog::STATDETAIL))
             {
+                rpcStat.pushKV("UniqueIPs", (int) unique_ips_count);
                 rpcStat.pushKV("UniqueIps", unique_ips_json);
                 rpcStat.pushKV("TopTime", top_tm_json);
                 rpcStat.pushKV("TopInputSize", top_in_json);
@@ -306,6 +546,7 @@ namespace Statistic
                 LogPrint(BCLog::STATDETAIL, msg.c_str(), statLoggerSleep / 1000,
                     CompileStatsAsJsonSince(chunkSize, context).write(1));
 
+                RotateWindow();
                 RemoveSamplesBefore(chunkSize * 2);
                 m_interrupt.sleep_for(std::chrono::milliseconds{statLoggerSleep});
             }
@@ -317,6 +558,43 @@ namespace Statistic
         Mutex _samplesLock;
         bool shutdown = false;
 
+        // Methods are never removed, so pointers to stats stay valid
+        std::map<std::string, std::unique_ptr<MethodStats>> _methods;
+        Mutex _methodsLock;
+        std::atomic<int> _window{0};
+
+        MethodStats& GetMethodStats(const RequestKey& key)
+        {
+            // Every thread resolves its keys once and records without shared locks after that
+            thread_local const RequestStatEngine* cacheOwner = nullptr;
+            thread_local std::unordered_map<std::string, MethodStats*> cache;
+
+            if (cacheOwner != this)
+            {
+                cache.clear();
+                cacheOwner = this;
+            }
+
+            if (auto it = cache.find(key); it != cache.end())
+                return *it->second;
+
+            LOCK(_methodsLock);
+
+            auto it = _methods.find(key);
+            if (it == _methods.end())
+            {
+                auto name = _methods.size() < MaxMethods ? key : "other";
+                it = _methods.find(name);
+                if (it == _methods.end())
+                    it = _methods.emplace(name, std::make_unique<MethodStats>()).first;
+            }
+
+            if (cache.size() < MaxMethods)
+                cache.emplace(key, it->second.get());
+
+            return *it->second;
+        }
+
         void RemoveSamplesBefore(RequestTime time)
         {
             LOCK(_samplesLock);
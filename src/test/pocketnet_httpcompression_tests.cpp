@@ -0,0 +1,152 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <httpcompression.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <zlib.h>
+
+/** Decode body with zlib, which also verifies trailer checksum and length */
+static bool Inflate(HTTPEncoding encoding, const std::string& body, std::string& out)
+{
+    z_stream stream{};
+    if (inflateInit2(&stream, encoding == HTTPEncoding::Gzip ? 16 + MAX_WBITS : MAX_WBITS) != Z_OK)
+        return false;
+
+    stream.next_in = (Bytef*) body.data();
+    stream.avail_in = (uInt) body.size();
+
+    out.clear();
+    int ret = Z_OK;
+    while (ret == Z_OK)
+    {
+        char buffer[16384];
+        stream.next_out = (Bytef*) buffer;
+        stream.avail_out = sizeof(buffer);
+
+        ret = inflate(&stream, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+
+    // Whole body is consumed by single stream
+    bool ok = ret == Z_STREAM_END && stream.avail_in == 0;
+    inflateEnd(&stream);
+    return ok;
+}
+
+static std::string Pattern(size_t size)
+{
+    std::string data;
+    for (size_t i = 0; i < size; i++)
+        data += (char) ((i * 7 + i / 251) & 0xff);
+    return data;
+}
+
+static void CheckRoundTrip(const std::string& prefix, const std::string& data, const std::string& suffix)
+{
+    auto chunk = DeflateChunk(data);
+    BOOST_CHECK(IsDeflateChunkOf(chunk, data));
+
+    for (auto encoding : {HTTPEncoding::Gzip, HTTPEncoding::Deflate})
+    {
+        std::string out;
+        BOOST_CHECK(Inflate(encoding, EncodeHTTPBody(encoding, prefix, chunk, suffix), out));
+        BOOST_CHECK(out == prefix + data + suffix);
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_httpcompression_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(httpcompression_roundtrip)
+{
+    for (auto encoding : {HTTPEncoding::Gzip, HTTPEncoding::Deflate})
+    {
+        for (const std::string& data : {std::string(), std::string("{\"result\":null}"), Pattern(200000)})
+        {
+            std::string out;
+            BOOST_CHECK(Inflate(encoding, EncodeHTTPBody(encoding, data), out));
+            BOOST_CHECK(out == data);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(httpcompression_stored_blocks)
+{
+    // Empty parts
+    CheckRoundTrip("", "", "");
+    CheckRoundTrip("{\"result\":", "", "");
+    CheckRoundTrip("", "", ",\"id\":1}");
+    CheckRoundTrip("", "[1,2,3]", "");
+
+    // Parts around stored block limit are split into several blocks
+    CheckRoundTrip(Pattern(65535), "[1,2,3]", Pattern(65535));
+    CheckRoundTrip(Pattern(65536), "[1,2,3]", Pattern(65536));
+    CheckRoundTrip(Pattern(200000), Pattern(100000), Pattern(131071));
+    CheckRoundTrip(Pattern(140000), "", "");
+    CheckRoundTrip("", "", Pattern(140000));
+}
+
+BOOST_AUTO_TEST_CASE(httpcompression_chunk)
+{
+    auto data = Pattern(1000);
+    auto chunk = DeflateChunk(data);
+    BOOST_CHECK_EQUAL(chunk.size, data.size());
+    BOOST_CHECK_EQUAL(chunk.crc32, crc32(0L, (const Bytef*) data.data(), (uInt) data.size()));
+    BOOST_CHECK_EQUAL(chunk.adler32, adler32(1L, (const Bytef*) data.data(), (uInt) data.size()));
+
+    BOOST_CHECK(!IsDeflateChunkOf(chunk, Pattern(999)));
+    auto changed = data;
+    changed[500] ^= 1;
+    BOOST_CHECK(!IsDeflateChunkOf(chunk, changed));
+
+    // Default chunk is empty data
+    HTTPDeflateChunk empty;
+    BOOST_CHECK(IsDeflateChunkOf(empty, ""));
+    BOOST_CHECK(IsDeflateChunkOf(DeflateChunk(""), ""));
+
+    // Corrupted trailer is rejected by zlib
+    for (auto encoding : {HTTPEncoding::Gzip, HTTPEncoding::Deflate})
+    {
+        auto body = EncodeHTTPBody(encoding, "{", chunk, "}");
+        body[body.size() - (encoding == HTTPEncoding::Gzip ? 8 : 1)] ^= 1;
+        std::string out;
+        BOOST_CHECK(!Inflate(encoding, body, out));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(httpcompression_select)
+{
+    BOOST_CHECK(SelectHTTPEncoding("") == HTTPEncoding::Identity);
+    BOOST_CHECK(SelectHTTPEncoding("identity") == HTTPEncoding::Identity);
+    BOOST_CHECK(SelectHTTPEncoding("br") == HTTPEncoding::Identity);
+    BOOST_CHECK(SelectHTTPEncoding("gzip") == HTTPEncoding::Gzip);
+    BOOST_CHECK(SelectHTTPEncoding("x-gzip") == HTTPEncoding::Gzip);
+    BOOST_CHECK(SelectHTTPEncoding(" GZIP ") == HTTPEncoding::Gzip);
+    BOOST_CHECK(SelectHTTPEncoding("deflate") == HTTPEncoding::Deflate);
+    BOOST_CHECK(SelectHTTPEncoding("*") == HTTPEncoding::Gzip);
+
+    // Equal quality prefers gzip
+    BOOST_CHECK(SelectHTTPEncoding("deflate, gzip") == HTTPEncoding::Gzip);
+    BOOST_CHECK(SelectHTTPEncoding("gzip;q=0.5, deflate;q=0.5") == HTTPEncoding::Gzip);
+
+    // Highest quality wins
+    BOOST_CHECK(SelectHTTPEncoding("deflate;q=1, gzip;q=0.1") == HTTPEncoding::Deflate);
+    BOOST_CHECK(SelectHTTPEncoding("gzip;q=0.8, deflate;q=0.9") == HTTPEncoding::Deflate);
+    BOOST_CHECK(SelectHTTPEncoding("deflate;q=0.5, gzip ; Q=0.501") == HTTPEncoding::Gzip);
+
+    // Zero quality is not acceptable
+    BOOST_CHECK(SelectHTTPEncoding("gzip;q=0") == HTTPEncoding::Identity);
+    BOOST_CHECK(SelectHTTPEncoding("gzip;q=0.000, deflate") == HTTPEncoding::Deflate);
+    BOOST_CHECK(SelectHTTPEncoding("gzip;q=0, deflate;q=0") == HTTPEncoding::Identity);
+    BOOST_CHECK(SelectHTTPEncoding("*;q=0") == HTTPEncoding::Identity);
+
+    // Wildcard covers only codings not listed
+    BOOST_CHECK(SelectHTTPEncoding("gzip;q=0, *") == HTTPEncoding::Deflate);
+    BOOST_CHECK(SelectHTTPEncoding("*;q=0.5, deflate") == HTTPEncoding::Deflate);
+    BOOST_CHECK(SelectHTTPEncoding("*;q=0, gzip;q=0.1") == HTTPEncoding::Gzip);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
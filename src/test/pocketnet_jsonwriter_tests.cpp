@@ -0,0 +1,121 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include "pocketdb/helpers/JsonWriter.h"
+
+#include <boost/test/unit_test.hpp>
+
+using PocketHelpers::JsonWriter;
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_jsonwriter_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(jsonwriter_escape)
+{
+    BOOST_CHECK_EQUAL(JsonWriter().String("").Buffer(), "\"\"");
+    BOOST_CHECK_EQUAL(JsonWriter().String("a\"b\\c").Buffer(), "\"a\\\"b\\\\c\"");
+    BOOST_CHECK_EQUAL(JsonWriter().String("\b\f\n\r\t").Buffer(), "\"\\b\\f\\n\\r\\t\"");
+    BOOST_CHECK_EQUAL(JsonWriter().String(std::string("\x00\x1f\x7f", 3)).Buffer(), "\"\\u0000\\u001f\\u007f\"");
+    // UTF-8 is written as is
+    BOOST_CHECK_EQUAL(JsonWriter().String("\xd0\x9f\xd1\x80\xd0\xb8").Buffer(), "\"\xd0\x9f\xd1\x80\xd0\xb8\"");
+
+    // Every byte is escaped the same way as univalue does
+    std::string all;
+    for (int c = 0; c < 256; c++)
+        all += (char) c;
+
+    BOOST_CHECK_EQUAL(JsonWriter().String(all).Buffer(), UniValue(all).write());
+
+    // Keys are escaped too
+    JsonWriter writer;
+    writer.BeginObject().Key("k\"ey").String("v\n").EndObject();
+    BOOST_CHECK_EQUAL(writer.Buffer(), "{\"k\\\"ey\":\"v\\n\"}");
+}
+
+BOOST_AUTO_TEST_CASE(jsonwriter_separators)
+{
+    JsonWriter writer;
+    writer.BeginObject()
+        .Key("a").Int(-1)
+        .Key("b").Bool(true)
+        .Key("c").Null()
+        .Key("d").BeginArray().Int(1).String("2").BeginObject().EndObject().EndArray()
+        .Key("e").Json("[1, {\"x\": null}]")
+        .Key("f").Json("{broken")
+        .EndObject();
+
+    BOOST_CHECK_EQUAL(writer.Buffer(), "{\"a\":-1,\"b\":true,\"c\":null,\"d\":[1,\"2\",{}],\"e\":[1, {\"x\": null}],\"f\":null}");
+
+    UniValue parsed;
+    BOOST_CHECK(parsed.read(writer.Buffer()));
+    BOOST_CHECK(parsed.isObject());
+
+    JsonWriter members;
+    members.BeginObject().Members("\"a\":1").Key("b").Int(2).Members("").EndObject();
+    BOOST_CHECK_EQUAL(members.Buffer(), "{\"a\":1,\"b\":2}");
+}
+
+BOOST_AUTO_TEST_CASE(jsonwriter_isvalid)
+{
+    BOOST_CHECK(JsonWriter::IsValid("null"));
+    BOOST_CHECK(JsonWriter::IsValid("true"));
+    BOOST_CHECK(JsonWriter::IsValid("false"));
+    BOOST_CHECK(JsonWriter::IsValid("0"));
+    BOOST_CHECK(JsonWriter::IsValid("-12.5e+3"));
+    BOOST_CHECK(JsonWriter::IsValid("\"\""));
+    BOOST_CHECK(JsonWriter::IsValid("\"a\\\"\\\\\\/\\b\\f\\n\\r\\t\\u00e9\""));
+    BOOST_CHECK(JsonWriter::IsValid("[]"));
+    BOOST_CHECK(JsonWriter::IsValid("{}"));
+    BOOST_CHECK(JsonWriter::IsValid(" [ \"tag1\" , \"tag2\" ] "));
+    BOOST_CHECK(JsonWriter::IsValid("{\"a\":[1,{\"b\":null}],\"c\":\"d\"}"));
+
+    BOOST_CHECK(!JsonWriter::IsValid(""));
+    BOOST_CHECK(!JsonWriter::IsValid("   "));
+    BOOST_CHECK(!JsonWriter::IsValid("nul"));
+    BOOST_CHECK(!JsonWriter::IsValid("01"));
+    BOOST_CHECK(!JsonWriter::IsValid("1."));
+    BOOST_CHECK(!JsonWriter::IsValid("-"));
+    BOOST_CHECK(!JsonWriter::IsValid("\"abc"));
+    BOOST_CHECK(!JsonWriter::IsValid("\"a\\x\""));
+    BOOST_CHECK(!JsonWriter::IsValid("\"\\u00g0\""));
+    BOOST_CHECK(!JsonWriter::IsValid(std::string("\"a\nb\"")));
+    BOOST_CHECK(!JsonWriter::IsValid("[1,]"));
+    BOOST_CHECK(!JsonWriter::IsValid("[1 2]"));
+    BOOST_CHECK(!JsonWriter::IsValid("{\"a\"}"));
+    BOOST_CHECK(!JsonWriter::IsValid("{\"a\":1,}"));
+    BOOST_CHECK(!JsonWriter::IsValid("{a:1}"));
+    BOOST_CHECK(!JsonWriter::IsValid("[]]"));
+    BOOST_CHECK(!JsonWriter::IsValid("{} {}"));
+    BOOST_CHECK(!JsonWriter::IsValid("[1}"));
+}
+
+BOOST_AUTO_TEST_CASE(jsonwriter_raw_univalue)
+{
+    JsonWriter writer;
+    writer.BeginObject().Key("a").BeginArray().Int(1).EndArray().EndObject();
+
+    UniValue raw = writer.ToUniValue();
+    BOOST_CHECK(raw.isObject());
+    BOOST_CHECK(JsonWriter::GetWritten(raw) && *JsonWriter::GetWritten(raw) == writer.Buffer());
+
+    // Written JSON is spliced into reply without parsing
+    UniValue reply(UniValue::VARR);
+    reply.push_back(raw);
+    reply.push_back(NullUniValue);
+    BOOST_CHECK_EQUAL(JsonWriter::Write(reply), "[{\"a\":[1]},null]");
+
+    // Ordinary objects are not spliced, even with the same shape
+    UniValue plain(UniValue::VOBJ);
+    plain.pushKV("json", "{\"a\":[1]}");
+    BOOST_CHECK(!JsonWriter::GetWritten(plain));
+    BOOST_CHECK_EQUAL(JsonWriter::Write(plain), plain.write());
+
+    // Trees without written values are the same as written by univalue
+    UniValue tree;
+    BOOST_CHECK(tree.read("{\"s\":\"x\\n\\u0001\",\"n\":-1.5e3,\"b\":[true,false,null,{}],\"e\":[]}"));
+    BOOST_CHECK_EQUAL(JsonWriter::Write(tree), tree.write());
+    BOOST_CHECK_EQUAL(JsonWriter::Write(UniValue(7)), "7");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include "pocketdb/services/SearchIndex.h"
+
+#include <boost/test/unit_test.hpp>
+
+using PocketServices::SearchIndex;
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_searchindex_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(searchindex_tags)
+{
+    SearchIndex index;
+    BOOST_CHECK(!index.IsTagsReady());
+
+    // Tags are not added before load
+    index.AddTags({{"lost", "en"}});
+    index.LoadTags({{"bitcoin", "en"}, {"bitcoin", "ru"}, {"coin", "en"}, {"pocketnet", "en"}, {"50%_off", "en"}});
+    BOOST_CHECK(index.IsTagsReady());
+
+    using Tags = std::vector<std::string>;
+    BOOST_CHECK(index.SearchTags("lost", 0, 10) == Tags());
+
+    // Substring match in (Value, Lang) order with duplicated values of languages
+    BOOST_CHECK(index.SearchTags("coin", 0, 10) == Tags({"bitcoin", "bitcoin", "coin"}));
+    BOOST_CHECK(index.SearchTags("tco", 0, 10) == Tags({"bitcoin", "bitcoin"}));
+    BOOST_CHECK(index.SearchTags("COIN", 0, 10) == Tags({"bitcoin", "bitcoin", "coin"}));
+    BOOST_CHECK(index.SearchTags("coins", 0, 10) == Tags());
+    BOOST_CHECK(index.SearchTags("xyz", 0, 10) == Tags());
+
+    // Wildcards of sql LIKE are plain characters
+    BOOST_CHECK(index.SearchTags("%_", 0, 10) == Tags({"50%_off"}));
+    BOOST_CHECK(index.SearchTags("0%_o", 0, 10) == Tags({"50%_off"}));
+    BOOST_CHECK(index.SearchTags("_", 0, 10) == Tags({"50%_off"}));
+
+    // Short keywords and empty keyword
+    BOOST_CHECK(index.SearchTags("n", 0, 10) == Tags({"bitcoin", "bitcoin", "coin", "pocketnet"}));
+    BOOST_CHECK(index.SearchTags("", 0, 2) == Tags({"50%_off", "bitcoin"}));
+
+    // Paging
+    BOOST_CHECK(index.SearchTags("coin", 1, 10) == Tags({"bitcoin", "coin"}));
+    BOOST_CHECK(index.SearchTags("coin", 2, 1) == Tags({"coin"}));
+    BOOST_CHECK(index.SearchTags("coin", 3, 10) == Tags());
+    BOOST_CHECK(index.SearchTags("n", 1, 2) == Tags({"bitcoin", "coin"}));
+    BOOST_CHECK(index.SearchTags("coin", 0, 0) == Tags());
+
+    // Added tags are found, existing ones are not duplicated
+    index.AddTags({{"altcoin", "en"}, {"coin", "en"}});
+    BOOST_CHECK(index.SearchTags("coin", 0, 10) == Tags({"altcoin", "bitcoin", "bitcoin", "coin"}));
+
+    index.ClearTags();
+    BOOST_CHECK(!index.IsTagsReady());
+    BOOST_CHECK(index.SearchTags("coin", 0, 10) == Tags());
+}
+
+BOOST_AUTO_TEST_CASE(searchindex_tokenize)
+{
+    using Words = std::vector<std::string>;
+    BOOST_CHECK(SearchIndex::Tokenize("") == Words());
+    BOOST_CHECK(SearchIndex::Tokenize("John_Smith-42 x") == Words({"john", "smith", "42", "x"}));
+    BOOST_CHECK(SearchIndex::Tokenize("  .Bob.  ") == Words({"bob"}));
+    // Cyrillic and latin-1 capitals are folded
+    BOOST_CHECK(SearchIndex::Tokenize("\xd0\x9f\xd1\x80\xd0\xb8\xd0\x81\xd0\xbc") == Words({"\xd0\xbf\xd1\x80\xd0\xb8\xd1\x91\xd0\xbc"}));
+    BOOST_CHECK(SearchIndex::Tokenize("\xc3\x89mile") == Words({"\xc3\xa9mile"}));
+    // Malformed sequences are kept
+    BOOST_CHECK(SearchIndex::Tokenize("a\xd0") == Words({"a\xd0"}));
+
+    BOOST_CHECK_EQUAL(SearchIndex::FoldCase("AbC\xd0\x9f"), "abc\xd0\x9f");
+}
+
+BOOST_AUTO_TEST_CASE(searchindex_users)
+{
+    SearchIndex index;
+    BOOST_CHECK(!index.IsUsersReady());
+
+    // Accounts are not changed before load
+    index.SetUser(9, "lost", 100);
+    index.LoadUsers({
+        {1, "alice", 10},
+        {2, "Alice Cooper", 50},
+        {3, "alicia", 50},
+        {4, "bob alice", 0},
+        {5, "", 1000},
+    });
+    BOOST_CHECK(index.IsUsersReady());
+
+    using Ids = std::vector<int64_t>;
+    BOOST_CHECK(index.SearchUsers("lost", 0, 10) == Ids());
+
+    // Prefix of any name word, ranked by reputation then by shorter name
+    BOOST_CHECK(index.SearchUsers("ali", 0, 10) == Ids({3, 2, 1, 4}));
+    BOOST_CHECK(index.SearchUsers("ALICE", 0, 10) == Ids({2, 1, 4}));
+    BOOST_CHECK(index.SearchUsers("coo", 0, 10) == Ids({2}));
+    BOOST_CHECK(index.SearchUsers("lice", 0, 10) == Ids());
+    BOOST_CHECK(index.SearchUsers("  ", 0, 10) == Ids());
+
+    // Leading words match whole words
+    BOOST_CHECK(index.SearchUsers("alice co", 0, 10) == Ids({2}));
+    BOOST_CHECK(index.SearchUsers("bob ali", 0, 10) == Ids({4}));
+    BOOST_CHECK(index.SearchUsers("bo ali", 0, 10) == Ids());
+
+    // Paging
+    BOOST_CHECK(index.SearchUsers("ali", 1, 2) == Ids({2, 1}));
+    BOOST_CHECK(index.SearchUsers("ali", 4, 2) == Ids());
+
+    // Reputation change reorders results
+    index.SetReputation(1, 100);
+    index.SetReputation(99, 100);
+    BOOST_CHECK(index.SearchUsers("ali", 0, 10) == Ids({1, 3, 2, 4}));
+
+    // Renamed account is found only by new name, deleted account is removed
+    index.SetUser(3, "Carol", 50);
+    index.SetUser(4, "", 0);
+    BOOST_CHECK(index.SearchUsers("ali", 0, 10) == Ids({1, 2}));
+    BOOST_CHECK(index.SearchUsers("car", 0, 10) == Ids({3}));
+
+    // Account with several matched words is returned once
+    index.SetUser(6, "ann annabelle", 0);
+    BOOST_CHECK(index.SearchUsers("ann", 0, 10) == Ids({6}));
+
+    // Reload replaces all accounts
+    index.LoadUsers({{7, "dave", 0}});
+    BOOST_CHECK(index.SearchUsers("ali", 0, 10) == Ids());
+    BOOST_CHECK(index.SearchUsers("d", 0, 10) == Ids({7}));
+
+    index.ClearUsers();
+    BOOST_CHECK(!index.IsUsersReady());
+    BOOST_CHECK(index.SearchUsers("d", 0, 10) == Ids());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -449,6 +449,10 @@ void CTxMemPool::addUnchecked(const CTxMemPoolEntry& entry, setEntries& setAnces
 
     vTxHashes.emplace_back(tx.GetWitnessHash(), newit);
     newit->vTxHashesIdx = vTxHashes.size() - 1;
+
+    // Keep payload in memory for mempool consensus checks, miner and relay
+    if (entry.GetPocketTx())
+        PocketDb::MempoolPayloadsInst.Add(entry.GetPocketTx());
 }
 
 void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
@@ -473,6 +477,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     }
 
     RemoveUnbroadcastTx(hash, true /* add logging because unchecked */ );
+    PocketDb::MempoolPayloadsInst.Remove(hash.GetHex());
 
     if (vTxHashes.size() > 1)
     {
@@ -671,6 +676,7 @@ void CTxMemPool::_clear()
 {
     mapTx.clear();
     mapNextTx.clear();
+    PocketDb::MempoolPayloadsInst.Clear();
     totalTxSize = 0;
     cachedInnerUsage = 0;
     lastRollingFeeUpdate = GetTime();
@@ -76,6 +76,11 @@ struct CompareIteratorByHash {
  *
  */
 
+namespace PocketTx
+{
+    class Transaction;
+}
+
 class CTxMemPoolEntry
 {
 public:
@@ -97,6 +102,7 @@ private:
     const int64_t sigOpCost;        //!< Total sigop cost
     int64_t feeDelta;          //!< Used for determining the priority of the transaction for mining in a block
     LockPoints lockPoints;     //!< Track the height and time at which tx was final
+    std::shared_ptr<PocketTx::Transaction> pocketTx; //!< Pocketnet payload, nullptr for transactions without payload
 
     // Information about descendants of this transaction that are in the
     // mempool; if we remove this transaction we must remove all of these
@@ -128,6 +134,8 @@ public:
     int64_t GetModifiedFee() const { return nFee + feeDelta; }
     size_t DynamicMemoryUsage() const { return nUsageSize; }
     const LockPoints& GetLockPoints() const { return lockPoints; }
+    const std::shared_ptr<PocketTx::Transaction>& GetPocketTx() const { return pocketTx; }
+    void SetPocketTx(const std::shared_ptr<PocketTx::Transaction>& _pocketTx) { pocketTx = _pocketTx; }
 
     // Adjusts the descendant state.
     void UpdateDescendantState(int64_t modifySize, CAmount modifyFee, int64_t modifyCount);
@@ -1094,6 +1094,7 @@ bool MemPoolAccept::Finalize(ATMPArgs& args, Workspace& ws)
     }
 
     // Store transaction in memory
+    entry->SetPocketTx(_pocketTx);
     m_pool.addUnchecked(*entry, setAncestors, validForFeeEstimation);
 
     // trim mempool and check if tx was trimmed
@@ -2520,7 +2521,7 @@ bool CChainState::ConnectBlock(const CBlock& block, const PocketBlockRef& pocket
     // Extend WEB database
     if (!gArgs.GetBoolArg("-withoutweb", false) && enablePocketConnect)
     {
-        PocketServices::WebPostProcessorInst.Enqueue(block.GetHash().GetHex());
+        PocketServices::WebPostProcessorInst.Enqueue(block.GetHash().GetHex(), pindex->nHeight);
 
         if (pindex->nHeight % 100 == 0 && !IsInitialBlockDownload())
             PocketServices::WebPostProcessorInst.Enqueue(pindex->nHeight);
@@ -25,7 +25,7 @@
 #include <txdb.h>
 #include <versionbits.h>
 #include <serialize.h>
-#include <protectedmap.h>
+#include <websocket/wsconnections.h>
 
 #include <atomic>
 #include <map>
@@ -44,7 +44,7 @@
 using namespace PocketHelpers;
 
 extern std::shared_ptr<Queue<std::pair<CBlock, CBlockIndex*>>> notifyClientsQueue;
-extern std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections;
+extern std::shared_ptr<WSConnectionsRegistry> WSConnections;
 
 class CChainState;
 class BlockValidationState;
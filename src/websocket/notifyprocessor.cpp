@@ -3,9 +3,10 @@
 #include "validation.h"
 #include "primitives/block.h"
 #include "pocketdb/pocketnet.h"
+#include "init.h"
 
 
-NotifyBlockProcessor::NotifyBlockProcessor(std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections) 
+NotifyBlockProcessor::NotifyBlockProcessor(std::shared_ptr<WSConnectionsRegistry> WSConnections) 
 {
     m_WSConnections = std::move(WSConnections);
 
@@ -25,7 +26,7 @@ NotifyBlockProcessor::~NotifyBlockProcessor()
     sqliteDbInst = nullptr;
 }
 
-void NotifyBlockProcessor::PrepareWSMessage(std::map<std::string, std::vector<UniValue>>& messages, std::string msg_type, std::string addrTo, std::string txid, int64_t txtime, custom_fields cFields)
+void NotifyBlockProcessor::PrepareWSMessage(std::map<std::string, std::vector<std::string>>& messages, std::string msg_type, std::string addrTo, std::string txid, int64_t txtime, custom_fields cFields)
 {
     UniValue msg(UniValue::VOBJ);
     msg.pushKV("addr", addrTo);
@@ -37,12 +38,15 @@ void NotifyBlockProcessor::PrepareWSMessage(std::map<std::string, std::vector<Un
         msg.pushKV(it.first, it.second);
     }
 
-    if (messages.find(addrTo) == messages.end()) {
-        std::vector<UniValue> _list;
-        messages.insert(std::make_pair(addrTo, _list));
-    }
+    // Serialize once - message can be delivered to several connections of one address
+    messages[addrTo].push_back(msg.write());
+}
 
-    messages[addrTo].push_back(msg);
+WSOutMessageRef NotifyBlockProcessor::MakeOutMessage(const std::string& msg)
+{
+    auto outMessage = std::make_shared<SimpleWeb::SocketServer<SimpleWeb::WS>::OutMessage>();
+    outMessage->write(msg.data(), static_cast<std::streamsize>(msg.size()));
+    return outMessage;
 }
 
 void NotifyBlockProcessor::Process(std::pair<CBlock, CBlockIndex*> entry)
@@ -51,9 +55,12 @@ void NotifyBlockProcessor::Process(std::pair<CBlock, CBlockIndex*> entry)
         return;
     }
 
+    int64_t nTimeStart = GetTimeMicros();
+    auto timeStart = gStatEngineInstance.GetCurrentSystemTime();
+
     const auto& block = entry.first;
     auto blockIndex = entry.second;
-    std::map<std::string, std::vector<UniValue>> messages;
+    std::map<std::string, std::vector<std::string>> messages;
     uint256 _block_hash = block.GetHash();
     // vtx[1] - always staking transaction
     string _block_stake_txHash = (block.IsProofOfStake() && block.vtx.size() > 1) ? block.vtx[1]->GetHash().GetHex() : "";
@@ -401,80 +408,135 @@ void NotifyBlockProcessor::Process(std::pair<CBlock, CBlockIndex*> entry)
         contentsLang.pushKV(TransactionHelper::TxStringType(PocketHelpers::TransactionHelper::ConvertOpReturnToType(itemContent.first)), langContents);
     }
 
-    auto send = [&](std::pair<const std::string, WSUser>& connWS) {
-        UniValue msg(UniValue::VOBJ);
-        msg.pushKV("addr", connWS.second.Address);
-        msg.pushKV("stakeTxHash", _block_stake_txHash);
-        msg.pushKV("msg", "new block");
-        msg.pushKV("blockhash", _block_hash.GetHex());
-        msg.pushKV("time", std::to_string(block.nTime));
-        msg.pushKV("height", blockIndex->nHeight);
-        msg.pushKV("shares", sharesCnt);
-        msg.pushKV("contentsLang", contentsLang);
-
-        auto countResponse = notifierRepoInst->GetPostCountFromMySubscribes(connWS.second.Address, blockIndex->nHeight);
-        if (countResponse.exists("cntTotal"))
-        {
-            msg.pushKV("sharesSubscr", countResponse["cntTotal"].get_int());
+    // Part of "new block" message common for all connections is serialized once
+    // and only the address and subscribes counters are spliced in for every connection
+    UniValue blockMsg(UniValue::VOBJ);
+    blockMsg.pushKV("stakeTxHash", _block_stake_txHash);
+    blockMsg.pushKV("msg", "new block");
+    blockMsg.pushKV("blockhash", _block_hash.GetHex());
+    blockMsg.pushKV("time", std::to_string(block.nTime));
+    blockMsg.pushKV("height", blockIndex->nHeight);
+    blockMsg.pushKV("shares", sharesCnt);
+    blockMsg.pushKV("contentsLang", contentsLang);
+    std::string blockMsgBody = blockMsg.write();
+    blockMsgBody = blockMsgBody.substr(1, blockMsgBody.size() - 2);
+
+    // Counters of new contents from subscriptions for all addresses by one query
+    std::map<std::string, UniValue> subscribesCounts;
+    try
+    {
+        subscribesCounts = notifierRepoInst->GetPostCountFromMySubscribes(blockIndex->nHeight);
+    }
+    catch (const std::exception& e)
+    {
+        LogPrintf("Error: NotifyBlockProcessor::Process - %s\n", e.what());
+    }
 
-            UniValue contentsSubscribes(UniValue::VOBJ);
-            contentsSubscribes.pushKV("share", (countResponse.exists("cntPost") ? countResponse["cntPost"].get_int() : 0));
-            contentsSubscribes.pushKV("video", (countResponse.exists("cntVideo") ? countResponse["cntVideo"].get_int() : 0));
-            contentsSubscribes.pushKV("article", (countResponse.exists("cntArticle") ? countResponse["cntArticle"].get_int() : 0));
-            contentsSubscribes.pushKV("stream", (countResponse.exists("cntStream") ? countResponse["cntStream"].get_int() : 0));
-            contentsSubscribes.pushKV("audio", (countResponse.exists("cntAudio") ? countResponse["cntAudio"].get_int() : 0));
+    // "new block" message depends only on address, so it is built once per address
+    // and the same immutable buffer is shared by all connections of that address
+    std::map<std::string, WSOutMessageRef> blockMessages;
+    auto getBlockMessage = [&](const std::string& address) -> const WSOutMessageRef& {
+        auto it = blockMessages.find(address);
+        if (it != blockMessages.end())
+            return it->second;
+
+        UniValue countResponse(UniValue::VOBJ);
+        if (auto countIt = subscribesCounts.find(address); countIt != subscribesCounts.end())
+            countResponse = countIt->second;
+
+        UniValue contentsSubscribes(UniValue::VOBJ);
+        contentsSubscribes.pushKV("share", (countResponse.exists("cntPost") ? countResponse["cntPost"].get_int() : 0));
+        contentsSubscribes.pushKV("video", (countResponse.exists("cntVideo") ? countResponse["cntVideo"].get_int() : 0));
+        contentsSubscribes.pushKV("article", (countResponse.exists("cntArticle") ? countResponse["cntArticle"].get_int() : 0));
+        contentsSubscribes.pushKV("stream", (countResponse.exists("cntStream") ? countResponse["cntStream"].get_int() : 0));
+        contentsSubscribes.pushKV("audio", (countResponse.exists("cntAudio") ? countResponse["cntAudio"].get_int() : 0));
+
+        UniValue part(UniValue::VOBJ);
+        part.pushKV("sharesSubscr", (countResponse.exists("cntTotal") ? countResponse["cntTotal"].get_int() : 0));
+        part.pushKV("contentsSubscribes", contentsSubscribes);
+        auto partStr = part.write();
+
+        return blockMessages.emplace(address, MakeOutMessage(
+            "{\"addr\":" + UniValue(address).write() + "," + blockMsgBody + "," + partStr.substr(1, partStr.size() - 2) + "}")).first->second;
+    };
 
-            msg.pushKV("contentsSubscribes", contentsSubscribes);
+    // Messages are passed as OutMessage buffers: the websocket server does not consume them
+    // while sending, so one serialized payload is written to every connection without copies
+    size_t sentBytes = 0;
+    auto send = [&](const WSUser& user, const WSOutMessageRef& msg, int errorCode) {
+        try
+        {
+            user.Connection->send(msg, [](const SimpleWeb::error_code& ec) {});
+            sentBytes += msg->size();
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Error: CChainState::NotifyWSClients (%d) - %s\n", errorCode, e.what());
         }
+    };
 
-        if (blockIndex->nHeight > connWS.second.Block)
+    // Connections are copied so the registry lock is not held while messages are built and queued,
+    // socket writes themselves are performed asynchronously by websocket io threads
+    std::vector<std::string> notified;
+    for (const auto& [id, user] : m_WSConnections->Snapshot())
+    {
+        if (blockIndex->nHeight <= user.Block)
+            continue;
+
+        send(user, getBlockMessage(user.Address), 1);
+        notified.push_back(id);
+    }
+
+    // TODO: Notification from POCKETNET_TEAM
+    // if (txidpocketnet != "")
+    // {
+    //     UniValue m(UniValue::VOBJ);
+    //     m.pushKV("msg", "sharepocketnet");
+    //     m.pushKV("time", std::to_string(block.nTime));
+    //     m.pushKV("addrFrom", addrespocketnet);
+    //     if (pocketnetaccinfo.exists("name")) m.pushKV("nameFrom", pocketnetaccinfo["name"].get_str());
+    //     if (pocketnetaccinfo.exists("avatar")) m.pushKV("avatarFrom", pocketnetaccinfo["avatar"].get_str());
+    //     m.pushKV("txids", txidpocketnet.substr(0, txidpocketnet.size() - 1));
+    //     ... send to every notified connection
+    // }
+
+    // Events of transactions are delivered only to connections of touched addresses
+    for (const auto& [address, addressMessages] : messages)
+    {
+        auto users = m_WSConnections->GetByAddress(address);
+        if (users.empty())
+            continue;
+
+        std::vector<WSOutMessageRef> outMessages;
+        for (const auto& m : addressMessages)
+            outMessages.push_back(MakeOutMessage(m));
+
+        for (const auto& [id, user] : users)
         {
-            try
-            {
-                connWS.second.Connection->send(msg.write(), [](const SimpleWeb::error_code& ec) {});
-            }
-            catch (const std::exception& e)
-            {
-                LogPrintf("Error: CChainState::NotifyWSClients (1) - %s\n", e.what());
-            }
+            if (blockIndex->nHeight <= user.Block)
+                continue;
 
-            // TODO: Notification from POCKETNET_TEAM
-            // if (txidpocketnet != "")
-            // {
-            //     try
-            //     {
-            //         UniValue m(UniValue::VOBJ);
-            //         m.pushKV("msg", "sharepocketnet");
-            //         m.pushKV("time", std::to_string(block.nTime));
-            //         m.pushKV("addrFrom", addrespocketnet);
-            //         if (pocketnetaccinfo.exists("name")) m.pushKV("nameFrom", pocketnetaccinfo["name"].get_str());
-            //         if (pocketnetaccinfo.exists("avatar")) m.pushKV("avatarFrom", pocketnetaccinfo["avatar"].get_str());
-            //         m.pushKV("txids", txidpocketnet.substr(0, txidpocketnet.size() - 1));
-            //         connWS.second.Connection->send(m.write(), [](const SimpleWeb::error_code& ec) {});
-            //     }
-            //     catch (const std::exception& e)
-            //     {
-            //         LogPrintf("Error: CChainState::NotifyWSClients (1) - %s\n", e.what());
-            //     }
-            // }
-
-            if (messages.find(connWS.second.Address) != messages.end())
-            {
-                for (auto m : messages[connWS.second.Address])
-                {
-                    try
-                    {
-                        connWS.second.Connection->send(m.write(), [](const SimpleWeb::error_code& ec) {});
-                    }
-                    catch (const std::exception& e)
-                    {
-                        LogPrintf("Error: CChainState::NotifyWSClients (2) - %s\n", e.what());
-                    }
-                }
-            }
+            for (const auto& m : outMessages)
+                send(user, m, 2);
+        }
+    }
 
-            connWS.second.Block = blockIndex->nHeight;
+    m_WSConnections->SetBlock(notified, blockIndex->nHeight);
+
+    // Per-block fan-out latency and bytes queued go to the statistic engine with RPC methods
+    gStatEngineInstance.AddSample(
+        Statistic::RequestSample{
+            "ws.notifyblock",
+            timeStart,
+            timeStart,
+            gStatEngineInstance.GetCurrentSystemTime(),
+            "",
+            false,
+            0,
+            sentBytes
         }
-    };
-    m_WSConnections->Iterate(send);
+    );
+
+    LogPrint(BCLog::BENCH, "    - NotifyBlockProcessor: block %d, %d connections, %d addresses with events: %.2fms\n",
+        blockIndex->nHeight, (int) notified.size(), (int) messages.size(), 0.001 * (GetTimeMicros() - nTimeStart));
 }
@@ -2,7 +2,7 @@
 #define POCKETCOIN_NOTIFYPROCESSOR_H
 
 #include "eventloop.h"
-#include "protectedmap.h"
+#include "websocket/wsconnections.h"
 #include "univalue.h"
 #include "websocket/ws.h"
 
@@ -16,17 +16,19 @@ class CBlockIndex;
 class WSUser;
 
 typedef std::map<std::string, std::string> custom_fields;
+typedef std::shared_ptr<SimpleWeb::SocketServer<SimpleWeb::WS>::OutMessage> WSOutMessageRef;
 
 class NotifyBlockProcessor : public IQueueProcessor<std::pair<CBlock, CBlockIndex*>>
 {
 public:
-    explicit NotifyBlockProcessor(std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections);
+    explicit NotifyBlockProcessor(std::shared_ptr<WSConnectionsRegistry> WSConnections);
     ~NotifyBlockProcessor() override;
     void Process(std::pair<CBlock, CBlockIndex*> entry) override;
 
 private:
-    void PrepareWSMessage(std::map<std::string, std::vector<UniValue>>& messages, std::string msg_type, std::string addrTo, std::string txid, int64_t txtime, custom_fields cFields);
-    std::shared_ptr<ProtectedMap<std::string, WSUser>> m_WSConnections;
+    static WSOutMessageRef MakeOutMessage(const std::string& msg);
+    void PrepareWSMessage(std::map<std::string, std::vector<std::string>>& messages, std::string msg_type, std::string addrTo, std::string txid, int64_t txtime, custom_fields cFields);
+    std::shared_ptr<WSConnectionsRegistry> m_WSConnections;
     
     SQLiteDatabaseRef sqliteDbInst;
     NotifierRepositoryRef notifierRepoInst;
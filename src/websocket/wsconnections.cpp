@@ -0,0 +1,91 @@
+#include "websocket/wsconnections.h"
+
+#include <mutex>
+
+void WSConnectionsRegistry::insert_or_assign(const std::string& id, const WSUser& user)
+{
+    std::unique_lock lock(m_mutex);
+
+    // Connection can resubscribe with other address
+    if (auto it = m_connections.find(id); it != m_connections.end() && it->second.Address != user.Address)
+        UnlinkAddress(id, it->second.Address);
+
+    m_connections.insert_or_assign(id, user);
+    m_addresses[user.Address].insert(id);
+}
+
+size_t WSConnectionsRegistry::erase(const std::string& id)
+{
+    std::unique_lock lock(m_mutex);
+
+    auto it = m_connections.find(id);
+    if (it == m_connections.end())
+        return 0;
+
+    UnlinkAddress(id, it->second.Address);
+    m_connections.erase(it);
+    return 1;
+}
+
+bool WSConnectionsRegistry::empty()
+{
+    std::shared_lock lock(m_mutex);
+    return m_connections.empty();
+}
+
+int WSConnectionsRegistry::count()
+{
+    std::shared_lock lock(m_mutex);
+    return (int) m_connections.size();
+}
+
+void WSConnectionsRegistry::Iterate(const std::function<void(const std::pair<const std::string, WSUser>&)>& func)
+{
+    std::shared_lock lock(m_mutex);
+    for (const auto& elem : m_connections)
+        func(elem);
+}
+
+std::vector<std::pair<std::string, WSUser>> WSConnectionsRegistry::Snapshot()
+{
+    std::shared_lock lock(m_mutex);
+    return std::vector<std::pair<std::string, WSUser>>(m_connections.begin(), m_connections.end());
+}
+
+std::vector<std::pair<std::string, WSUser>> WSConnectionsRegistry::GetByAddress(const std::string& address)
+{
+    std::vector<std::pair<std::string, WSUser>> result;
+
+    std::shared_lock lock(m_mutex);
+
+    auto it = m_addresses.find(address);
+    if (it == m_addresses.end())
+        return result;
+
+    result.reserve(it->second.size());
+    for (const auto& id : it->second)
+        if (auto conn = m_connections.find(id); conn != m_connections.end())
+            result.emplace_back(*conn);
+
+    return result;
+}
+
+void WSConnectionsRegistry::SetBlock(const std::vector<std::string>& ids, int height)
+{
+    std::unique_lock lock(m_mutex);
+
+    for (const auto& id : ids)
+        if (auto it = m_connections.find(id); it != m_connections.end() && it->second.Block < height)
+            it->second.Block = height;
+}
+
+void WSConnectionsRegistry::UnlinkAddress(const std::string& id, const std::string& address)
+{
+    auto it = m_addresses.find(address);
+    if (it == m_addresses.end())
+        return;
+
+    it->second.erase(id);
+    if (it->second.empty())
+        m_addresses.erase(it);
+}
@@ -0,0 +1,43 @@
+#ifndef POCKETCOIN_WSCONNECTIONS_H
+#define POCKETCOIN_WSCONNECTIONS_H
+
+#include "websocket/ws.h"
+
+#include <functional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Registry of websocket subscribers indexed by connection ID and by address,
+// so that events for an address are delivered without walking all connections.
+class WSConnectionsRegistry
+{
+public:
+    void insert_or_assign(const std::string& id, const WSUser& user);
+    size_t erase(const std::string& id);
+    bool empty();
+    int count();
+
+    void Iterate(const std::function<void(const std::pair<const std::string, WSUser>&)>& func);
+
+    // Copy of all connections so that delivery does not hold the lock
+    std::vector<std::pair<std::string, WSUser>> Snapshot();
+
+    // Connections subscribed to address
+    std::vector<std::pair<std::string, WSUser>> GetByAddress(const std::string& address);
+
+    // Mark connections as notified up to block height
+    void SetBlock(const std::vector<std::string>& ids, int height);
+
+private:
+    std::unordered_map<std::string, WSUser> m_connections;
+    std::unordered_map<std::string, std::set<std::string>> m_addresses;
+    std::shared_mutex m_mutex;
+
+    void UnlinkAddress(const std::string& id, const std::string& address);
+};
+
+#endif // POCKETCOIN_WSCONNECTIONS_H